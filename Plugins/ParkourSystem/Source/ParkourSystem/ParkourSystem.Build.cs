@@ -36,6 +36,8 @@ public class ParkourSystem : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"Chaos",
+				"PhysicsCore",
                 "GameplayTags",
                 "MotionWarping",
                 "Slate",
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Actors/ParkourLedgeCell.h"
+#include "Actors/ParkourLedgeVolume.h"
+#include "Subsystems/ParkourLedgeSubsystem.h"
+
+AParkourLedgeCell::AParkourLedgeCell()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	SetActorEnableCollision(false);
+	SetCanBeDamaged(false);
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+#if WITH_EDITORONLY_DATA
+	bIsSpatiallyLoaded = true;
+#endif
+}
+
+void AParkourLedgeCell::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UParkourLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UParkourLedgeSubsystem>())
+	{
+		LedgeSubsystem->RegisterLedgeChunk(Chunk);
+	}
+}
+
+void AParkourLedgeCell::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UParkourLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UParkourLedgeSubsystem>())
+	{
+		LedgeSubsystem->UnregisterLedgeChunk(Chunk);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+#if WITH_EDITOR
+void AParkourLedgeCell::SetLedges(AParkourLedgeVolume* Volume, const FBox& Region, TConstArrayView<FParkourLedge> Ledges)
+{
+	Modify();
+	SourceVolume = Volume;
+	Chunk.Pack(Region, Ledges);
+}
+
+bool AParkourLedgeCell::WasBakedBy(const AParkourLedgeVolume* Volume) const
+{
+	return SourceVolume.Get() == Volume;
+}
+#endif
@@ -0,0 +1,245 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Actors/ParkourLedgeVolume.h"
+#include "Actors/ParkourLedgeCell.h"
+#include "DataAssets/ParkourLedgeDataAsset.h"
+#include "Subsystems/ParkourLedgeSubsystem.h"
+#include "ParkourSystem.h"
+#include "EngineUtils.h"
+
+#if WITH_EDITOR
+#include "WorldPartition/LoaderAdapter/LoaderAdapterShape.h"
+#endif
+
+// A single chunk this coarse puts warp targets visibly off the edge, the volume should bake streaming cells instead.
+static constexpr float ParkourLedgeVolumeMaxPackingError = 0.5f;
+
+AParkourLedgeVolume::AParkourLedgeVolume()
+{
+	SetActorEnableCollision(false);
+
+#if WITH_EDITORONLY_DATA
+	// Always loaded, a bake has to find the volume before it loads the regions the volume covers.
+	bIsSpatiallyLoaded = false;
+#endif
+}
+
+void AParkourLedgeVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (LedgeData)
+	{
+		if (UParkourLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UParkourLedgeSubsystem>())
+		{
+			LedgeSubsystem->RegisterLedgeData(LedgeData);
+		}
+	}
+}
+
+void AParkourLedgeVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (LedgeData)
+	{
+		if (UParkourLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UParkourLedgeSubsystem>())
+		{
+			LedgeSubsystem->UnregisterLedgeData(LedgeData);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+#if WITH_EDITOR
+/** World Partition only keeps the loaded regions in the editor, so the bake loads everything its probes can reach from Region. */
+static TUniquePtr<FLoaderAdapterShape> LoadBakeRegion(UWorld* World, const FBox& Region, const FParkourLedgeBakeSettings& Settings)
+{
+	if (World->IsPartitionedWorld() == false)
+	{
+		return nullptr;
+	}
+
+	TUniquePtr<FLoaderAdapterShape> Loader = MakeUnique<FLoaderAdapterShape>(World, Region.ExpandBy(Settings.GetProbeReach()), TEXT("ParkourLedgeBake"));
+	Loader->Load();
+	return Loader;
+}
+
+void AParkourLedgeVolume::BakeLedges()
+{
+	FParkourLedgeBakeStats Stats;
+	BakeLedges(Stats);
+}
+
+void AParkourLedgeVolume::BakeLedges(FParkourLedgeBakeStats& OutStats)
+{
+	const FBox Region = GetComponentsBoundingBox(true);
+	if (bBakeStreamingCells)
+	{
+		BakeStreamingCells(Region, OutStats);
+		return;
+	}
+
+	if (LedgeData == nullptr)
+	{
+		UE_LOG(LogParkour, Warning, TEXT("%s has no ledge data asset to bake into."), *GetName());
+		return;
+	}
+
+	TUniquePtr<FLoaderAdapterShape> Loader = LoadBakeRegion(GetWorld(), Region, BakeSettings);
+	TArray<FParkourLedge> Ledges;
+	FParkourLedgeBaker(GetWorld(), BakeSettings).BakeRegion(Region, Ledges, &OutStats);
+	if (Loader)
+	{
+		Loader->Unload();
+	}
+
+	LedgeData->Modify();
+	LedgeData->Chunk.Pack(Region, Ledges);
+	LedgeData->MarkPackageDirty();
+
+	UE_LOG(LogParkour, Log, TEXT("%s baked %d ledges into %s."), *GetName(), LedgeData->Chunk.Num(), *LedgeData->GetName());
+	if (LedgeData->Chunk.GetPackingError() > ParkourLedgeVolumeMaxPackingError)
+	{
+		UE_LOG(LogParkour, Warning, TEXT("%s is too big for one ledge chunk, its ledges are off by up to %.1f cm. Enable bBakeStreamingCells to bake it in smaller cells."), *GetName(), LedgeData->Chunk.GetPackingError());
+	}
+}
+
+void AParkourLedgeVolume::BakeStreamingCells(const FBox& Region, FParkourLedgeBakeStats& OutStats)
+{
+	UWorld* World = GetWorld();
+	for (TActorIterator<AParkourLedgeCell> It(World); It; ++It)
+	{
+		if (It->WasBakedBy(this))
+		{
+			World->EditorDestroyActor(*It, true);
+		}
+	}
+
+	// Cells line up with the origin like the World Partition grid does, so each one lands in the grid cell it covers.
+	const FIntVector MinCell(FMath::FloorToInt(Region.Min.X / StreamingCellSize), FMath::FloorToInt(Region.Min.Y / StreamingCellSize), 0);
+	const FIntVector MaxCell(FMath::FloorToInt(Region.Max.X / StreamingCellSize), FMath::FloorToInt(Region.Max.Y / StreamingCellSize), 0);
+
+	int NumCells = 0;
+	int NumLedges = 0;
+	for (int X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			const FBox GridCell(FVector(X * StreamingCellSize, Y * StreamingCellSize, Region.Min.Z), FVector((X + 1) * StreamingCellSize, (Y + 1) * StreamingCellSize, Region.Max.Z));
+			const FBox CellRegion = GridCell.Overlap(Region);
+			if (CellRegion.IsValid == false)
+			{
+				continue;
+			}
+
+			// One cell at a time, so a World Partition map never has more than a cell and its surroundings loaded.
+			TUniquePtr<FLoaderAdapterShape> Loader = LoadBakeRegion(World, CellRegion, BakeSettings);
+			for (TActorIterator<AParkourLedgeCell> It(World); It; ++It)
+			{
+				if (It->WasBakedBy(this) && GridCell.IsInsideOrOn(It->GetActorLocation()))
+				{
+					World->EditorDestroyActor(*It, true);
+				}
+			}
+
+			// The baker collects the pawns to ignore when it is made, a cell can load new ones.
+			TArray<FParkourLedge> Ledges;
+			FParkourLedgeBaker(World, BakeSettings).BakeRegion(CellRegion, Ledges, &OutStats);
+			if (Loader)
+			{
+				Loader->Unload();
+			}
+
+			// Cells without ledges are kept too, they tell the parkour component there is nothing to trace for.
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.OverrideLevel = GetLevel();
+			AParkourLedgeCell* Cell = World->SpawnActor<AParkourLedgeCell>(GridCell.GetCenter(), FRotator::ZeroRotator, SpawnParameters);
+			if (Cell == nullptr)
+			{
+				continue;
+			}
+			Cell->SetActorLabel(FString::Printf(TEXT("%s_Cell_%d_%d"), *GetActorLabel(), X, Y));
+			Cell->SetLedges(this, CellRegion, Ledges);
+
+			NumCells++;
+			NumLedges += Ledges.Num();
+		}
+	}
+
+	UE_LOG(LogParkour, Log, TEXT("%s baked %d ledges into %d streaming cells."), *GetName(), NumLedges, NumCells);
+}
+
+bool AParkourLedgeVolume::MarkLedgesStale(const FBox& ChangedBounds)
+{
+	const FBox StaleRegion = ChangedBounds.ExpandBy(BakeSettings.GetProbeReach());
+	bool bMarked = false;
+	ForEachBakedChunk([&](UObject& Owner, FParkourLedgeChunk& Chunk)
+	{
+		// Not part of the edit's transaction, undoing the edit changes the collision again.
+		if (Chunk.Bounds.Intersect(StaleRegion))
+		{
+			Chunk.MarkStale(StaleRegion);
+			Owner.MarkPackageDirty();
+			bMarked = true;
+		}
+	});
+	return bMarked;
+}
+
+void AParkourLedgeVolume::RebakeStaleLedges(FParkourLedgeBakeStats& OutStats)
+{
+	const FParkourLedgeBaker Baker(GetWorld(), BakeSettings);
+	UParkourLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UParkourLedgeSubsystem>();
+	ForEachBakedChunk([&](UObject& Owner, FParkourLedgeChunk& Chunk)
+	{
+		if (Chunk.StaleRegions.Num() == 0)
+		{
+			return;
+		}
+
+		TArray<FParkourLedge> Ledges;
+		Chunk.UnpackAll(Ledges);
+		for (const FBox& StaleRegion : Chunk.StaleRegions)
+		{
+			Baker.RebakeRegion(Chunk.Bounds, StaleRegion, Ledges, &OutStats);
+		}
+		Chunk.Pack(Chunk.Bounds, Ledges);
+		Owner.MarkPackageDirty();
+
+		// The index the subsystem built at registration still points at the old ledges.
+		if (LedgeSubsystem)
+		{
+			LedgeSubsystem->ReindexLedgeChunk(Chunk);
+		}
+	});
+}
+
+void AParkourLedgeVolume::GetStaleRegions(TArray<FBox>& OutRegions) const
+{
+	ForEachBakedChunk([&OutRegions](UObject& Owner, FParkourLedgeChunk& Chunk)
+	{
+		OutRegions.Append(Chunk.StaleRegions);
+	});
+}
+
+void AParkourLedgeVolume::ForEachBakedChunk(TFunctionRef<void(UObject& Owner, FParkourLedgeChunk& Chunk)> Function) const
+{
+	if (bBakeStreamingCells == false)
+	{
+		if (LedgeData)
+		{
+			Function(*LedgeData, LedgeData->Chunk);
+		}
+		return;
+	}
+
+	for (TActorIterator<AParkourLedgeCell> It(GetWorld()); It; ++It)
+	{
+		if (It->WasBakedBy(this))
+		{
+			Function(**It, It->GetMutableChunk());
+		}
+	}
+}
+#endif
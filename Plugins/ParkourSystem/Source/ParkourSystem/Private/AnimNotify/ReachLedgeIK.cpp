@@ -3,6 +3,7 @@
 
 #include "AnimNotify/ReachLedgeIK.h"
 #include "Components/ParkourMovementComponent.h"
+#include "Types/ParkourGameplayTags.h"
 
 void UReachLedgeIK::NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference)
 {
@@ -15,7 +16,7 @@ void UReachLedgeIK::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBas
 	{
 		if (UParkourMovementComponent* ParkourMovementComponent = MeshComp->GetOwner()->GetComponentByClass<UParkourMovementComponent>())
 		{
-			if (WhichHand == FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Left")))
+			if (WhichHand == ParkourTags::Direction_Left)
 			{
 				ParkourMovementComponent->LimbsClimbIK(!bSecondIK, true);
 			}
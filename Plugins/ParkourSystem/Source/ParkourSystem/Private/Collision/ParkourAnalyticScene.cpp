@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Collision/ParkourAnalyticScene.h"
+#include "Collision/ParkourCollisionElement.h"
+
+static constexpr double ParkourSlabHalfExtent = 1.e7;
+
+void FParkourAnalyticScene::AddBox(const FVector& Center, const FVector& HalfSize, const FRotator& Rotation)
+{
+	FParkourAnalyticBox& Box = Boxes.AddDefaulted_GetRef();
+	Box.Center = Center;
+	Box.HalfSize = HalfSize;
+	Box.Rotation = Rotation.Quaternion();
+}
+
+void FParkourAnalyticScene::AddSlab(const float TopZ, const float Thickness)
+{
+	AddBox(FVector(0, 0, TopZ - (Thickness * 0.5f)), FVector(ParkourSlabHalfExtent, ParkourSlabHalfExtent, Thickness * 0.5f));
+}
+
+bool FParkourAnalyticScene::Sweep(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, FHitResult& OutHit) const
+{
+	OutHit = FHitResult(Start, End);
+
+	FHitResult BoxHit;
+	for (int32 BoxIndex = 0; BoxIndex < Boxes.Num(); BoxIndex++)
+	{
+		if (SweepBox(Boxes[BoxIndex], Shape, Start, End, Extent, Rotation, BoxHit))
+		{
+			if (OutHit.bBlockingHit == false || BoxHit.Time < OutHit.Time)
+			{
+				OutHit = BoxHit;
+				OutHit.Item = BoxIndex;
+			}
+		}
+	}
+	return OutHit.bBlockingHit;
+}
+
+bool FParkourAnalyticScene::GetHitElement(const FHitResult& Hit, FParkourCollisionElement& OutElement) const
+{
+	if (Hit.bBlockingHit == false || Boxes.IsValidIndex(Hit.Item) == false)
+	{
+		return false;
+	}
+
+	const FParkourAnalyticBox& Box = Boxes[Hit.Item];
+	OutElement = FParkourCollisionElement::MakeBox(FTransform(Box.Rotation, Box.Center), Box.HalfSize, FTransform::Identity);
+	return true;
+}
+
+bool FParkourAnalyticScene::SweepBox(const FParkourAnalyticBox& Box, const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, FHitResult& OutHit) const
+{
+	// Everything happens in the frame of the box, where it is axis aligned.
+	const FVector LocalStart = Box.Rotation.UnrotateVector(Start - Box.Center);
+	const FVector LocalEnd = Box.Rotation.UnrotateVector(End - Box.Center);
+	const FVector LocalDelta = LocalEnd - LocalStart;
+
+	FVector ShapeExtent = FVector::ZeroVector;
+	switch (Shape)
+	{
+	case EParkourTraceShape::Sphere:
+		ShapeExtent = FVector(Extent.X);
+		break;
+	case EParkourTraceShape::Capsule:
+		ShapeExtent = FVector(Extent.X, Extent.X, Extent.Z);
+		break;
+	case EParkourTraceShape::Box:
+		{
+			const FQuat LocalRotation = Box.Rotation.Inverse() * Rotation;
+			ShapeExtent = LocalRotation.GetAxisX().GetAbs() * Extent.X + LocalRotation.GetAxisY().GetAbs() * Extent.Y + LocalRotation.GetAxisZ().GetAbs() * Extent.Z;
+		}
+		break;
+	default:
+		break;
+	}
+	const FVector GrownHalfSize = Box.HalfSize + ShapeExtent;
+
+	double EnterTime = 0;
+	double ExitTime = 1;
+	int EnterAxis = -1;
+	for (int Axis = 0; Axis < 3; Axis++)
+	{
+		if (FMath::IsNearlyZero(LocalDelta[Axis]))
+		{
+			if (FMath::Abs(LocalStart[Axis]) > GrownHalfSize[Axis])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		double NearTime = (-GrownHalfSize[Axis] - LocalStart[Axis]) / LocalDelta[Axis];
+		double FarTime = (GrownHalfSize[Axis] - LocalStart[Axis]) / LocalDelta[Axis];
+		if (NearTime > FarTime)
+		{
+			Swap(NearTime, FarTime);
+		}
+		if (NearTime > EnterTime)
+		{
+			EnterTime = NearTime;
+			EnterAxis = Axis;
+		}
+		ExitTime = FMath::Min(ExitTime, FarTime);
+		if (EnterTime > ExitTime)
+		{
+			return false;
+		}
+	}
+
+	FVector LocalNormal = FVector::ZeroVector;
+	OutHit = FHitResult(Start, End);
+	OutHit.bBlockingHit = true;
+
+	if (EnterAxis < 0)
+	{
+		// Starts inside, push out along the axis with the least penetration.
+		double LeastPenetration = TNumericLimits<double>::Max();
+		for (int Axis = 0; Axis < 3; Axis++)
+		{
+			const double Penetration = GrownHalfSize[Axis] - FMath::Abs(LocalStart[Axis]);
+			if (Penetration < LeastPenetration)
+			{
+				LeastPenetration = Penetration;
+				EnterAxis = Axis;
+			}
+		}
+		LocalNormal[EnterAxis] = (LocalStart[EnterAxis] < 0) ? -1 : 1;
+		OutHit.bStartPenetrating = true;
+		OutHit.PenetrationDepth = LeastPenetration;
+		OutHit.Time = 0;
+	}
+	else
+	{
+		LocalNormal[EnterAxis] = (LocalDelta[EnterAxis] > 0) ? -1 : 1;
+		OutHit.Time = EnterTime;
+	}
+
+	const FVector Normal = Box.Rotation.RotateVector(LocalNormal);
+	OutHit.Location = Start + (End - Start) * OutHit.Time;
+	OutHit.Distance = (End - Start).Size() * OutHit.Time;
+	OutHit.Normal = Normal;
+	OutHit.ImpactNormal = Normal;
+	OutHit.ImpactPoint = OutHit.Location - Normal * ShapeExtent[EnterAxis];
+	return true;
+}
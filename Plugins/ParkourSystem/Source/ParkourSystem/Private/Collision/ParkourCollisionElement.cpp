@@ -0,0 +1,204 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Collision/ParkourCollisionElement.h"
+#include "Types/ParkourLedgeTypes.h"
+#include "FunctionLibrary/ParkourFunctionLibrary.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Chaos/Convex.h"
+
+// Tops steeper than this are left to the traces, their top probes do not settle on a slope the way a plane does.
+static constexpr double ParkourElementMinTopNormalZ = 0.98;
+
+// Same inset as the top probes of the wall scan.
+static constexpr double ParkourElementTopInset = 2.0;
+
+// The face is measured this far below the top, where the wall scan reports its wall hit.
+static constexpr double ParkourElementFaceDrop = 4.0;
+
+FParkourCollisionElement FParkourCollisionElement::MakeBox(const FTransform& ElementTransform, const FVector& HalfSize, const FTransform& BodyTransform)
+{
+	FParkourCollisionElement Element;
+	for (int Axis = 0; Axis < 3; Axis++)
+	{
+		for (const double Sign : { -1.0, 1.0 })
+		{
+			FVector Normal = FVector::ZeroVector;
+			Normal[Axis] = Sign;
+			Element.AddPlane(Normal * HalfSize[Axis], Normal, ElementTransform, BodyTransform);
+		}
+	}
+	return Element;
+}
+
+FParkourCollisionElement FParkourCollisionElement::MakeCapsule(const FVector& Start, const FVector& End, const float Radius)
+{
+	FParkourCollisionElement Element;
+	Element.SegmentStart = Start;
+	Element.SegmentEnd = End;
+	Element.Radius = Radius;
+	return Element;
+}
+
+void FParkourCollisionElement::GatherElements(const UBodySetup& BodySetup, const FTransform& BodyTransform, TArray<FParkourCollisionElement>& OutElements)
+{
+	const FVector Scale = BodyTransform.GetScale3D();
+
+	for (const FKBoxElem& BoxElem : BodySetup.AggGeom.BoxElems)
+	{
+		OutElements.Add(MakeBox(BoxElem.GetTransform(), FVector(BoxElem.X, BoxElem.Y, BoxElem.Z) * 0.5f, BodyTransform));
+	}
+
+	for (const FKConvexElem& ConvexElem : BodySetup.AggGeom.ConvexElems)
+	{
+		const auto& ChaosConvex = ConvexElem.GetChaosConvexMesh();
+		if (ChaosConvex.IsValid())
+		{
+			FParkourCollisionElement& Element = OutElements.AddDefaulted_GetRef();
+			for (const auto& Face : ChaosConvex->GetFaces())
+			{
+				Element.AddPlane(FVector(Face.X()), FVector(Face.Normal()), ConvexElem.GetTransform(), BodyTransform);
+			}
+		}
+	}
+
+	for (const FKSphylElem& SphylElem : BodySetup.AggGeom.SphylElems)
+	{
+		const FVector Center = BodyTransform.TransformPosition(SphylElem.Center);
+		const FVector Axis = BodyTransform.GetRotation().RotateVector(SphylElem.Rotation.RotateVector(FVector::UpVector));
+		const FVector HalfSegment = Axis * (SphylElem.GetScaledCylinderLength(Scale) * 0.5f);
+		OutElements.Add(MakeCapsule(Center - HalfSegment, Center + HalfSegment, SphylElem.GetScaledRadius(Scale)));
+	}
+
+	for (const FKSphereElem& SphereElem : BodySetup.AggGeom.SphereElems)
+	{
+		const FVector Center = BodyTransform.TransformPosition(SphereElem.Center);
+		OutElements.Add(MakeCapsule(Center, Center, SphereElem.Radius * Scale.GetAbsMin()));
+	}
+}
+
+void FParkourCollisionElement::AddPlane(const FVector& Point, const FVector& Normal, const FTransform& ElementTransform, const FTransform& BodyTransform)
+{
+	const FVector WorldPoint = BodyTransform.TransformPosition(ElementTransform.TransformPosition(Point));
+	const FVector WorldNormal = UParkourFunctionLibrary::TransformNormal(BodyTransform, UParkourFunctionLibrary::TransformNormal(ElementTransform, Normal));
+	if (WorldNormal.IsNearlyZero() == false)
+	{
+		Planes.Add(FPlane(WorldPoint, WorldNormal));
+	}
+}
+
+double FParkourCollisionElement::GetSignedDistance(const FVector& Point) const
+{
+	if (Planes.Num() == 0)
+	{
+		return FVector::Dist(FMath::ClosestPointOnSegment(Point, SegmentStart, SegmentEnd), Point) - Radius;
+	}
+
+	double Distance = -TNumericLimits<double>::Max();
+	for (const FPlane& Plane : Planes)
+	{
+		Distance = FMath::Max(Distance, Plane.PlaneDot(Point));
+	}
+	return Distance;
+}
+
+FVector FParkourCollisionElement::GetNormal(const FVector& Point) const
+{
+	if (Planes.Num() == 0)
+	{
+		const FVector Outward = (Point - FMath::ClosestPointOnSegment(Point, SegmentStart, SegmentEnd)).GetSafeNormal();
+		return Outward.IsNearlyZero() ? FVector::UpVector : Outward;
+	}
+
+	const FPlane* NearestPlane = &Planes[0];
+	for (const FPlane& Plane : Planes)
+	{
+		if (Plane.PlaneDot(Point) > NearestPlane->PlaneDot(Point))
+		{
+			NearestPlane = &Plane;
+		}
+	}
+	return NearestPlane->GetNormal();
+}
+
+double FParkourCollisionElement::GetExitDistance(const FVector& Point, const FVector& Direction, const double MaxDistance) const
+{
+	if (Planes.Num() == 0)
+	{
+		// Convex, so the ray leaves once and halving the interval homes in on that point.
+		if (GetSignedDistance(Point + (Direction * MaxDistance)) < 0)
+		{
+			return MaxDistance;
+		}
+
+		double Inside = 0;
+		double Outside = MaxDistance;
+		for (int Step = 0; Step < 24; Step++)
+		{
+			const double Middle = (Inside + Outside) * 0.5;
+			if (GetSignedDistance(Point + (Direction * Middle)) < 0)
+			{
+				Inside = Middle;
+			}
+			else
+			{
+				Outside = Middle;
+			}
+		}
+		return Inside;
+	}
+
+	double ExitDistance = MaxDistance;
+	for (const FPlane& Plane : Planes)
+	{
+		const double Approach = FVector::DotProduct(Plane.GetNormal(), Direction);
+		if (Approach > UE_SMALL_NUMBER)
+		{
+			ExitDistance = FMath::Min(ExitDistance, -Plane.PlaneDot(Point) / Approach);
+		}
+	}
+	return FMath::Max(ExitDistance, 0.0);
+}
+
+bool FParkourCollisionElement::ExtractLedge(const FVector& WallPoint, const float MaxRise, const float MaxDepth, FParkourLedge& OutLedge) const
+{
+	const FVector WallNormal = GetNormal(WallPoint).GetSafeNormal2D();
+	if (WallNormal.IsNearlyZero() || MaxRise <= 0)
+	{
+		return false;
+	}
+	const FVector IntoWall = -WallNormal;
+
+	// Straight up inside the face to the top.
+	const FVector Column = WallPoint + (IntoWall * ParkourElementTopInset);
+	if (GetSignedDistance(Column) >= 0)
+	{
+		return false;
+	}
+
+	const double Rise = GetExitDistance(Column, FVector::UpVector, MaxRise);
+	const FVector TopPoint = Column + FVector(0, 0, Rise);
+	if (Rise >= MaxRise || GetNormal(TopPoint).Z < ParkourElementMinTopNormalZ)
+	{
+		return false;
+	}
+
+	// Back out to the face just under the top, a leaning wall meets the top somewhere else than at WallPoint.
+	const FVector UnderTop = TopPoint - FVector(0, 0, ParkourElementFaceDrop);
+	if (GetSignedDistance(UnderTop) >= 0)
+	{
+		return false;
+	}
+	const FVector FacePoint = UnderTop + (WallNormal * GetExitDistance(UnderTop, WallNormal, ParkourElementTopInset + MaxDepth));
+	const FVector EdgePoint = FVector(FacePoint.X, FacePoint.Y, TopPoint.Z);
+
+	OutLedge = FParkourLedge();
+	OutLedge.Start = EdgePoint;
+	OutLedge.End = EdgePoint;
+	OutLedge.WallNormal = WallNormal;
+
+	const FVector FarPoint = UnderTop + (IntoWall * GetExitDistance(UnderTop, IntoWall, ParkourElementTopInset + MaxDepth));
+	const float Depth = FVector::Dist2D(EdgePoint, FarPoint);
+	OutLedge.Depth = (Depth < MaxDepth) ? Depth : 0;
+	return true;
+}
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Collision/ParkourCollisionScene.h"
+#include "Collision/ParkourCollisionElement.h"
+#include "Ledges/ParkourLedgeTemplateUserData.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Engine/World.h"
+
+// How far from an element's surface an impact may lie and still count as landing on it.
+static constexpr double ParkourHitElementTolerance = 1.0;
+
+/** Where the body a hit landed on is placed, the hit instance for instanced meshes. */
+static bool GetHitBodyTransform(const FHitResult& Hit, FTransform& OutTransform)
+{
+	const UPrimitiveComponent* Component = Hit.GetComponent();
+	if (Component == nullptr)
+	{
+		return false;
+	}
+
+	if (const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component))
+	{
+		return InstancedComponent->GetInstanceTransform(Hit.Item, OutTransform, true);
+	}
+
+	OutTransform = Component->GetComponentTransform();
+	return true;
+}
+
+FParkourWorldCollisionScene::FParkourWorldCollisionScene(const UWorld* InWorld, const FCollisionQueryParams& InQueryParams)
+	: World(InWorld)
+	, QueryParams(InQueryParams)
+{
+}
+
+bool FParkourWorldCollisionScene::Sweep(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, FHitResult& OutHit) const
+{
+	const UWorld* QueryWorld = World.Get();
+	if (QueryWorld == nullptr)
+	{
+		OutHit = FHitResult(Start, End);
+		return false;
+	}
+
+	switch (Shape)
+	{
+	case EParkourTraceShape::Sphere:
+		return QueryWorld->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeSphere(Extent.X), QueryParams);
+	case EParkourTraceShape::Capsule:
+		return QueryWorld->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeCapsule(Extent.X, Extent.Z), QueryParams);
+	case EParkourTraceShape::Box:
+		return QueryWorld->SweepSingleByChannel(OutHit, Start, End, Rotation, ECC_Visibility, FCollisionShape::MakeBox(Extent), QueryParams);
+	default:
+		return QueryWorld->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams);
+	}
+}
+
+bool FParkourWorldCollisionScene::GetHitElement(const FHitResult& Hit, FParkourCollisionElement& OutElement) const
+{
+	UPrimitiveComponent* Component = Hit.GetComponent();
+	const UBodySetup* BodySetup = Component ? Component->GetBodySetup() : nullptr;
+
+	// The scans do not trace complex, so they see the simple shapes unless the body stands in its triangles for them.
+	if (BodySetup == nullptr || BodySetup->GetCollisionTraceFlag() == CTF_UseComplexAsSimple)
+	{
+		return false;
+	}
+
+	FTransform BodyTransform;
+	if (GetHitBodyTransform(Hit, BodyTransform) == false)
+	{
+		return false;
+	}
+
+	TArray<FParkourCollisionElement> Elements;
+	FParkourCollisionElement::GatherElements(*BodySetup, BodyTransform, Elements);
+
+	// Where two elements touch at the impact, the shape of neither one alone is what the traces see.
+	int32 HitElementIndex = INDEX_NONE;
+	for (int32 ElementIndex = 0; ElementIndex < Elements.Num(); ElementIndex++)
+	{
+		if (FMath::Abs(Elements[ElementIndex].GetSignedDistance(Hit.ImpactPoint)) <= ParkourHitElementTolerance)
+		{
+			if (HitElementIndex != INDEX_NONE)
+			{
+				return false;
+			}
+			HitElementIndex = ElementIndex;
+		}
+	}
+
+	if (HitElementIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutElement = MoveTemp(Elements[HitElementIndex]);
+	return true;
+}
+
+const UParkourLedgeTemplateUserData* FParkourWorldCollisionScene::GetHitLedgeTemplate(const FHitResult& Hit, FTransform& OutTransform) const
+{
+	const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Hit.GetComponent());
+	const UParkourLedgeTemplateUserData* Template = MeshComponent ? UParkourLedgeTemplateUserData::Get(MeshComponent->GetStaticMesh()) : nullptr;
+	if (Template == nullptr || GetHitBodyTransform(Hit, OutTransform) == false)
+	{
+		return nullptr;
+	}
+	return Template;
+}
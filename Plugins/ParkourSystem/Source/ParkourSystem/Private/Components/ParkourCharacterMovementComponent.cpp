@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/ParkourCharacterMovementComponent.h"
+
+void UParkourCharacterMovementComponent::PhysCustom(float DeltaTime, int32 Iterations)
+{
+	if (CustomMovementMode == (uint8)EParkourCustomMovementMode::Climb)
+	{
+		// Hops, corner moves and climbing up are montages, their root motion moves the character the way flying did.
+		if (HasAnimRootMotion() || CurrentRootMotion.HasOverrideVelocity())
+		{
+			PhysFlying(DeltaTime, Iterations);
+		}
+		else
+		{
+			Velocity = FVector::ZeroVector;
+		}
+	}
+	else
+	{
+		Super::PhysCustom(DeltaTime, Iterations);
+	}
+}
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/ParkourDynamicLedgeComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Subsystems/ParkourLedgeSubsystem.h"
+
+UParkourDynamicLedgeComponent::UParkourDynamicLedgeComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// One actor is small, splitting it into tiles would only add overhead.
+	BakeSettings.TileSize = 0;
+}
+
+void UParkourDynamicLedgeComponent::InvalidateLedges()
+{
+	if (UParkourLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UParkourLedgeSubsystem>())
+	{
+		for (const TWeakObjectPtr<UPrimitiveComponent>& Primitive : Primitives)
+		{
+			LedgeSubsystem->InvalidateDynamicPrimitive(Primitive.Get());
+		}
+	}
+}
+
+void UParkourDynamicLedgeComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UParkourLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UParkourLedgeSubsystem>();
+	if (LedgeSubsystem == nullptr)
+	{
+		return;
+	}
+
+	// Only what the wall scan can hit carries ledges.
+	GetOwner()->ForEachComponent<UPrimitiveComponent>(false, [this, LedgeSubsystem](UPrimitiveComponent* Primitive)
+	{
+		if (Primitive->IsCollisionEnabled() && Primitive->GetCollisionResponseToChannel(ECC_Visibility) == ECR_Block)
+		{
+			LedgeSubsystem->RegisterDynamicPrimitive(Primitive, BakeSettings);
+			Primitives.Add(Primitive);
+		}
+	});
+}
+
+void UParkourDynamicLedgeComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UParkourLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UParkourLedgeSubsystem>())
+	{
+		for (const TWeakObjectPtr<UPrimitiveComponent>& Primitive : Primitives)
+		{
+			LedgeSubsystem->UnregisterDynamicPrimitive(Primitive.Get());
+		}
+	}
+	Primitives.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
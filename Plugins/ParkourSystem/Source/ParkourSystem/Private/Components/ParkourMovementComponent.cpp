@@ -7,12 +7,101 @@
 #include "GameFramework/SpringArmComponent.h"
 #include "Components/ArrowComponent.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/ParkourCharacterMovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
-#include "KismetTraceUtils.h"
 #include "FunctionLibrary/ParkourFunctionLibrary.h"
 #include "Interfaces/ParkourABPInterface.h"
 #include "DataAssets/ParkourVariablesDataAsset.h"
+#include "DataAssets/ParkourActionRegistryDataAsset.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "TimerManager.h"
 #include "MotionWarpingComponent.h"
+#include "Subsystems/ParkourLedgeSubsystem.h"
+#include "ParkourSystem.h"
+#include "Types/ParkourGameplayTags.h"
+#include "Stats/ParkourStats.h"
+#include "Debug/ParkourDebugSubsystem.h"
+#include "Collision/ParkourCollisionScene.h"
+#include "Collision/ParkourCollisionElement.h"
+#include "Ledges/ParkourLedgeTemplateUserData.h"
+
+DECLARE_CYCLE_STAT(TEXT("CheckWallShape"), STAT_ParkourCheckWallShape, STATGROUP_Parkour);
+DECLARE_CYCLE_STAT(TEXT("ParkourType"), STAT_ParkourParkourType, STATGROUP_Parkour);
+DECLARE_CYCLE_STAT(TEXT("MontageSelection"), STAT_ParkourMontageSelection, STATGROUP_Parkour);
+DECLARE_CYCLE_STAT(TEXT("ClimbMovement"), STAT_ParkourClimbMovement, STATGROUP_Parkour);
+DECLARE_CYCLE_STAT(TEXT("LimbsClimbIK"), STAT_ParkourLimbsClimbIK, STATGROUP_Parkour);
+DECLARE_CYCLE_STAT(TEXT("FindDropDownHangLocation"), STAT_ParkourFindDropDownHangLocation, STATGROUP_Parkour);
+DECLARE_CYCLE_STAT(TEXT("AutoClimb"), STAT_ParkourAutoClimb, STATGROUP_Parkour);
+DECLARE_CYCLE_STAT(TEXT("LineTrace"), STAT_ParkourLineTrace, STATGROUP_Parkour);
+DECLARE_CYCLE_STAT(TEXT("SphereTrace"), STAT_ParkourSphereTrace, STATGROUP_Parkour);
+DECLARE_CYCLE_STAT(TEXT("CapsuleTrace"), STAT_ParkourCapsuleTrace, STATGROUP_Parkour);
+DECLARE_CYCLE_STAT(TEXT("BoxTrace"), STAT_ParkourBoxTrace, STATGROUP_Parkour);
+
+static TAutoConsoleVariable<int32> CVarParkourClimbTracker(
+	TEXT("parkour.ClimbTracker"),
+	1,
+	TEXT("1: climb moves confirm the ledge of the previous move with a few traces before searching for it again, 0: every move searches."));
+
+// Largest step up or down the tracked ledge may take between two climb moves.
+static constexpr float ParkourClimbTrackerMaxStep = 10.0f;
+
+// Walls turning further than this between two climb moves are searched for again, about 25 degrees.
+static constexpr float ParkourClimbTrackerMinWallDot = 0.9f;
+
+// Walls turning less than this keep the last surface check, about 2.5 degrees.
+static constexpr float ParkourClimbTrackerSameWallDot = 0.999f;
+
+// CheckClimbMovementSurface looks 13 cm ahead of the wall point, repeating it sooner leaves no gap.
+static constexpr float ParkourClimbTrackerSurfaceCheckDistance = 10.0f;
+
+// The ledge ahead is confirmed again this far before the hands reach the end of the confirmed stretch.
+static constexpr float ParkourClimbTrackerReconfirmDistance = 4.0f;
+
+// The hop ladder of CheckWallShape looks for the edge from 60 cm below to 180 cm above the character.
+static constexpr float ParkourSimpleLedgeMinHeight = -60.0f;
+static constexpr float ParkourSimpleLedgeMaxHeight = 180.0f;
+
+// The top probes of CheckWallShape step 30 cm across the top eight times before they give up on a far edge.
+static constexpr float ParkourSimpleLedgeMaxDepth = 240.0f;
+
+// Up axis of a mesh placement its ledge template still holds for.
+static constexpr float ParkourLedgeTemplateMinUpZ = 0.999f;
+
+// The hands travel this far off the wall during a hop, with about the reach of the hop ladder traces around them.
+static constexpr float ParkourHopClearanceOffset = 20.0f;
+static constexpr float ParkourHopClearanceRadius = 10.0f;
+
+struct FParkourStateSettings
+{
+	ECollisionEnabled::Type CollisionType;
+	EMovementMode MovementMode;
+	FRotator RotationRate;
+	bool bDoCollisionTest;
+	bool bStopMovementImmediately;
+};
+
+// What the character is set to on entering each state, indexed by EParkourState. MOVE_Custom is the climb mode of
+// UParkourCharacterMovementComponent, characters with plain character movement climb in MOVE_Flying instead.
+static const FParkourStateSettings ParkourStateSettingsTable[(int)EParkourState::Count] =
+{
+	/* NotBusy */		{ ECollisionEnabled::QueryAndPhysics, MOVE_Walking, FRotator(0, 500, 0), true, false },
+	/* ReachLedge */	{ ECollisionEnabled::NoCollision, MOVE_Flying, FRotator(0, 500, 0), true, false },
+	/* Climb */			{ ECollisionEnabled::NoCollision, MOVE_Custom, FRotator::ZeroRotator, true, true },
+	/* Mantle */		{ ECollisionEnabled::NoCollision, MOVE_Flying, FRotator(0, 500, 0), true, false },
+	/* Vault */			{ ECollisionEnabled::NoCollision, MOVE_Flying, FRotator(0, 500, 0), true, false },
+};
+
+// Transitions the montages are expected to make, [From][To] in EParkourState order.
+static const bool ParkourStateTransitionTable[(int)EParkourState::Count][(int)EParkourState::Count] =
+{
+	//					NotBusy	ReachLedge	Climb	Mantle	Vault
+	/* NotBusy */		{ false,	true,		true,	true,	true },
+	/* ReachLedge */	{ true,		false,		true,	true,	false },
+	/* Climb */			{ true,		true,		false,	true,	false },
+	/* Mantle */		{ true,		false,		true,	false,	false },
+	/* Vault */			{ true,		false,		false,	false,	false },
+};
 
 // Sets default values for this component's properties
 UParkourMovementComponent::UParkourMovementComponent()
@@ -21,10 +110,10 @@ UParkourMovementComponent::UParkourMovementComponent()
 	// off to improve performance if you don't need them.
 	PrimaryComponentTick.bCanEverTick = true;
 
-	ParkourActionTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction"));
-	ParkourStateTag = FGameplayTag::RequestGameplayTag(FName("Parkour.State.NotBusy"));
-	ClimbStyleTag = FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle"));
-	ClimbDirectionTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.NoDirection"));
+	ParkourActionTag = ParkourTags::Action_NoAction;
+	ParkourState = EParkourState::NotBusy;
+	ClimbStyle = EParkourClimbStyle::None;
+	ClimbDirection = EParkourDirection::NoDirection;
 
 	DrawWallShapeTraceDebugType = EDrawDebugTrace::None;
 	CharacterHeightDifference = 1;
@@ -42,6 +131,231 @@ void UParkourMovementComponent::BeginPlay()
 	
 }
 
+void UParkourMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (PlayerCharacter)
+	{
+		PlayerCharacter->MovementModeChangedDelegate.RemoveDynamic(this, &UParkourMovementComponent::OnMovementModeChanged);
+		PlayerCharacter->LandedDelegate.RemoveDynamic(this, &UParkourMovementComponent::OnLanded);
+	}
+
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(ProximityTimerHandle);
+
+		if (UParkourLedgeSubsystem* LedgeSubsystem = World->GetSubsystem<UParkourLedgeSubsystem>())
+		{
+			LedgeSubsystem->RemovePrefetchActor(PlayerCharacter);
+		}
+	}
+
+	if (ActionMontagesHandle.IsValid())
+	{
+		ActionMontagesHandle->CancelHandle();
+		ActionMontagesHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UParkourMovementComponent::BuildActionRegistry()
+{
+	ActionDataAssets.Reset();
+
+	struct FLegacyAction
+	{
+		const FGameplayTag& ActionTag;
+		const TSoftObjectPtr<UParkourVariablesDataAsset>& DataAsset;
+	};
+
+	const FLegacyAction LegacyActions[] =
+	{
+		{ ParkourTags::Action_ThinVault, ThinVaultDataAsset },
+		{ ParkourTags::Action_HighVault, HighVaultDataAsset },
+		{ ParkourTags::Action_Vault, VaultDataAsset },
+		{ ParkourTags::Action_Mantle, MantleDataAsset },
+		{ ParkourTags::Action_LowMantle, LowMantleDataAsset },
+		{ ParkourTags::Action_Climb, BracedClimbDataAsset },
+		{ ParkourTags::Action_FreeHangClimb, FreeHangClimbDataAsset },
+		{ ParkourTags::Action_ClimbingUp, BracedClimbUpDataAsset },
+		{ ParkourTags::Action_FreeHangClimbUp, FreeHangClimbUpDataAsset },
+		{ ParkourTags::Action_FallingBraced, FallingBracedDataAsset },
+		{ ParkourTags::Action_FallingFreeHang, FallingFreeHangDataAsset },
+		{ ParkourTags::Action_DropDown, DropDownDataAsset },
+		{ ParkourTags::Action_FreeHangDropDown, FreeHangDropDownDataAsset },
+	};
+
+	// Variables assets only hold soft montage references, loading one does not pull its montage in.
+	for (const FLegacyAction& LegacyAction : LegacyActions)
+	{
+		if (UParkourVariablesDataAsset* DataAsset = LegacyAction.DataAsset.LoadSynchronous())
+		{
+			ActionDataAssets.Add(LegacyAction.ActionTag, DataAsset);
+		}
+	}
+
+	if (ActionRegistry)
+	{
+		for (const TPair<FGameplayTag, UParkourVariablesDataAsset*>& Action : ActionRegistry->GetActions())
+		{
+			if (Action.Value)
+			{
+				ActionDataAssets.Add(Action.Key, Action.Value);
+			}
+		}
+	}
+}
+
+void UParkourMovementComponent::PreloadActionMontages()
+{
+	if (bActionsPreloaded)
+	{
+		return;
+	}
+	bActionsPreloaded = true;
+
+	BuildActionRegistry();
+
+	TArray<FSoftObjectPath> MontagePaths;
+	for (const TPair<FGameplayTag, UParkourVariablesDataAsset*>& Action : ActionDataAssets)
+	{
+		if (Action.Value->ParkourMontage.IsNull() == false)
+		{
+			MontagePaths.AddUnique(Action.Value->ParkourMontage.ToSoftObjectPath());
+		}
+	}
+
+	if (MontagePaths.Num() > 0)
+	{
+		ActionMontagesHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MontagePaths, FStreamableDelegate(), FStreamableManager::DefaultAsyncLoadPriority);
+	}
+}
+
+void UParkourMovementComponent::OnMovementModeChanged(ACharacter* Character, EMovementMode PrevMovementMode, uint8 PreviousCustomMode)
+{
+	WakeUp();
+}
+
+void UParkourMovementComponent::OnLanded(const FHitResult& Hit)
+{
+	WakeUp();
+}
+
+void UParkourMovementComponent::WakeUp()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(ProximityTimerHandle);
+	}
+
+	if (IsComponentTickEnabled() == false)
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+bool UParkourMovementComponent::CanSleep() const
+{
+	if (ActivationMode != EParkourActivationMode::EventDriven || PlayerCharacter == nullptr || CharacterMovement == nullptr)
+	{
+		return false;
+	}
+
+	// AutoClimb has nothing to do while standing, it only needs to run again once the ground can go away.
+	if (bInGround == false || CharacterMovement->IsMovingOnGround() == false || ParkourState != EParkourState::NotBusy || ParkourActionTag != ParkourTags::Action_NoAction || AsyncWallScanStage != EParkourWallScanStage::None)
+	{
+		return false;
+	}
+
+	// Stay awake next to ledges so bInGround is current when the player presses the parkour button.
+	if (ProximityWakeRadius > 0)
+	{
+		if (UParkourLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UParkourLedgeSubsystem>())
+		{
+			if (LedgeSubsystem->HasLedgeNear(PlayerCharacter->GetActorLocation(), ProximityWakeRadius))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void UParkourMovementComponent::Sleep()
+{
+	SetComponentTickEnabled(false);
+
+	// The grounded AutoClimb tick that cleared the last scan does not run while asleep.
+	ResetParkourResult();
+
+	if (ProximityWakeRadius > 0 && ProximityCheckInterval > 0)
+	{
+		UWorld* World = GetWorld();
+		UParkourLedgeSubsystem* LedgeSubsystem = World->GetSubsystem<UParkourLedgeSubsystem>();
+		if (LedgeSubsystem && LedgeSubsystem->GetNumLedges() > 0)
+		{
+			World->GetTimerManager().SetTimer(ProximityTimerHandle, this, &UParkourMovementComponent::CheckLedgeProximity, ProximityCheckInterval, true);
+		}
+	}
+}
+
+void UParkourMovementComponent::CheckLedgeProximity()
+{
+	if (PlayerCharacter)
+	{
+		if (UParkourLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UParkourLedgeSubsystem>())
+		{
+			if (LedgeSubsystem->HasLedgeNear(PlayerCharacter->GetActorLocation(), ProximityWakeRadius))
+			{
+				PreloadActionMontages();
+				WakeUp();
+			}
+		}
+	}
+}
+
+void UParkourMovementComponent::UpdateTickInterval()
+{
+	switch (ParkourState)
+	{
+	case EParkourState::NotBusy:
+		SetComponentTickInterval(StateTickIntervals.NotBusy);
+		break;
+	case EParkourState::ReachLedge:
+		SetComponentTickInterval(StateTickIntervals.ReachLedge);
+		break;
+	case EParkourState::Climb:
+		SetComponentTickInterval(StateTickIntervals.Climb);
+		break;
+	case EParkourState::Mantle:
+		SetComponentTickInterval(StateTickIntervals.Mantle);
+		break;
+	case EParkourState::Vault:
+		SetComponentTickInterval(StateTickIntervals.Vault);
+		break;
+	default:
+		break;
+	}
+}
+
+void UParkourMovementComponent::GetResidentMontages(TArray<UAnimMontage*>& OutMontages) const
+{
+	OutMontages.Reset();
+	for (const TPair<FGameplayTag, UParkourVariablesDataAsset*>& Action : ActionDataAssets)
+	{
+		if (UAnimMontage* Montage = Action.Value->ParkourMontage.Get())
+		{
+			OutMontages.AddUnique(Montage);
+		}
+	}
+}
+
+bool UParkourMovementComponent::AreActionMontagesLoaded() const
+{
+	return ActionMontagesHandle.IsValid() == false || ActionMontagesHandle->HasLoadCompleted();
+}
+
 
 // Called every frame
 void UParkourMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -49,13 +363,23 @@ void UParkourMovementComponent::TickComponent(float DeltaTime, ELevelTick TickTy
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
 	AutoClimb();
+	UpdateClimbMovement(DeltaTime);
+
+#if PARKOUR_DEBUG_DRAW
+	if (UParkourDebugSubsystem* DebugSubsystem = UParkourDebugSubsystem::Get(GetWorld()))
+	{
+		TArray<FString> Lines;
+		Lines.Add(FString::Printf(TEXT("Climb Style: %s"), *ParkourTags::FromClimbStyle(ClimbStyle).ToString()));
+		Lines.Add(FString::Printf(TEXT("Parkour Action: %s"), *ParkourActionTag.ToString()));
+		Lines.Add(FString::Printf(TEXT("Parkour State: %s"), *ParkourTags::FromState(ParkourState).ToString()));
+		Lines.Add(FString::Printf(TEXT("Direction: %s"), *ParkourTags::FromDirection(GetDesiredClimbRotation()).ToString()));
+		DebugSubsystem->SetStateText(this, MoveTemp(Lines));
+	}
+#endif
 
-	if (GEngine)
+	if (CanSleep())
 	{
-		GEngine->AddOnScreenDebugMessage(-1, DeltaTime, FColor::Cyan, FString::Printf(TEXT("Climb Style: %s"), *ClimbStyleTag.ToString()));
-		GEngine->AddOnScreenDebugMessage(-1, DeltaTime, FColor::Cyan, FString::Printf(TEXT("Parkour Action: %s"), *ParkourActionTag.ToString()));
-		GEngine->AddOnScreenDebugMessage(-1, DeltaTime, FColor::Cyan, FString::Printf(TEXT("Parkour State: %s"), *ParkourStateTag.ToString()));
-		GEngine->AddOnScreenDebugMessage(-1, DeltaTime, FColor::Cyan, FString::Printf(TEXT("Direction: %s"), *GetDesiredClimbRotation().ToString()));
+		Sleep();
 	}
 }
 
@@ -64,6 +388,14 @@ bool UParkourMovementComponent::SetInitializeReference(ACharacter* Character, US
 	if (Character)
 	{
 		PlayerCharacter = Character;
+		BuildTraceQueryParams();
+		Character->MovementModeChangedDelegate.AddUniqueDynamic(this, &UParkourMovementComponent::OnMovementModeChanged);
+		Character->LandedDelegate.AddUniqueDynamic(this, &UParkourMovementComponent::OnLanded);
+		if (UParkourLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UParkourLedgeSubsystem>())
+		{
+			LedgeSubsystem->AddPrefetchActor(Character);
+		}
+		UpdateTickInterval();
 		CharacterMesh = Character->GetMesh();
 		CharacterMovement = Character->GetCharacterMovement();
 		if (CharacterMesh)
@@ -125,9 +457,15 @@ bool UParkourMovementComponent::SetInitializeReference(ACharacter* Character, US
 	return true;
 }
 
+void UParkourMovementComponent::AddMovementInput(const FVector2D& MovementVector)
+{
+	AddMovementInput(MovementVector.X, false);
+	AddMovementInput(MovementVector.Y, true);
+}
+
 void UParkourMovementComponent::AddMovementInput(float ScaleValue, bool bFront)
 {
-	if (ParkourStateTag != FGameplayTag::RequestGameplayTag(FName("Parkour.State.ReachLedge")))
+	if (ParkourState != EParkourState::ReachLedge)
 	{
 		bFirstClimbMove = false;
 	}
@@ -136,269 +474,1102 @@ void UParkourMovementComponent::AddMovementInput(float ScaleValue, bool bFront)
 	{
 		ForwardValue = ScaleValue;
 		GetClimbForwardValue(ForwardValue, HorizontalClimbForwardValue, VerticalClimbForwardValue);
-		if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.NotBusy")))
+		if (ParkourState == EParkourState::NotBusy)
 		{
 			const FRotator YawRotation(0, PlayerCharacter->GetControlRotation().Yaw, 0);
 			const FVector ForwardDirection = UParkourFunctionLibrary::GetForwardVector(YawRotation);
 
 			PlayerCharacter->AddMovementInput(ForwardDirection, ScaleValue);
 		}
-		else if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Climb")))
+		else if (ParkourState == EParkourState::Climb)
 		{
-			if (CharacterAnimInstance)
-			{
-				if (CharacterAnimInstance->IsAnyMontagePlaying())
-				{
-					StopClimbMovement();
-				}
-				else
-				{
-					ClimbMovement();
-				}
-			}
+			bClimbInputPending = true;
 		}
 	}
 	else
 	{
 		RightValue = ScaleValue;
 		GetClimbRightValue(RightValue, HorizontalClimbRightValue, VerticalClimbRightValue);
-		if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.NotBusy")))
+		if (ParkourState == EParkourState::NotBusy)
 		{
 			const FRotator YawRotation(0, PlayerCharacter->GetControlRotation().Yaw, 0);
 			const FVector RightDirection = UParkourFunctionLibrary::GetRightVector(YawRotation);
 
 			PlayerCharacter->AddMovementInput(RightDirection, ScaleValue);
 		}
-		else if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Climb")))
+		else if (ParkourState == EParkourState::Climb)
 		{
-			if (CharacterAnimInstance)
-			{
-				if (CharacterAnimInstance->IsAnyMontagePlaying())
-				{
-					StopClimbMovement();
-				}
-				else
-				{
-					ClimbMovement();
-				}
-			}
+			bClimbInputPending = true;
 		}
 	}
 }
 
 void UParkourMovementComponent::ParkourAction(bool bAutoClimb)
 {
-	if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction")))
+	// The first parkour attempt is what makes a character need the action montages, pawns that never climb never load them.
+	PreloadActionMontages();
+
+	if (AsyncWallScanStage != EParkourWallScanStage::None)
+	{
+		// A manual press during an in-flight auto climb scan takes it over, so a miss still jumps.
+		if (bAutoClimb == false && bCanManualClimb)
+		{
+			bAsyncWallScanAutoClimb = false;
+		}
+		return;
+	}
+
+	if (ParkourActionTag == ParkourTags::Action_NoAction)
 	{
 		if (bAutoClimb)
 		{
 			if (bCanAutoClimb)
 			{
-				CheckWallShape();
-				CheckDistance();
-				ParkourType(bAutoClimb);
+				StartWallScan(bAutoClimb);
 			}
 		}
 		else
 		{
 			if (bCanManualClimb)
 			{
-				CheckWallShape();
-				CheckDistance();
-				ParkourType(bAutoClimb);
+				StartWallScan(bAutoClimb);
 			}
 		}
 	}
 }
 
-void UParkourMovementComponent::CheckWallShape()
+void UParkourMovementComponent::StartWallScan(const bool bAutoClimb)
 {
-	if (PlayerCharacter == nullptr || CharacterMovement == nullptr)
+	if (PlayerCharacter == nullptr || FindBakedHop())
 	{
 		return;
-	}	
+	}
 
-	TArray<FHitResult> 	WallHitTraces = TArray<FHitResult>();
+	// The scan only overwrites what it hits, a press after a sleep must not act on the wall of the one before.
+	// Climbing keeps the held ledge, the scan aims from it.
+	if (ParkourState == EParkourState::NotBusy)
+	{
+		ResetParkourResult();
+	}
 
-	TArray<FHitResult> HopHitTraces = TArray<FHitResult>();
+	// Confirming a baked ledge sweeps too, every path of the scan counts into this context.
+	FParkourScanContext Context(PlayerCharacter->GetActorTransform());
+	TGuardValue<FParkourScanContext*> ScanContextGuard(ScanContext, &Context);
 
-	FHitResult TopHits;
+	const bool bBaked = FindBakedWallShape();
+#if PARKOUR_TRACE_RECORDING
+	BeginRecordedScan(bAutoClimb, bBaked);
+#endif
 
-	if (UWorld* World = GetWorld())
+	if (bBaked)
 	{
-		//int LastIndex = CharacterMovement->IsFalling() ? 15 : 8;
-		for (int Index = 0; Index <= 15; Index++)
-		{
-			bool bShouldBreak = false;
-			for (int Index2 = 0; Index2 <= 11; Index2++)
-			{
-				FHitResult TraceHitOut;
-				FVector Vector = (FVector(0, 0, Index * 16) + FVector(0, 0, FirstClimbHeight()) + PlayerCharacter->GetActorLocation());
-				FVector TraceStart = Vector + (PlayerCharacter->GetActorForwardVector() * -20);
-				FVector TraceEnd = Vector + (PlayerCharacter->GetActorForwardVector() * ((10 * Index2) + 10));				
-				
-				bool bTraceGotHit = SphereTrace(TraceHitOut, TraceStart, TraceEnd, 10);
+		FinishScanContext(Context);
+		ShowHitResults();
+		CheckDistance();
+		ParkourType(bAutoClimb);
+#if PARKOUR_TRACE_RECORDING
+		EndRecordedScan();
+#endif
+	}
+	else if (bUseAsyncWallScan && CollisionScene == nullptr)
+	{
+		BeginAsyncWallScan(bAutoClimb);
+	}
+	else
+	{
+		CheckWallShape();
+		CheckDistance();
+		ParkourType(bAutoClimb);
+#if PARKOUR_TRACE_RECORDING
+		EndRecordedScan();
+#endif
+	}
+}
 
-				if (TraceHitOut.bBlockingHit && TraceHitOut.bStartPenetrating == false)
-				{
-					bShouldBreak = true;
+bool UParkourMovementComponent::FindBakedWallShape()
+{
+	if (bUseBakedLedges == false || PlayerCharacter == nullptr || CharacterMovement == nullptr)
+	{
+		return false;
+	}
 
-					WallHitTraces.Empty();
-					int LastIndex3 = UParkourFunctionLibrary::SelectParkoutStateFloat(4, 0, 0, 2, ParkourStateTag);
-					for (int Index3 = 0; Index3 <= LastIndex3; Index3++)
-					{						
-						float TargetZ = (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Climb"))) ? 0.0f : -60.0f;
-						FVector Vector1 = FVector(0, 0, TargetZ);
+	UWorld* World = GetWorld();
+	UParkourLedgeSubsystem* LedgeSubsystem = World ? World->GetSubsystem<UParkourLedgeSubsystem>() : nullptr;
+	if (LedgeSubsystem == nullptr || LedgeSubsystem->IsCovered(PlayerCharacter->GetActorLocation()) == false)
+	{
+		return false;
+	}
 
-						TargetZ = (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Climb"))) ? TraceHitOut.ImpactPoint.Z : PlayerCharacter->GetActorLocation().Z;
-						FVector Vector2 = FVector(TraceHitOut.ImpactPoint.X, TraceHitOut.ImpactPoint.Y, TargetZ);
+	FParkourLedgeQuery Query;
+	Query.Location = PlayerCharacter->GetActorLocation();
+	Query.Forward = PlayerCharacter->GetActorForwardVector();
+	if (ParkourState == EParkourState::Climb)
+	{
+		// Hopping looks for the next ledge around the one being held, the traces need the held ledge to aim from.
+		if (ClimbedLedgeHitResult.bBlockingHit == false)
+		{
+			return false;
+		}
+		Query.MinTopZ = ClimbedLedgeHitResult.ImpactPoint.Z - 15;
+		Query.MaxTopZ = ClimbedLedgeHitResult.ImpactPoint.Z + 15;
+	}
+	else if (ParkourState == EParkourState::NotBusy)
+	{
+		Query.MinTopZ = Query.Location.Z - 60;
+		Query.MaxTopZ = Query.Location.Z + 180;
+	}
+	else
+	{
+		return false;
+	}
 
-						float VectorMultiplier = (Index3 * 20) + UParkourFunctionLibrary::SelectParkoutStateFloat(-40, 0, 0, -20, ParkourStateTag);
-						FRotator ReveresedImpactNormal = UParkourFunctionLibrary::NormalReverseRotationZ(TraceHitOut.ImpactNormal);
-						FVector ReveresedImpactNormalForwardVector = UParkourFunctionLibrary::GetForwardVector(ReveresedImpactNormal);
-						FVector ReveresedImpactNormalRightVector = UParkourFunctionLibrary::GetRightVector(ReveresedImpactNormal);
+	// A streamed out cell next to the character does not count as having no ledges, the traces look there instead.
+	if (LedgeSubsystem->IsCovered(Query.GetBounds()) == false)
+	{
+		return false;
+	}
 
-						FVector Vector3 = ReveresedImpactNormalRightVector * VectorMultiplier;
-						FVector Vector4 = ReveresedImpactNormalForwardVector * -40;
-						FVector Vector5 = ReveresedImpactNormalForwardVector * 30;
+	WallHitResult = FHitResult();
+	WallTopResult = FHitResult();
+	WallDepthResult = FHitResult();
+	WallVaultResult = FHitResult();
 
-						FVector LineTraceStart = Vector1 + Vector2 + Vector3 + Vector4;
-						FVector LineTraceEnd = Vector1 + Vector2 + Vector3 + Vector5;
+	FParkourLedge Ledge;
+	FVector EdgePoint;
+	if (LedgeSubsystem->FindLedge(Query, Ledge, EdgePoint) == false)
+	{
+		// No baked ledge is not proof of no wall, props placed since the bake and shapes the baker missed have none.
+		// Standing, one box sweep over the wall scan rows is enough to rule a wall out, anything it touches is traced.
+		TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::CheckWallShape);
+		return ParkourState == EParkourState::NotBusy && SweepWallRows(0, 15, FirstClimbHeight()) == false;
+	}
 
-						FHitResult LineTraceHitOut;
-						bool bLineTraceGotHit = LineTrace(LineTraceHitOut, LineTraceStart, LineTraceEnd);
+	// Moving geometry can cover a baked ledge, and its own ledges do not know what is around them.
+	// Checking the one ledge found is enough, failing that the traces look at this spot again.
+	if (LedgeSubsystem->HasDynamicGeometry(Query.GetBounds()))
+	{
+		return ConfirmBodyLedge(Ledge, EdgePoint);
+	}
+	SetWallShapeFromLedge(Ledge, EdgePoint);
+	return true;
+}
 
-						HopHitTraces.Empty();
-						int LastIndex4 = UParkourFunctionLibrary::SelectParkoutStateFloat(30, 0, 0, 7, ParkourStateTag);
-						for (int Index4 = 0; Index4 <= LastIndex4; Index4++)
-						{
-							FVector LineTrace2Start = LineTraceHitOut.TraceStart + FVector(0, 0, (Index4 * 8));
-							FVector LineTrace2End = LineTraceHitOut.TraceEnd + FVector(0, 0, (Index4 * 8));
+bool UParkourMovementComponent::FindBakedHop()
+{
+	if (bUseBakedLedges == false || ParkourState != EParkourState::Climb || ClimbedLedgeHitResult.bBlockingHit == false)
+	{
+		return false;
+	}
 
-							FHitResult LineTrace2HitOut;
-							bool bLineTrace2GotHit = LineTrace(LineTrace2HitOut, LineTrace2Start, LineTrace2End);
+#if PARKOUR_TRACE_RECORDING
+	// A replay reruns the wall scan the recording was made with.
+	if (FParkourTraceRecorder::IsRecording())
+	{
+		return false;
+	}
+#endif
 
-							HopHitTraces.Add(LineTrace2HitOut);
-						}
+	// Straight up is a climb up where the top is free, which the wall scan decides.
+	const EParkourDirection Direction = GetDesiredClimbRotation();
+	const FGameplayTag HopAction = ParkourTags::HopAction(Direction, ClimbStyle);
+	if (Direction == EParkourDirection::Forward || HopAction.IsValid() == false || ActionDataAssets.Contains(HopAction) == false)
+	{
+		return false;
+	}
 
-						int LastIndex5 = HopHitTraces.Num();
-						for (int Index5 = 1; Index5 < LastIndex5; Index5++)
-						{
-							const FHitResult& HopHitResult = HopHitTraces[Index5];
-							const FHitResult& PrevHopHitResult = HopHitTraces[Index5 - 1];
-							float Distance = (HopHitResult.bBlockingHit) ? HopHitResult.Distance : FVector::Distance(HopHitResult.TraceStart, HopHitResult.TraceEnd);
-							float PrevDistance = (PrevHopHitResult.bBlockingHit) ? PrevHopHitResult.Distance : FVector::Distance(PrevHopHitResult.TraceStart, PrevHopHitResult.TraceEnd);
+	UWorld* World = GetWorld();
+	UParkourLedgeSubsystem* LedgeSubsystem = World ? World->GetSubsystem<UParkourLedgeSubsystem>() : nullptr;
+	if (LedgeSubsystem == nullptr)
+	{
+		return false;
+	}
 
-							if ((Distance - PrevDistance) > 5.0f)
-							{
-								WallHitTraces.Add(PrevHopHitResult);
-								break;
-							}						
-						}
-					}					
-					
-					int LastIndex4 = WallHitTraces.Num();
-					for (int Index4 = 0; Index4 < LastIndex4; Index4++)
-					{
-						if (Index4 == 0)
-						{
-							WallHitResult = WallHitTraces[0];
-						}
-						else
-						{
-							float DistanceToWallHit = FVector::Distance(WallHitResult.ImpactPoint, PlayerCharacter->GetActorLocation());
-							float Distance = FVector::Distance(WallHitTraces[Index4].ImpactPoint, PlayerCharacter->GetActorLocation());
+	const FVector HeldPoint = ClimbedLedgeHitResult.ImpactPoint;
+	const FVector HeldWallNormal = ClimbedLedgeHitResult.ImpactNormal.GetSafeNormal2D();
+	FParkourLedge Ledge;
+	FVector LandingPoint;
+	if (LedgeSubsystem->FindHop(HeldPoint, HeldWallNormal, Direction, Ledge, LandingPoint) == false)
+	{
+		return false;
+	}
 
-							//Find shortest wall hit result
-							if (Distance <= DistanceToWallHit)
-							{
-								WallHitResult = WallHitTraces[Index4];
-							}
-						}
-					}
+	// The graph holds the level as it was baked, one sweep along the way of the hands covers anything since.
+	FHitResult ClearanceHit;
+	if (SphereTrace(ClearanceHit, HeldPoint + (HeldWallNormal * ParkourHopClearanceOffset), LandingPoint + (Ledge.WallNormal * ParkourHopClearanceOffset), ParkourHopClearanceRadius))
+	{
+		return false;
+	}
 
-					if (WallHitResult.bBlockingHit && WallHitResult.bStartPenetrating == false)
-					{
-						if (ParkourStateTag != FGameplayTag::RequestGameplayTag(FName("Parkour.State.Climb")))
-						{
-							WallRotation = UParkourFunctionLibrary::NormalReverseRotationZ(WallHitResult.ImpactNormal);
-						}
+	SetWallShapeFromLedge(Ledge, LandingPoint);
+	SetParkourAction(HopAction);
+	return true;
+}
 
-						for (int Index5 = 0; Index5 <= 8; Index5++)
-						{
-							FVector WallRotationForward = UParkourFunctionLibrary::GetForwardVector(WallRotation);
-							FVector SphereTraceStart = WallHitResult.ImpactPoint + (WallRotationForward * (Index5 * 30)) + (WallRotationForward * 2.0f) + FVector(0, 0, 7);
-							FVector SphereTraceEnd = SphereTraceStart - FVector(0, 0, 7);
-							
-							FHitResult SphereTraceHitOut;
-							bool bSphereTraceGotHit = SphereTrace(SphereTraceHitOut, SphereTraceStart, SphereTraceEnd, 2.5f);
-
-							if (Index5 == 0)
-							{
-								if (bSphereTraceGotHit)
-								{
-									WallTopResult = SphereTraceHitOut;
-								}
-							}
+void UParkourMovementComponent::SetWallShapeFromLedge(const FParkourLedge& Ledge, const FVector& EdgePoint)
+{
+	const FVector IntoWall = -Ledge.WallNormal;
 
-							if (bSphereTraceGotHit)
-							{
-								TopHits = SphereTraceHitOut;
-							}
-							else
-							{
-								if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.NotBusy")))
-								{
-									FVector SphereTrace2Start = TopHits.ImpactPoint + (WallRotationForward * 30);
-									FVector SphereTrace2End = TopHits.ImpactPoint;
-							
-									FHitResult SphereTrace2HitOut;
-									bool bSphereTrace2GotHit = SphereTrace(SphereTrace2HitOut, SphereTrace2Start, SphereTrace2End, 2.5f);
+	WallHitResult = FHitResult(EdgePoint + Ledge.WallNormal * 30, EdgePoint + IntoWall * 30);
+	WallHitResult.bBlockingHit = true;
+	WallHitResult.ImpactPoint = EdgePoint - FVector(0, 0, 4);
+	WallHitResult.Location = WallHitResult.ImpactPoint;
+	WallHitResult.ImpactNormal = Ledge.WallNormal;
+	WallHitResult.Normal = Ledge.WallNormal;
 
-									if (bSphereTrace2GotHit)
-									{
-										WallDepthResult = SphereTrace2HitOut;
+	if (ParkourState != EParkourState::Climb)
+	{
+		WallRotation = UParkourFunctionLibrary::NormalReverseRotationZ(WallHitResult.ImpactNormal);
+	}
 
-										FVector SphereTrace3Start = WallDepthResult.ImpactPoint + (WallRotationForward * 70);
-										FVector SphereTrace3End = SphereTrace3Start - FVector(0, 0, 200);
-							
-										FHitResult SphereTrace3HitOut;
-										bool bSphereTrace3GotHit = SphereTrace(SphereTrace3HitOut, SphereTrace3Start, SphereTrace3End, 10.0f);
+	const FVector TopPoint = EdgePoint + IntoWall * 2;
+	WallTopResult = FHitResult(TopPoint + FVector(0, 0, 7), TopPoint);
+	WallTopResult.bBlockingHit = true;
+	WallTopResult.ImpactPoint = TopPoint;
+	WallTopResult.Location = TopPoint + FVector(0, 0, 2.5f);
+	WallTopResult.ImpactNormal = FVector::UpVector;
+	WallTopResult.Normal = FVector::UpVector;
 
-										if (bSphereTrace3GotHit)
-										{
-											WallVaultResult = SphereTrace3HitOut;
-										}
-									}
-								}
-								break;
+	// A ledge without a far edge or a landing has none, whatever an earlier scan found.
+	WallDepthResult = FHitResult();
+	WallVaultResult = FHitResult();
+	if (Ledge.Depth > 0)
+	{
+		const FVector FarEdge = EdgePoint + IntoWall * Ledge.Depth;
+		WallDepthResult = FHitResult(FarEdge + IntoWall * 30, FarEdge);
+		WallDepthResult.bBlockingHit = true;
+		WallDepthResult.ImpactPoint = FarEdge;
+		WallDepthResult.Location = FarEdge;
+		WallDepthResult.ImpactNormal = IntoWall;
+		WallDepthResult.Normal = IntoWall;
+
+		if (Ledge.VaultHeight > 0)
+		{
+			const FVector LandingPoint = FarEdge + IntoWall * 70 - FVector(0, 0, Ledge.VaultHeight);
+			WallVaultResult = FHitResult(FarEdge + IntoWall * 70, FarEdge + IntoWall * 70 - FVector(0, 0, 200));
+			WallVaultResult.bBlockingHit = true;
+			WallVaultResult.ImpactPoint = LandingPoint;
+			WallVaultResult.Location = LandingPoint + FVector(0, 0, 10);
+			WallVaultResult.ImpactNormal = FVector::UpVector;
+			WallVaultResult.Normal = FVector::UpVector;
+		}
+	}
+}
+
+bool UParkourMovementComponent::FindBodyWallShape(const FHitResult& WallScanHit)
+{
+	if (ParkourState != EParkourState::NotBusy)
+	{
+		return false;
+	}
+
+#if PARKOUR_TRACE_RECORDING
+	// A replay only has the recorded query results and not the bodies behind them, so recorded scans trace everything.
+	if (FParkourTraceRecorder::IsRecording())
+	{
+		return false;
+	}
+#endif
+
+	const IParkourCollisionScene* Scene = CollisionScene ? CollisionScene : WorldCollisionScene.Get();
+	if (Scene == nullptr)
+	{
+		return false;
+	}
+	return FindTemplateWallShape(*Scene, WallScanHit) || FindSimpleCollisionWallShape(*Scene, WallScanHit);
+}
+
+bool UParkourMovementComponent::FindTemplateWallShape(const IParkourCollisionScene& Scene, const FHitResult& WallScanHit)
+{
+	if (bUseLedgeTemplates == false)
+	{
+		return false;
+	}
+
+	FTransform MeshTransform;
+	const UParkourLedgeTemplateUserData* Template = Scene.GetHitLedgeTemplate(WallScanHit, MeshTransform);
+
+	// Templates hold level tops, a tilted placement is left to the traces.
+	if (Template == nullptr || MeshTransform.GetUnitAxis(EAxis::Z).Z < ParkourLedgeTemplateMinUpZ)
+	{
+		return false;
+	}
+
+	TArray<FParkourLedge> PlacedLedges;
+	Template->TransformLedges(MeshTransform, PlacedLedges);
+
+	FParkourLedgeQuery Query;
+	Query.Location = GetScanActorLocation();
+	Query.Forward = GetScanActorForwardVector();
+	Query.MinTopZ = Query.Location.Z + ParkourSimpleLedgeMinHeight;
+	Query.MaxTopZ = Query.Location.Z + ParkourSimpleLedgeMaxHeight;
+
+	FVector EdgePoint;
+	const FParkourLedge* Ledge = Query.FindBest(PlacedLedges, EdgePoint);
+	if (Ledge == nullptr)
+	{
+		return false;
+	}
+
+	FParkourLedge PlacedLedge = *Ledge;
+	return ConfirmBodyLedge(PlacedLedge, EdgePoint);
+}
+
+bool UParkourMovementComponent::FindSimpleCollisionWallShape(const IParkourCollisionScene& Scene, const FHitResult& WallScanHit)
+{
+	FParkourCollisionElement Element;
+	if (bUseSimpleCollisionLedges == false || Scene.GetHitElement(WallScanHit, Element) == false)
+	{
+		return false;
+	}
+
+	const float ActorZ = GetScanActorLocation().Z;
+	FParkourLedge Ledge;
+	if (Element.ExtractLedge(WallScanHit.ImpactPoint, ActorZ + ParkourSimpleLedgeMaxHeight - WallScanHit.ImpactPoint.Z, ParkourSimpleLedgeMaxDepth, Ledge) == false)
+	{
+		return false;
+	}
+
+	if (Ledge.Start.Z < ActorZ + ParkourSimpleLedgeMinHeight)
+	{
+		return false;
+	}
+	return ConfirmBodyLedge(Ledge, Ledge.Start);
+}
+
+bool UParkourMovementComponent::ConfirmBodyLedge(FParkourLedge& Ledge, const FVector& EdgePoint)
+{
+	// The body knows nothing of its neighbours. Anything on the top or in front of the edge changes what
+	// the traces would find, so a sweep just above the top from the edge to the far edge has to stay clear.
+	const FVector IntoWall = -Ledge.WallNormal;
+	const FVector FarEdge = EdgePoint + (IntoWall * ((Ledge.Depth > 0) ? Ledge.Depth : ParkourSimpleLedgeMaxDepth));
+	FHitResult ClearanceHit;
+	if (SphereTrace(ClearanceHit, EdgePoint + (Ledge.WallNormal * 40) + FVector(0, 0, 5), FarEdge + FVector(0, 0, 5), 2.5f))
+	{
+		return false;
+	}
+
+	Ledge.VaultHeight = 0;
+	if (Ledge.Depth > 0)
+	{
+		// The top has to end at the far edge instead of carrying on over a neighbour.
+		FHitResult BeyondHit;
+		const FVector BeyondPoint = FarEdge + (IntoWall * 5);
+		if (SphereTrace(BeyondHit, BeyondPoint + FVector(0, 0, 3), BeyondPoint - FVector(0, 0, 7), 2.5f))
+		{
+			return false;
+		}
+
+		FHitResult LandingHit;
+		const FVector LandingTraceStart = FarEdge + (IntoWall * 70);
+		if (SphereTrace(LandingHit, LandingTraceStart, LandingTraceStart - FVector(0, 0, 200), 10.0f))
+		{
+			Ledge.VaultHeight = EdgePoint.Z - LandingHit.ImpactPoint.Z;
+		}
+	}
+
+	SetWallShapeFromLedge(Ledge, EdgePoint);
+	return true;
+}
+
+void UParkourMovementComponent::CheckWallShape()
+{
+	PARKOUR_SCOPE_CYCLE_COUNTER(CheckWallShape);
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::CheckWallShape);
+
+	if (PlayerCharacter == nullptr || CharacterMovement == nullptr)
+	{
+		return;
+	}	
+
+	// After FindBakedWallShape the scan already has a context, its sweeps count towards this scan.
+	FParkourScanContext OwnContext(PlayerCharacter->GetActorTransform());
+	FParkourScanContext& Context = ScanContext ? *ScanContext : OwnContext;
+	TGuardValue<FParkourScanContext*> ScanContextGuard(ScanContext, &Context);
+
+	TArray<FHitResult> 	WallHitTraces = TArray<FHitResult>();
+
+	TArray<FHitResult> HopHitTraces = TArray<FHitResult>();
+
+	FHitResult TopHits;
+
+	if (UWorld* World = GetWorld())
+	{
+		FHitResult TraceHitOut;
+		bool bFoundWall = (WallProbeMode == EParkourWallProbeMode::Hierarchical) ? ProbeWallRows(0, 15, FirstClimbHeight(), TraceHitOut) : ProbeWallGrid(TraceHitOut);
+
+		// A wall with a ledge template or simple collision gives its whole shape at once, the traces below are for the rest.
+		if (bFoundWall && FindBodyWallShape(TraceHitOut) == false)
+		{
+			int LastIndex3 = UParkourFunctionLibrary::SelectParkoutStateFloat(4, 0, 0, 2, ParkourState);
+			for (int Index3 = 0; Index3 <= LastIndex3; Index3++)
+			{						
+				FVector LineTraceStart;
+				FVector LineTraceEnd;
+				GetHopTrace(TraceHitOut, Index3, LineTraceStart, LineTraceEnd);
+
+				FHitResult LineTraceHitOut;
+				bool bLineTraceGotHit = LineTrace(LineTraceHitOut, LineTraceStart, LineTraceEnd);
+
+				HopHitTraces.Empty();
+				int LastIndex4 = UParkourFunctionLibrary::SelectParkoutStateFloat(30, 0, 0, 7, ParkourState);
+				for (int Index4 = 0; Index4 <= LastIndex4; Index4++)
+				{
+					FVector LineTrace2Start = LineTraceHitOut.TraceStart + FVector(0, 0, (Index4 * 8));
+					FVector LineTrace2End = LineTraceHitOut.TraceEnd + FVector(0, 0, (Index4 * 8));
+
+					FHitResult LineTrace2HitOut;
+					bool bLineTrace2GotHit = LineTrace(LineTrace2HitOut, LineTrace2Start, LineTrace2End);
+
+					HopHitTraces.Add(LineTrace2HitOut);
+				}
+
+				FHitResult LedgeTrace;
+				if (FindHopLedgeTrace(HopHitTraces, LedgeTrace))
+				{
+					WallHitTraces.Add(LedgeTrace);
+				}
+			}					
+			
+			SelectWallHitResult(WallHitTraces);
+
+			if (WallHitResult.bBlockingHit && WallHitResult.bStartPenetrating == false)
+			{
+				if (ParkourState != EParkourState::Climb)
+				{
+					WallRotation = UParkourFunctionLibrary::NormalReverseRotationZ(WallHitResult.ImpactNormal);
+				}
+
+				for (int Index5 = 0; Index5 <= 8; Index5++)
+				{
+					FVector WallRotationForward = UParkourFunctionLibrary::GetForwardVector(WallRotation);
+					FVector SphereTraceStart;
+					FVector SphereTraceEnd;
+					GetWallTopTrace(Index5, SphereTraceStart, SphereTraceEnd);
+					
+					FHitResult SphereTraceHitOut;
+					bool bSphereTraceGotHit = SphereTrace(SphereTraceHitOut, SphereTraceStart, SphereTraceEnd, 2.5f);
+
+					if (Index5 == 0)
+					{
+						if (bSphereTraceGotHit)
+						{
+							WallTopResult = SphereTraceHitOut;
+						}
+					}
+
+					if (bSphereTraceGotHit)
+					{
+						TopHits = SphereTraceHitOut;
+					}
+					else
+					{
+						if (ParkourState == EParkourState::NotBusy)
+						{
+							FVector SphereTrace2Start = TopHits.ImpactPoint + (WallRotationForward * 30);
+							FVector SphereTrace2End = TopHits.ImpactPoint;
+					
+							FHitResult SphereTrace2HitOut;
+							bool bSphereTrace2GotHit = SphereTrace(SphereTrace2HitOut, SphereTrace2Start, SphereTrace2End, 2.5f);
+
+							if (bSphereTrace2GotHit)
+							{
+								WallDepthResult = SphereTrace2HitOut;
+
+								FVector SphereTrace3Start = WallDepthResult.ImpactPoint + (WallRotationForward * 70);
+								FVector SphereTrace3End = SphereTrace3Start - FVector(0, 0, 200);
+					
+								FHitResult SphereTrace3HitOut;
+								bool bSphereTrace3GotHit = SphereTrace(SphereTrace3HitOut, SphereTrace3Start, SphereTrace3End, 10.0f);
+
+								if (bSphereTrace3GotHit)
+								{
+									WallVaultResult = SphereTrace3HitOut;
+								}
 							}
 						}
+						break;
 					}
-					break;
 				}
 			}
-			if (bShouldBreak)
+		}
+	}
+
+	FinishScanContext(Context);
+	ShowHitResults();
+}
+
+bool UParkourMovementComponent::ProbeWallGrid(FHitResult& OutHit)
+{
+	for (int Index = 0; Index <= 15; Index++)
+	{
+		for (int Index2 = 0; Index2 <= 11; Index2++)
+		{
+			FVector TraceStart;
+			FVector TraceEnd;
+			GetWallScanTrace(Index, Index2, FirstClimbHeight(), TraceStart, TraceEnd);
+
+			FHitResult TraceHitOut;
+			bool bTraceGotHit = SphereTrace(TraceHitOut, TraceStart, TraceEnd, 10);
+
+			if (TraceHitOut.bBlockingHit && TraceHitOut.bStartPenetrating == false)
 			{
+				OutHit = TraceHitOut;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool UParkourMovementComponent::ProbeWallRows(const int FirstRow, const int LastRow, const float ClimbHeight, FHitResult& OutHit)
+{
+	if (FirstRow == LastRow)
+	{
+		return ProbeWallRow(FirstRow, ClimbHeight, OutHit);
+	}
+
+	// A clean miss of the bounding box rules out the whole range, anything else (hit or start penetrating)
+	// is bisected until single rows are reached.
+	if (SweepWallRows(FirstRow, LastRow, ClimbHeight) == false)
+	{
+		return false;
+	}
+
+	const int MidRow = (FirstRow + LastRow) / 2;
+	return ProbeWallRows(FirstRow, MidRow, ClimbHeight, OutHit) || ProbeWallRows(MidRow + 1, LastRow, ClimbHeight, OutHit);
+}
+
+bool UParkourMovementComponent::SweepWallRows(const int FirstRow, const int LastRow, const float ClimbHeight)
+{
+	FVector BoxTraceStart;
+	FVector BoxTraceEnd;
+	FVector BoxHalfSize;
+	FQuat BoxRotation;
+	GetWallRowsBox(FirstRow, LastRow, ClimbHeight, BoxTraceStart, BoxTraceEnd, BoxHalfSize, BoxRotation);
+
+	FHitResult BoxTraceHit;
+	return BoxTrace(BoxTraceHit, BoxTraceStart, BoxTraceEnd, BoxHalfSize, BoxRotation);
+}
+
+void UParkourMovementComponent::GetWallRowsBox(const int FirstRow, const int LastRow, const float ClimbHeight, FVector& OutStart, FVector& OutEnd, FVector& OutHalfSize, FQuat& OutRotation)
+{
+	FVector FirstRowStart;
+	FVector FirstRowEnd;
+	FVector LastRowStart;
+	FVector LastRowEnd;
+	GetWallScanTrace(FirstRow, 11, ClimbHeight, FirstRowStart, FirstRowEnd);
+	GetWallScanTrace(LastRow, 11, ClimbHeight, LastRowStart, LastRowEnd);
+
+	OutStart = (FirstRowStart + LastRowStart) / 2;
+	OutEnd = (FirstRowEnd + LastRowEnd) / 2;
+	OutHalfSize = FVector(10, 10, ((LastRow - FirstRow) * 8) + 10);
+	OutRotation = FRotator(0, GetScanActorForwardVector().Rotation().Yaw, 0).Quaternion();
+}
+
+bool UParkourMovementComponent::ProbeWallRow(const int Index, const float ClimbHeight, FHitResult& OutHit)
+{
+	// The forward steps of a row share their start and are prefixes of the longest one, so the longest sweep
+	// reports the same first blocking impact as the shortest grid sweep that reaches it.
+	FVector TraceStart;
+	FVector TraceEnd;
+	GetWallScanTrace(Index, 11, ClimbHeight, TraceStart, TraceEnd);
+
+	FHitResult TraceHitOut;
+	bool bTraceGotHit = SphereTrace(TraceHitOut, TraceStart, TraceEnd, 10);
+
+	if (TraceHitOut.bBlockingHit && TraceHitOut.bStartPenetrating == false)
+	{
+		OutHit = TraceHitOut;
+		return true;
+	}
+	return false;
+}
+
+void UParkourMovementComponent::GetWallScanTrace(const int Index, const int Index2, const float ClimbHeight, FVector& OutStart, FVector& OutEnd)
+{
+	FVector Vector = (FVector(0, 0, Index * 16) + FVector(0, 0, ClimbHeight) + GetScanActorLocation());
+	OutStart = Vector + (GetScanActorForwardVector() * -20);
+	OutEnd = Vector + (GetScanActorForwardVector() * ((10 * Index2) + 10));
+}
+
+void UParkourMovementComponent::GetHopTrace(const FHitResult& WallScanHit, const int Index3, FVector& OutStart, FVector& OutEnd)
+{
+	float TargetZ = (ParkourState == EParkourState::Climb) ? 0.0f : -60.0f;
+	FVector Vector1 = FVector(0, 0, TargetZ);
+
+	TargetZ = (ParkourState == EParkourState::Climb) ? WallScanHit.ImpactPoint.Z : GetScanActorLocation().Z;
+	FVector Vector2 = FVector(WallScanHit.ImpactPoint.X, WallScanHit.ImpactPoint.Y, TargetZ);
+
+	float VectorMultiplier = (Index3 * 20) + UParkourFunctionLibrary::SelectParkoutStateFloat(-40, 0, 0, -20, ParkourState);
+	FRotator ReveresedImpactNormal = UParkourFunctionLibrary::NormalReverseRotationZ(WallScanHit.ImpactNormal);
+	FVector ReveresedImpactNormalForwardVector = UParkourFunctionLibrary::GetForwardVector(ReveresedImpactNormal);
+	FVector ReveresedImpactNormalRightVector = UParkourFunctionLibrary::GetRightVector(ReveresedImpactNormal);
+
+	FVector Vector3 = ReveresedImpactNormalRightVector * VectorMultiplier;
+	FVector Vector4 = ReveresedImpactNormalForwardVector * -40;
+	FVector Vector5 = ReveresedImpactNormalForwardVector * 30;
+
+	OutStart = Vector1 + Vector2 + Vector3 + Vector4;
+	OutEnd = Vector1 + Vector2 + Vector3 + Vector5;
+}
+
+bool UParkourMovementComponent::FindHopLedgeTrace(TConstArrayView<FHitResult> HopHitTraces, FHitResult& OutLedgeTrace)
+{
+	int LastIndex5 = HopHitTraces.Num();
+	for (int Index5 = 1; Index5 < LastIndex5; Index5++)
+	{
+		const FHitResult& HopHitResult = HopHitTraces[Index5];
+		const FHitResult& PrevHopHitResult = HopHitTraces[Index5 - 1];
+		float Distance = (HopHitResult.bBlockingHit) ? HopHitResult.Distance : FVector::Distance(HopHitResult.TraceStart, HopHitResult.TraceEnd);
+		float PrevDistance = (PrevHopHitResult.bBlockingHit) ? PrevHopHitResult.Distance : FVector::Distance(PrevHopHitResult.TraceStart, PrevHopHitResult.TraceEnd);
+
+		if ((Distance - PrevDistance) > 5.0f)
+		{
+			OutLedgeTrace = PrevHopHitResult;
+			return true;
+		}						
+	}
+	return false;
+}
+
+void UParkourMovementComponent::SelectWallHitResult(const TArray<FHitResult>& WallHitTraces)
+{
+	int LastIndex4 = WallHitTraces.Num();
+	for (int Index4 = 0; Index4 < LastIndex4; Index4++)
+	{
+		if (Index4 == 0)
+		{
+			WallHitResult = WallHitTraces[0];
+		}
+		else
+		{
+			float DistanceToWallHit = FVector::Distance(WallHitResult.ImpactPoint, GetScanActorLocation());
+			float Distance = FVector::Distance(WallHitTraces[Index4].ImpactPoint, GetScanActorLocation());
+
+			//Find shortest wall hit result
+			if (Distance <= DistanceToWallHit)
+			{
+				WallHitResult = WallHitTraces[Index4];
+			}
+		}
+	}
+}
+
+void UParkourMovementComponent::GetWallTopTrace(const int Index5, FVector& OutStart, FVector& OutEnd)
+{
+	FVector WallRotationForward = UParkourFunctionLibrary::GetForwardVector(WallRotation);
+	OutStart = WallHitResult.ImpactPoint + (WallRotationForward * (Index5 * 30)) + (WallRotationForward * 2.0f) + FVector(0, 0, 7);
+	OutEnd = OutStart - FVector(0, 0, 7);
+}
+
+void UParkourMovementComponent::BeginAsyncWallScan(const bool bAutoClimb)
+{
+	PARKOUR_SCOPE_CYCLE_COUNTER(CheckWallShape);
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::CheckWallShape);
+
+	if (PlayerCharacter == nullptr || CharacterMovement == nullptr)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		CheckWallShape();
+		CheckDistance();
+		ParkourType(bAutoClimb);
+		return;
+	}
+
+	if (AsyncTraceDelegate.IsBound() == false)
+	{
+		AsyncTraceDelegate.BindUObject(this, &UParkourMovementComponent::OnAsyncTraceDone);
+	}
+
+	bAsyncWallScanAutoClimb = bAutoClimb;
+	AsyncWallScanState = ParkourState;
+	AsyncWallScanContext = ScanContext ? *ScanContext : FParkourScanContext(PlayerCharacter->GetActorTransform());
+	TGuardValue<FParkourScanContext*> ScanContextGuard(ScanContext, &AsyncWallScanContext);
+	const float ClimbHeight = FirstClimbHeight();
+	AsyncTraceHandles.Reset();
+	AsyncTraceResults.Reset();
+	AsyncTracesPending = 0;
+	AsyncTopHits = FHitResult();
+
+	if (WallProbeMode == EParkourWallProbeMode::Hierarchical)
+	{
+		// Same coarse to fine order as ProbeWallRows, each answer decides the next query so only one is in flight.
+		AsyncWallScanStage = EParkourWallScanStage::Rows;
+		AsyncWallRowRanges.Reset();
+		AsyncWallRowRanges.Add(FIntPoint(0, 15));
+		IssueNextAsyncWallRows();
+		return;
+	}
+
+	AsyncWallScanStage = EParkourWallScanStage::Grid;
+	for (int Index = 0; Index <= 15; Index++)
+	{
+		for (int Index2 = 0; Index2 <= 11; Index2++)
+		{
+			FVector TraceStart;
+			FVector TraceEnd;
+			GetWallScanTrace(Index, Index2, ClimbHeight, TraceStart, TraceEnd);
+			AsyncSphereTrace(TraceStart, TraceEnd, 10);
+		}
+	}
+}
+
+void UParkourMovementComponent::AsyncLineTrace(const FVector& Start, const FVector& End)
+{
+	if (UWorld* World = GetWorld())
+	{
+		const uint32 Slot = AsyncTraceHandles.Num();
+		AsyncTraceResults.Add(FHitResult(Start, End));
+		AsyncTraceHandles.Add(World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECC_Visibility, TraceQueryParams, FCollisionResponseParams::DefaultResponseParam, &AsyncTraceDelegate, Slot));
+		AsyncTracesPending++;
+#if PARKOUR_TRACE_STATS
+		FParkourTraceStats::AddTrace(TraceCallSite);
+#endif
+		if (ScanContext)
+		{
+			ScanContext->QueriesIssued++;
+		}
+	}
+}
+
+void UParkourMovementComponent::AsyncSphereTrace(const FVector& Start, const FVector& End, const float Radius)
+{
+	if (UWorld* World = GetWorld())
+	{
+		const uint32 Slot = AsyncTraceHandles.Num();
+		AsyncTraceResults.Add(FHitResult(Start, End));
+		AsyncTraceHandles.Add(World->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeSphere(Radius), TraceQueryParams, FCollisionResponseParams::DefaultResponseParam, &AsyncTraceDelegate, Slot));
+		AsyncTracesPending++;
+#if PARKOUR_TRACE_STATS
+		FParkourTraceStats::AddTrace(TraceCallSite);
+#endif
+		if (ScanContext)
+		{
+			ScanContext->QueriesIssued++;
+		}
+	}
+}
+
+void UParkourMovementComponent::AsyncBoxTrace(const FVector& Start, const FVector& End, const FVector& HalfSize, const FQuat& Rotation)
+{
+	if (UWorld* World = GetWorld())
+	{
+		const uint32 Slot = AsyncTraceHandles.Num();
+		AsyncTraceResults.Add(FHitResult(Start, End));
+		AsyncTraceHandles.Add(World->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, Rotation, ECC_Visibility, FCollisionShape::MakeBox(HalfSize), TraceQueryParams, FCollisionResponseParams::DefaultResponseParam, &AsyncTraceDelegate, Slot));
+		AsyncTracesPending++;
+#if PARKOUR_TRACE_STATS
+		FParkourTraceStats::AddTrace(TraceCallSite);
+#endif
+		if (ScanContext)
+		{
+			ScanContext->QueriesIssued++;
+		}
+	}
+}
+
+void UParkourMovementComponent::IssueNextAsyncWallRows()
+{
+	if (AsyncWallRowRanges.Num() == 0)
+	{
+		return;
+	}
+
+	AsyncWallRowRange = AsyncWallRowRanges.Pop(false);
+	// BeginAsyncWallScan worked it out, FirstClimbHeight() would count a saved query for every range.
+	const float ClimbHeight = AsyncWallScanContext.ClimbHeight.GetValue();
+	FVector TraceStart;
+	FVector TraceEnd;
+	if (AsyncWallRowRange.X == AsyncWallRowRange.Y)
+	{
+		GetWallScanTrace(AsyncWallRowRange.X, 11, ClimbHeight, TraceStart, TraceEnd);
+		AsyncSphereTrace(TraceStart, TraceEnd, 10);
+	}
+	else
+	{
+		FVector BoxHalfSize;
+		FQuat BoxRotation;
+		GetWallRowsBox(AsyncWallRowRange.X, AsyncWallRowRange.Y, ClimbHeight, TraceStart, TraceEnd, BoxHalfSize, BoxRotation);
+		AsyncBoxTrace(TraceStart, TraceEnd, BoxHalfSize, BoxRotation);
+	}
+}
+
+void UParkourMovementComponent::OnAsyncTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const int Slot = TraceDatum.UserData;
+	if (AsyncWallScanStage == EParkourWallScanStage::None || AsyncTraceHandles.IsValidIndex(Slot) == false || AsyncTraceHandles[Slot] != TraceHandle)
+	{
+		// Result of a cancelled or superseded scan.
+		return;
+	}
+
+	if (TraceDatum.OutHits.Num() > 0)
+	{
+		AsyncTraceResults[Slot] = TraceDatum.OutHits[0];
+	}
+
+#if PARKOUR_TRACE_RECORDING || PARKOUR_DEBUG_DRAW
+	const FCollisionShape& AsyncShape = TraceDatum.CollisionParams.CollisionShape;
+	const bool bAsyncSphere = AsyncShape.IsSphere();
+	const bool bAsyncBox = AsyncShape.IsBox();
+	const FVector AsyncExtent = AsyncShape.GetExtent();
+#endif
+
+#if PARKOUR_TRACE_RECORDING
+	RecordTrace(bAsyncSphere ? EParkourTraceShape::Sphere : (bAsyncBox ? EParkourTraceShape::Box : EParkourTraceShape::Line), TraceDatum.Start, TraceDatum.End, AsyncExtent, TraceDatum.Rot, AsyncTraceResults[Slot].bBlockingHit, AsyncTraceResults[Slot]);
+#endif
+
+#if PARKOUR_DEBUG_DRAW
+	if (UParkourDebugSubsystem* DebugSubsystem = UParkourDebugSubsystem::Get(GetWorld(), 2))
+	{
+		DebugSubsystem->AddTrace(bAsyncSphere ? EParkourDebugShape::Sphere : (bAsyncBox ? EParkourDebugShape::Box : EParkourDebugShape::Line), TraceDatum.Start, TraceDatum.End, AsyncExtent, TraceDatum.Rot, AsyncTraceResults[Slot].bBlockingHit, AsyncTraceResults[Slot], FColor::Orange, FColor::Yellow);
+	}
+#endif
+
+	AsyncTracesPending--;
+	if (AsyncTracesPending <= 0)
+	{
+		AdvanceAsyncWallScan();
+	}
+}
+
+void UParkourMovementComponent::AdvanceAsyncWallScan()
+{
+	PARKOUR_SCOPE_CYCLE_COUNTER(CheckWallShape);
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::CheckWallShape);
+
+	if (IsValid(PlayerCharacter) == false || ParkourState != AsyncWallScanState || ParkourActionTag != ParkourTags::Action_NoAction)
+	{
+		CancelAsyncWallScan();
+		return;
+	}
+
+	// The async scan keeps the character transform it started from for every stage.
+	TGuardValue<FParkourScanContext*> ScanContextGuard(ScanContext, &AsyncWallScanContext);
+
+	// Results of the stage that just completed, in the order they were issued.
+	TArray<FHitResult> StageResults = MoveTemp(AsyncTraceResults);
+	AsyncTraceHandles.Reset();
+	AsyncTraceResults.Reset();
+	AsyncTracesPending = 0;
+
+	bool bFoundWallHit = false;
+	if (AsyncWallScanStage == EParkourWallScanStage::Grid)
+	{
+		for (const FHitResult& TraceHitOut : StageResults)
+		{
+			if (TraceHitOut.bBlockingHit && TraceHitOut.bStartPenetrating == false)
+			{
+				AsyncWallScanHit = TraceHitOut;
+				bFoundWallHit = true;
+				break;
+			}
+		}
+	}
+	else if (AsyncWallScanStage == EParkourWallScanStage::Rows)
+	{
+		if (StageResults.Num() > 0 && StageResults[0].bBlockingHit)
+		{
+			if (AsyncWallRowRange.X == AsyncWallRowRange.Y)
+			{
+				if (StageResults[0].bStartPenetrating == false)
+				{
+					AsyncWallScanHit = StageResults[0];
+					bFoundWallHit = true;
+				}
+			}
+			else
+			{
+				// The lower half goes on top, so it is probed first like in ProbeWallRows.
+				const int MidRow = (AsyncWallRowRange.X + AsyncWallRowRange.Y) / 2;
+				AsyncWallRowRanges.Add(FIntPoint(MidRow + 1, AsyncWallRowRange.Y));
+				AsyncWallRowRanges.Add(FIntPoint(AsyncWallRowRange.X, MidRow));
+			}
+		}
+
+		if (bFoundWallHit == false)
+		{
+			IssueNextAsyncWallRows();
+		}
+	}
+	else if (AsyncWallScanStage == EParkourWallScanStage::Hop)
+	{
+		TArray<FHitResult> WallHitTraces = TArray<FHitResult>();
+		int HopTraceCount = UParkourFunctionLibrary::SelectParkoutStateFloat(30, 0, 0, 7, ParkourState) + 1;
+		for (int Offset = 0; HopTraceCount > 0 && Offset + HopTraceCount <= StageResults.Num(); Offset += HopTraceCount)
+		{
+			FHitResult LedgeTrace;
+			if (FindHopLedgeTrace(MakeArrayView(StageResults.GetData() + Offset, HopTraceCount), LedgeTrace))
+			{
+				WallHitTraces.Add(LedgeTrace);
+			}
+		}
+
+		SelectWallHitResult(WallHitTraces);
+
+		if (WallHitResult.bBlockingHit && WallHitResult.bStartPenetrating == false)
+		{
+			if (ParkourState != EParkourState::Climb)
+			{
+				WallRotation = UParkourFunctionLibrary::NormalReverseRotationZ(WallHitResult.ImpactNormal);
+			}
+
+			AsyncWallScanStage = EParkourWallScanStage::Top;
+			for (int Index5 = 0; Index5 <= 8; Index5++)
+			{
+				FVector SphereTraceStart;
+				FVector SphereTraceEnd;
+				GetWallTopTrace(Index5, SphereTraceStart, SphereTraceEnd);
+				AsyncSphereTrace(SphereTraceStart, SphereTraceEnd, 2.5f);
+			}
+		}
+	}
+	else if (AsyncWallScanStage == EParkourWallScanStage::Top)
+	{
+		for (int Index5 = 0; Index5 < StageResults.Num(); Index5++)
+		{
+			const FHitResult& SphereTraceHitOut = StageResults[Index5];
+			if (Index5 == 0 && SphereTraceHitOut.bBlockingHit)
+			{
+				WallTopResult = SphereTraceHitOut;
+			}
+
+			if (SphereTraceHitOut.bBlockingHit)
+			{
+				AsyncTopHits = SphereTraceHitOut;
+			}
+			else
+			{
+				if (ParkourState == EParkourState::NotBusy)
+				{
+					AsyncWallScanStage = EParkourWallScanStage::Depth;
+					AsyncSphereTrace(AsyncTopHits.ImpactPoint + (UParkourFunctionLibrary::GetForwardVector(WallRotation) * 30), AsyncTopHits.ImpactPoint, 2.5f);
+				}
 				break;
 			}
 		}
 	}
+	else if (AsyncWallScanStage == EParkourWallScanStage::Depth)
+	{
+		if (StageResults.Num() > 0 && StageResults[0].bBlockingHit)
+		{
+			WallDepthResult = StageResults[0];
+
+			FVector SphereTrace3Start = WallDepthResult.ImpactPoint + (UParkourFunctionLibrary::GetForwardVector(WallRotation) * 70);
+			AsyncWallScanStage = EParkourWallScanStage::Vault;
+			AsyncSphereTrace(SphereTrace3Start, SphereTrace3Start - FVector(0, 0, 200), 10.0f);
+		}
+	}
+	else if (AsyncWallScanStage == EParkourWallScanStage::Vault)
+	{
+		if (StageResults.Num() > 0 && StageResults[0].bBlockingHit)
+		{
+			WallVaultResult = StageResults[0];
+		}
+	}
+
+	if (bFoundWallHit && FindBodyWallShape(AsyncWallScanHit) == false)
+	{
+		AsyncWallScanStage = EParkourWallScanStage::Hop;
+
+		int LastIndex3 = UParkourFunctionLibrary::SelectParkoutStateFloat(4, 0, 0, 2, ParkourState);
+		int LastIndex4 = UParkourFunctionLibrary::SelectParkoutStateFloat(30, 0, 0, 7, ParkourState);
+		for (int Index3 = 0; Index3 <= LastIndex3; Index3++)
+		{
+			FVector LineTraceStart;
+			FVector LineTraceEnd;
+			GetHopTrace(AsyncWallScanHit, Index3, LineTraceStart, LineTraceEnd);
+			for (int Index4 = 0; Index4 <= LastIndex4; Index4++)
+			{
+				AsyncLineTrace(LineTraceStart + FVector(0, 0, (Index4 * 8)), LineTraceEnd + FVector(0, 0, (Index4 * 8)));
+			}
+		}
+
+		if (AsyncTracesPending == 0)
+		{
+			// No hop traces in this state, resolve the hop stage straight away.
+			AdvanceAsyncWallScan();
+			return;
+		}
+	}
+
+	// Nothing was issued for a next stage, so the scan is complete.
+	if (AsyncTracesPending == 0)
+	{
+		FinishAsyncWallScan();
+	}
+}
+
+void UParkourMovementComponent::FinishAsyncWallScan()
+{
+	const bool bAutoClimb = bAsyncWallScanAutoClimb;
+	CancelAsyncWallScan();
+	FinishScanContext(AsyncWallScanContext);
 
 	ShowHitResults();
+	CheckDistance();
+	ParkourType(bAutoClimb);
+#if PARKOUR_TRACE_RECORDING
+	EndRecordedScan();
+#endif
+}
+
+void UParkourMovementComponent::CancelAsyncWallScan()
+{
+	AsyncWallScanStage = EParkourWallScanStage::None;
+	AsyncTraceHandles.Reset();
+	AsyncTraceResults.Reset();
+	AsyncTracesPending = 0;
+	AsyncWallRowRanges.Reset();
+}
+
+void UParkourMovementComponent::FinishScanContext(const FParkourScanContext& Context)
+{
+	LastScanQueriesIssued = Context.QueriesIssued;
+	LastScanQueriesSaved = Context.QueriesSaved;
+	UE_LOG(LogParkour, Verbose, TEXT("%s wall scan: %d queries issued, %d saved by the scan context"), *GetNameSafe(GetOwner()), LastScanQueriesIssued, LastScanQueriesSaved);
+}
+
+void UParkourMovementComponent::GetLastScanQueryCounts(int& OutQueriesIssued, int& OutQueriesSaved) const
+{
+	OutQueriesIssued = LastScanQueriesIssued;
+	OutQueriesSaved = LastScanQueriesSaved;
+}
+
+FVector UParkourMovementComponent::GetScanActorLocation() const
+{
+	return ScanContext ? ScanContext->ActorLocation : PlayerCharacter->GetActorLocation();
+}
+
+FVector UParkourMovementComponent::GetScanActorForwardVector() const
+{
+	return ScanContext ? ScanContext->ActorForwardVector : PlayerCharacter->GetActorForwardVector();
+}
+
+void UParkourMovementComponent::BuildTraceQueryParams()
+{
+	TraceQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(ParkourTrace), false, PlayerCharacter);
+	WorldCollisionScene = MakeUnique<FParkourWorldCollisionScene>(GetWorld(), TraceQueryParams);
 }
 
 void UParkourMovementComponent::ShowHitResults()
 {
+#if PARKOUR_DEBUG_DRAW
 	if (bShowHitResults)
 	{
-		if (UWorld* World = GetWorld())
+		if (UParkourDebugSubsystem* DebugSubsystem = UParkourDebugSubsystem::Get(GetWorld()))
 		{
-			DrawDebugSphere(World, WallTopResult.ImpactPoint, 5, 12, FColor::Blue, false, 1.0f);
-			DrawDebugSphere(World, WallDepthResult.ImpactPoint, 5, 12, FColor::Red, false, 1.0f);
-			DrawDebugSphere(World, WallVaultResult.ImpactPoint, 5, 12, FColor::Green, false, 1.0f);
+			DebugSubsystem->AddShape(EParkourDebugShape::Sphere, WallTopResult.ImpactPoint, WallTopResult.ImpactPoint, FVector(5), FQuat::Identity, FColor::Blue);
+			DebugSubsystem->AddShape(EParkourDebugShape::Sphere, WallDepthResult.ImpactPoint, WallDepthResult.ImpactPoint, FVector(5), FQuat::Identity, FColor::Red);
+			DebugSubsystem->AddShape(EParkourDebugShape::Sphere, WallVaultResult.ImpactPoint, WallVaultResult.ImpactPoint, FVector(5), FQuat::Identity, FColor::Green);
 		}
 	}
+#endif
 }
 
 void UParkourMovementComponent::CheckDistance()
@@ -442,22 +1613,25 @@ void UParkourMovementComponent::CheckDistance()
 
 void UParkourMovementComponent::AutoClimb()
 {
-	float ClimbStyleZOffset = (ClimbStyleTag == FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced"))) ? 50 : 2;
-	float ClimbZOffset = (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Climb"))) ? ClimbStyleZOffset : 0;
+	PARKOUR_SCOPE_CYCLE_COUNTER(AutoClimb);
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::AutoClimb);
+
+	float ClimbStyleZOffset = (ClimbStyle == EParkourClimbStyle::Braced) ? 50 : 2;
+	float ClimbZOffset = (ParkourState == EParkourState::Climb) ? ClimbStyleZOffset : 0;
 	FVector BoxTraceStart = CharacterMesh->GetSocketLocation(FName("root")) + FVector(0, 0, ClimbZOffset);
 	FHitResult BoxTraceHit;
-	bInGround = BoxTrace(BoxTraceHit, BoxTraceStart, BoxTraceStart, FVector(10, 10, 4));
+	bInGround = BoxTrace(BoxTraceHit, BoxTraceStart, BoxTraceStart, FVector(10, 10, 4), FQuat::Identity);
 
 	if (bInGround == false)
 	{
-		if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.NotBusy")))
+		if (ParkourState == EParkourState::NotBusy && ShouldRunAirborneScan())
 		{
 			ParkourAction(true);
 		}
 	}
 	else
 	{
-		if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction")))
+		if (ParkourActionTag == ParkourTags::Action_NoAction)
 		{
 			bCanAutoClimb = true;
 			bCanManualClimb = true;
@@ -466,13 +1640,54 @@ void UParkourMovementComponent::AutoClimb()
 	}
 }
 
+bool UParkourMovementComponent::ShouldRunAirborneScan()
+{
+	// Nothing to save when ParkourAction would not scan anyway.
+	if (bCanAutoClimb == false || ParkourActionTag != ParkourTags::Action_NoAction || AsyncWallScanStage != EParkourWallScanStage::None)
+	{
+		return false;
+	}
+
+	if (bUseAirbornePreCheck == false || PlayerCharacter == nullptr || CharacterMovement == nullptr)
+	{
+		return true;
+	}
+
+	// The baked database answers without tracing.
+	if (bUseBakedLedges)
+	{
+		if (UParkourLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UParkourLedgeSubsystem>())
+		{
+			if (LedgeSubsystem->IsCovered(PlayerCharacter->GetActorLocation()))
+			{
+				return true;
+			}
+		}
+	}
+
+	// Everything the NotBusy wall rows can touch: 16 rows from -60 to +180 swept from 20 behind to 120 ahead
+	// with a 10 radius sphere. Nothing in this box means the scan cannot find a wall.
+	const FVector ScanBoxHalfSize = FVector(85, 15, 135);
+	const FVector ScanBoxOffset = FVector(50, 0, 60);
+
+	const float LookAheadTime = FMath::Max(AirborneLookAheadTime, 0.0f);
+	const FVector Velocity = CharacterMovement->Velocity;
+	const FVector FallOffset = (Velocity * LookAheadTime) + FVector(0, 0, 0.5f * CharacterMovement->GetGravityZ() * FMath::Square(LookAheadTime));
+
+	const FQuat YawRotation = FRotator(0, PlayerCharacter->GetActorRotation().Yaw, 0).Quaternion();
+	const FVector BoxStart = PlayerCharacter->GetActorLocation() + YawRotation.RotateVector(ScanBoxOffset);
+
+	FHitResult BoxTraceHit;
+	return BoxTrace(BoxTraceHit, BoxStart, BoxStart + FallOffset, ScanBoxHalfSize, YawRotation);
+}
+
 void UParkourMovementComponent::ParkourDrop()
 {
 	if (bInGround == false)
 	{
-		if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Climb")))
+		if (ParkourState == EParkourState::Climb)
 		{
-			SetParkourState(FGameplayTag::RequestGameplayTag(FName("Parkour.State.NotBusy")));
+			SetParkourState(EParkourState::NotBusy);
 			bCanAutoClimb = false;
 			bCanManualClimb = false;
 
@@ -488,7 +1703,7 @@ void UParkourMovementComponent::ParkourDrop()
 	}
 	else
 	{
-		if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.NotBusy")))
+		if (ParkourState == EParkourState::NotBusy)
 		{
 			FindDropDownHangLocation();
 		}
@@ -497,9 +1712,11 @@ void UParkourMovementComponent::ParkourDrop()
 
 void UParkourMovementComponent::ParkourType(const bool bAutoClimb)
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(ParkourType);
+
 	if (WallTopResult.bBlockingHit)
 	{
-		if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.NotBusy")))
+		if (ParkourState == EParkourState::NotBusy)
 		{
 			if (bInGround)
 			{
@@ -572,13 +1789,13 @@ void UParkourMovementComponent::ParkourType(const bool bAutoClimb)
 						{
 							if (WallHeight > 0 && WallHeight <= 44)
 							{
-								SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction")));
+								SetParkourAction(ParkourTags::Action_NoAction);
 							}
 							else
 							{
 								if (WallHeight > 250)
 								{
-									SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction")));
+									SetParkourAction(ParkourTags::Action_NoAction);
 								}
 								else
 								{
@@ -594,15 +1811,15 @@ void UParkourMovementComponent::ParkourType(const bool bAutoClimb)
 				ClimbSurface();
 			}
 		}
-		else if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Climb")))
+		else if (ParkourState == EParkourState::Climb)
 		{
 			CheckClimbOrHop();
 		}
 	}
 	else
 	{
-		SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction")));
-		if (bAutoClimb == false)
+		SetParkourAction(ParkourTags::Action_NoAction);
+		if (bAutoClimb == false && bEvaluatingScan == false)
 		{
 			PlayerCharacter->Jump();
 		}
@@ -617,24 +1834,24 @@ void UParkourMovementComponent::ClimbSurface()
 		GetClimbedLedgeHitResult();
 		if (CheckAirHang())
 		{
-			if (ClimbStyleTag == FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced")))
+			if (ClimbStyle == EParkourClimbStyle::Braced)
 			{
-				SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.FallingBraced")));
+				SetParkourAction(ParkourTags::Action_FallingBraced);
 			}
 			else
 			{
-				SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.FallingFreeHang")));
+				SetParkourAction(ParkourTags::Action_FallingFreeHang);
 			}
 		}
 		else
 		{
-			if (ClimbStyleTag == FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced")))
+			if (ClimbStyle == EParkourClimbStyle::Braced)
 			{
-				SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.Climb")));
+				SetParkourAction(ParkourTags::Action_Climb);
 			}
 			else
 			{
-				SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.FreeHangClimb")));
+				SetParkourAction(ParkourTags::Action_FreeHangClimb);
 			}
 		}
 	}
@@ -644,11 +1861,11 @@ void UParkourMovementComponent::CheckSurfaceAndSetActionAsHighVault()
 {
 	if (CheckVaultSurface())
 	{
-		SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.HighVault")));
+		SetParkourAction(ParkourTags::Action_HighVault);
 	}
 	else
 	{
-		SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction")));
+		SetParkourAction(ParkourTags::Action_NoAction);
 	}
 }
 
@@ -656,11 +1873,11 @@ void UParkourMovementComponent::CheckSurfaceAndSetActionAsLowMantle()
 {
 	if (CheckMantleSurface())
 	{
-		SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.LowMantle")));
+		SetParkourAction(ParkourTags::Action_LowMantle);
 	}
 	else
 	{
-		SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction")));
+		SetParkourAction(ParkourTags::Action_NoAction);
 	}
 }
 
@@ -668,11 +1885,11 @@ void UParkourMovementComponent::CheckSurfaceAndSetActionAsMantle()
 {
 	if (CheckMantleSurface())
 	{
-		SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.Mantle")));
+		SetParkourAction(ParkourTags::Action_Mantle);
 	}
 	else
 	{
-		SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction")));
+		SetParkourAction(ParkourTags::Action_NoAction);
 	}
 }
 
@@ -680,11 +1897,11 @@ void UParkourMovementComponent::CheckSurfaceAndSetActionAsVault()
 {
 	if (CheckVaultSurface())
 	{
-		SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.Vault")));
+		SetParkourAction(ParkourTags::Action_Vault);
 	}
 	else
 	{
-		SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction")));
+		SetParkourAction(ParkourTags::Action_NoAction);
 	}
 }
 
@@ -692,19 +1909,32 @@ void UParkourMovementComponent::CheckSurfaceAndSetActionAsThinVault()
 {
 	if (CheckVaultSurface())
 	{
-		SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.ThinVault")));
+		SetParkourAction(ParkourTags::Action_ThinVault);
 	}
 	else
 	{
-		SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction")));
+		SetParkourAction(ParkourTags::Action_NoAction);
 	}
 }
 
 void UParkourMovementComponent::SetParkourAction(FGameplayTag NewParkourActionTag)
 {
+	if (bEvaluatingScan)
+	{
+		// An evaluation only reports the decision, the character never acts on it.
+		EvaluatedAction = NewParkourActionTag;
+		return;
+	}
+
+	PARKOUR_SCOPE_CYCLE_COUNTER(MontageSelection);
+
+	// Drop downs start without a parkour attempt.
+	PreloadActionMontages();
+
 	if (ParkourActionTag != NewParkourActionTag)
 	{
 		ParkourActionTag = NewParkourActionTag;
+		ClimbTracker.Reset();
 		if (CharacterAnimInstance)
 		{
 			if (UClass* AnimClass = CharacterAnimInstance->GetClass())
@@ -715,62 +1945,14 @@ void UParkourMovementComponent::SetParkourAction(FGameplayTag NewParkourActionTa
 				}
 			}
 
-			if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction")))
+			if (ParkourActionTag == ParkourTags::Action_NoAction)
 			{
 				ParkourVariablesDataAsset = nullptr;
 				ResetParkourResult();
 			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.ThinVault")))
-			{
-				ParkourVariablesDataAsset = ThinVaultDataAsset;
-			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.HighVault")))
-			{
-				ParkourVariablesDataAsset = HighVaultDataAsset;
-			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.Vault")))
-			{
-				ParkourVariablesDataAsset = VaultDataAsset;
-			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.Mantle")))
-			{
-				ParkourVariablesDataAsset = MantleDataAsset;
-			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.LowMantle")))
-			{
-				ParkourVariablesDataAsset = LowMantleDataAsset;
-			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.Climb")))
+			else if (UParkourVariablesDataAsset* ActionDataAsset = ActionDataAssets.FindRef(ParkourActionTag))
 			{
-				ParkourVariablesDataAsset = BracedClimbDataAsset;
-			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.FreeHangClimb")))
-			{
-				ParkourVariablesDataAsset = FreeHangClimbDataAsset;
-			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.ClimbingUp")))
-			{
-				ParkourVariablesDataAsset = BracedClimbUpDataAsset;
-			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.FreeHangClimbUp")))
-			{
-				ParkourVariablesDataAsset = FreeHangClimbUpDataAsset;
-			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.FallingBraced")))
-			{
-				ParkourVariablesDataAsset = FallingBracedDataAsset;
-			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.FallingFreeHang")))
-			{
-				ParkourVariablesDataAsset = FallingFreeHangDataAsset;
-			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.DropDown")))
-			{
-				ParkourVariablesDataAsset = DropDownDataAsset;
-			}
-			else if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.FreeHangDropDown")))
-			{
-				ParkourVariablesDataAsset = FreeHangDropDownDataAsset;
+				ParkourVariablesDataAsset = ActionDataAsset;
 			}
 
 			PlayParkourMontage();
@@ -778,114 +1960,147 @@ void UParkourMovementComponent::SetParkourAction(FGameplayTag NewParkourActionTa
 	}
 }
 
-void UParkourMovementComponent::SetParkourState(FGameplayTag NewParkourStateTag)
+void UParkourMovementComponent::SetParkourState(const EParkourState NewParkourState)
 {
-	if (ParkourStateTag != NewParkourStateTag)
+	if (NewParkourState >= EParkourState::Count)
+	{
+		UE_LOG(LogParkour, Warning, TEXT("%s: ignoring a parkour state outside Parkour.State."), *GetNameSafe(GetOwner()));
+		return;
+	}
+
+	if (ParkourState != NewParkourState)
 	{
-		PreviousState(ParkourStateTag, NewParkourStateTag);
-		ParkourStateTag = NewParkourStateTag;
+		PreviousState(ParkourState, NewParkourState);
+		ParkourState = NewParkourState;
+		ClimbTracker.Reset();
+		bClimbInputPending = false;
+		UpdateTickInterval();
+		WakeUp();
 		if (CharacterAnimInstance)
 		{
 			if (UClass* AnimClass = CharacterAnimInstance->GetClass())
 			{
 				if (AnimClass->ImplementsInterface(UParkourABPInterface::StaticClass()))
 				{
-					IParkourABPInterface::Execute_SetParkourState(Cast<UObject>(CharacterAnimInstance), ParkourStateTag);
+					IParkourABPInterface::Execute_SetParkourState(Cast<UObject>(CharacterAnimInstance), ParkourTags::FromState(ParkourState));
 				}
 			}
 
-			if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.NotBusy")))
-			{
-				ParkourStateSettings(ECollisionEnabled::QueryAndPhysics, MOVE_Walking, FRotator(0, 500, 0), true, false);
-			}
-			else if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Mantle")))
-			{
-				ParkourStateSettings(ECollisionEnabled::NoCollision, MOVE_Flying, FRotator(0, 500, 0), true, false);
-			}
-			else if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Vault")))
-			{
-				ParkourStateSettings(ECollisionEnabled::NoCollision, MOVE_Flying, FRotator(0, 500, 0), true, false);
-			}
-			else if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Climb")))
-			{
-				ParkourStateSettings(ECollisionEnabled::NoCollision, MOVE_Flying, FRotator::ZeroRotator, true, true);
-			}
-			else if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.ReachLedge")))
-			{
-				ParkourStateSettings(ECollisionEnabled::NoCollision, MOVE_Flying, FRotator(0, 500, 0), true, false);
-			}
+			const FParkourStateSettings& Settings = ParkourStateSettingsTable[(int)ParkourState];
+			ParkourStateSettings(Settings.CollisionType, Settings.MovementMode, Settings.RotationRate, Settings.bDoCollisionTest, Settings.bStopMovementImmediately);
 		}
 	}
 }
 
-void UParkourMovementComponent::PreviousState(FGameplayTag PreviousParkourStateTag, FGameplayTag NewParkourStateTag)
+void UParkourMovementComponent::PreviousState(const EParkourState PreviousParkourState, const EParkourState NewParkourState)
 {
-	if (PreviousParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.NotBusy")))
-	{
-		if (NewParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.NotBusy")))
-		{
-			
-		}
-		else if (NewParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Mantle")))
-		{
-			
-		}
-		else if (NewParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.ReachLedge")))
-		{
-			
-		}
-	}
-	else if (PreviousParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Climb")))
+	if (ParkourStateTransitionTable[(int)PreviousParkourState][(int)NewParkourState] == false)
 	{
-		
+		UE_LOG(LogParkour, Verbose, TEXT("%s: unexpected parkour state transition %s -> %s."), *GetNameSafe(GetOwner()), *ParkourTags::FromState(PreviousParkourState).ToString(), *ParkourTags::FromState(NewParkourState).ToString());
 	}
 }
 
-void UParkourMovementComponent::SetClimbStyle(FGameplayTag NewClimbStyle)
+void UParkourMovementComponent::SetClimbStyle(const EParkourClimbStyle NewClimbStyle)
 {
-	if (ClimbStyleTag != NewClimbStyle)
+	if (ClimbStyle != NewClimbStyle)
 	{
-		ClimbStyleTag = NewClimbStyle;
-		if (CharacterAnimInstance)
+		ClimbStyle = NewClimbStyle;
+		if (CharacterAnimInstance && bEvaluatingScan == false)
 		{
 			if (UClass* AnimClass = CharacterAnimInstance->GetClass())
 			{
 				if (AnimClass->ImplementsInterface(UParkourABPInterface::StaticClass()))
 				{
-					IParkourABPInterface::Execute_SetClimbStyle(Cast<UObject>(CharacterAnimInstance), ClimbStyleTag);
+					IParkourABPInterface::Execute_SetClimbStyle(Cast<UObject>(CharacterAnimInstance), ParkourTags::FromClimbStyle(ClimbStyle));
 				}
 			}
 		}
 	}
 }
 
-void UParkourMovementComponent::SetClimbDirection(const FGameplayTag NewDirection)
+void UParkourMovementComponent::SetClimbDirection(const EParkourDirection NewDirection)
 {
-	if (ClimbDirectionTag != NewDirection)
+	if (ClimbDirection != NewDirection)
 	{
-		ClimbDirectionTag = NewDirection;
+		ClimbDirection = NewDirection;
 		if (CharacterAnimInstance)
 		{
 			if (UClass* AnimClass = CharacterAnimInstance->GetClass())
 			{
 				if (AnimClass->ImplementsInterface(UParkourABPInterface::StaticClass()))
 				{
-					IParkourABPInterface::Execute_SetClimbMovement(Cast<UObject>(CharacterAnimInstance), ClimbDirectionTag);
+					IParkourABPInterface::Execute_SetClimbMovement(Cast<UObject>(CharacterAnimInstance), ParkourTags::FromDirection(ClimbDirection));
 				}
 			}
 		}
 	}
 }
 
-void UParkourMovementComponent::ClimbMovement()
+void UParkourMovementComponent::UpdateClimbMovement(const float DeltaTime)
+{
+	if (bClimbInputPending == false)
+	{
+		return;
+	}
+	bClimbInputPending = false;
+
+	if (ParkourState == EParkourState::Climb)
+	{
+		if (CharacterAnimInstance)
+		{
+			if (CharacterAnimInstance->IsAnyMontagePlaying())
+			{
+				StopClimbMovement();
+			}
+			else
+			{
+				ClimbMovement(DeltaTime);
+			}
+		}
+	}
+}
+
+void UParkourMovementComponent::ClimbMovement(const float DeltaTime)
 {
-	if (ParkourActionTag != FGameplayTag::RequestGameplayTag(FName("Parkour.Action.CornerMove")))
+	PARKOUR_SCOPE_CYCLE_COUNTER(ClimbMovement);
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::ClimbMovement);
+
+	if (ParkourActionTag != ParkourTags::Action_CornerMove)
 	{
 		if (FMath::Abs(GetHorizontalAxis()) > 0.7f)
 		{
-			FGameplayTag ClimbDir = GetHorizontalAxis() > 0 ? FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Right")) : FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Left"));
+			EParkourDirection ClimbDir = GetHorizontalAxis() > 0 ? EParkourDirection::Right : EParkourDirection::Left;
 			SetClimbDirection(ClimbDir);
 
+			// Between confirmations the character slides along the confirmed stretch of ledge without tracing.
+			if (CanAdvanceAlongClimbLedge())
+			{
+				MoveAlongClimbLedge(DeltaTime);
+				return;
+			}
+
+			FHitResult TrackedWallHit;
+			FHitResult TrackedTopHit;
+			if (ConfirmClimbLedge(TrackedWallHit, TrackedTopHit))
+			{
+				// CheckClimbMovementSurface looks a little ahead of the hands, so it only has to be repeated every few cm of travel.
+				const bool bSurfaceCheckDue = ClimbTracker.SurfaceCheckDirection != FMath::Sign(GetHorizontalAxis())
+					|| FVector::DistSquared(TrackedWallHit.ImpactPoint, ClimbTracker.SurfaceCheckLocation) >= FMath::Square(ParkourClimbTrackerSurfaceCheckDistance)
+					|| FVector::DotProduct(TrackedWallHit.ImpactNormal, ClimbTracker.WallNormal) < ParkourClimbTrackerSameWallDot;
+
+				if (bSurfaceCheckDue == false || CheckClimbMovementSurface(TrackedWallHit))
+				{
+					UpdateClimbTracker(TrackedWallHit, TrackedTopHit, ClimbTracker.WallRow, ClimbTracker.ClearRow, bSurfaceCheckDue);
+					MoveAlongClimbLedge(DeltaTime);
+				}
+				else
+				{
+					StopClimbMovement();
+				}
+				return;
+			}
+
+			ClimbTracker.Reset();
 			for (int Index = 0; Index <= 2; Index++)
 			{
 				bool bBreakLoop = false;
@@ -926,28 +2141,8 @@ void UParkourMovementComponent::ClimbMovement()
 											{
 												if (CheckClimbMovementSurface(SphereTraceHit))
 												{
-													WallRotation = UParkourFunctionLibrary::NormalReverseRotationZ(SphereTraceHit.ImpactNormal);
-													float ClimbStyleOffset = (ClimbStyleTag == FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced"))) ? -44 : -7;
-													FVector DirectionVector = SphereTraceHit.ImpactPoint + (UParkourFunctionLibrary::GetForwardVector(UParkourFunctionLibrary::NormalReverseRotationZ(SphereTraceHit.ImpactNormal)) * ClimbStyleOffset);
-
-													float InterpSpeed = (ClimbStyleTag == FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced"))) ? 2.7f : 1.8f;
-
-													float TargetX = DirectionVector.X;
-													TargetX = UKismetMathLibrary::FInterpTo(PlayerCharacter->GetActorLocation().X, TargetX, GetWorld()->DeltaTimeSeconds, InterpSpeed);
-
-													float TargetY = DirectionVector.Y;
-													TargetY = UKismetMathLibrary::FInterpTo(PlayerCharacter->GetActorLocation().Y, TargetY, GetWorld()->DeltaTimeSeconds, GetClimbMoveSpeed());
-
-													float ClimbStyleOffset2 = (ClimbStyleTag == FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced"))) ? 107 : 115;
-													float TargetZ = SphereTrace2Hit.ImpactPoint.Z - ClimbStyleOffset2 + CharacterHeightDifference;
-													TargetZ = UKismetMathLibrary::FInterpTo(PlayerCharacter->GetActorLocation().Z, TargetZ, GetWorld()->DeltaTimeSeconds, InterpSpeed);
-
-													FVector TargetLocation = FVector(TargetX, TargetY, TargetZ);
-
-													FRotator TargetRotation = UKismetMathLibrary::RInterpTo(PlayerCharacter->GetActorRotation(), WallRotation, GetWorld()->DeltaTimeSeconds, 4.0f);
-													PlayerCharacter->SetActorLocationAndRotation(TargetLocation, TargetRotation);
-													
-													bFirstClimbMove = true;
+													UpdateClimbTracker(SphereTraceHit, SphereTrace2Hit, Index, Index3, true);
+													MoveAlongClimbLedge(DeltaTime);
 												}
 												else
 												{
@@ -982,6 +2177,102 @@ void UParkourMovementComponent::ClimbMovement()
 	}
 }
 
+void UParkourMovementComponent::MoveAlongClimbLedge(const float DeltaTime)
+{
+	// The steady speed the character used to reach while interpolating towards a point ClimbMoveCheckDistance ahead.
+	const float ClimbSpeed = ClimbMoveCheckDistance * GetClimbMoveSpeed() * FMath::Abs(GetHorizontalAxis());
+	ClimbTracker.Offset = FMath::Min(ClimbTracker.Offset + (ClimbSpeed * DeltaTime), ClimbTracker.GetSegmentLength());
+
+	FRotator TargetRotation = UKismetMathLibrary::RInterpTo(PlayerCharacter->GetActorRotation(), WallRotation, DeltaTime, 4.0f);
+	FVector TargetLocation = ClimbTracker.GetHandPoint() + GetClimbHangOffset(TargetRotation);
+	PlayerCharacter->SetActorLocationAndRotation(TargetLocation, TargetRotation);
+	
+	bFirstClimbMove = true;
+}
+
+bool UParkourMovementComponent::CanAdvanceAlongClimbLedge()
+{
+	if (ClimbTracker.IsValid() == false || CVarParkourClimbTracker.GetValueOnGameThread() == 0)
+	{
+		return false;
+	}
+
+	return ClimbTracker.Direction == FMath::Sign(GetHorizontalAxis()) && ClimbTracker.GetSegmentLength() - ClimbTracker.Offset > ParkourClimbTrackerReconfirmDistance;
+}
+
+FVector UParkourMovementComponent::GetClimbHangOffset(const FRotator& Rotation) const
+{
+	float WallOffset = (ClimbStyle == EParkourClimbStyle::Braced) ? -44 : -7;
+	float HeightOffset = (ClimbStyle == EParkourClimbStyle::Braced) ? 107 : 115;
+	return (UParkourFunctionLibrary::GetForwardVector(Rotation) * WallOffset) + FVector(0, 0, CharacterHeightDifference - HeightOffset);
+}
+
+
+bool UParkourMovementComponent::ConfirmClimbLedge(FHitResult& OutWallHit, FHitResult& OutTopHit)
+{
+	if (ClimbTracker.IsValid() == false || CVarParkourClimbTracker.GetValueOnGameThread() == 0 || Arrow == nullptr)
+	{
+		return false;
+	}
+
+	// The forward sweep of the row that found the wall last time.
+	const FVector ArrowForwardVector = UParkourFunctionLibrary::GetForwardVector(Arrow->GetComponentRotation());
+	const FVector ArrowRightVector = UParkourFunctionLibrary::GetRightVector(Arrow->GetComponentRotation());
+	const FVector TraceStart = FVector(0, 0, ClimbTracker.WallRow * -10) + Arrow->GetComponentLocation() + (ArrowRightVector * (GetHorizontalAxis() * ClimbMoveCheckDistance));
+	const FVector TraceEnd = TraceStart + (ArrowForwardVector * 60);
+	if (SphereTrace(OutWallHit, TraceStart, TraceEnd, 5.0f) == false || OutWallHit.bStartPenetrating)
+	{
+		return false;
+	}
+
+	// Turning a corner is left to the full search.
+	if (FVector::DotProduct(OutWallHit.ImpactNormal, ClimbTracker.WallNormal) < ParkourClimbTrackerMinWallDot)
+	{
+		return false;
+	}
+
+	// One sweep down onto the ledge from just above where it was, instead of stepping up to it from the wall.
+	const FRotator HitWallRotation = UParkourFunctionLibrary::NormalReverseRotationZ(OutWallHit.ImpactNormal);
+	const FVector TopStart = FVector(OutWallHit.ImpactPoint.X, OutWallHit.ImpactPoint.Y, ClimbTracker.LedgePoint.Z + ParkourClimbTrackerMaxStep) + (UParkourFunctionLibrary::GetForwardVector(HitWallRotation) * 2);
+	const FVector TopEnd = TopStart - FVector(0, 0, ParkourClimbTrackerMaxStep * 2);
+	if (SphereTrace(OutTopHit, TopStart, TopEnd, 2.5f) == false || OutTopHit.bStartPenetrating)
+	{
+		return false;
+	}
+
+	// Any open side line lets the full search move on, the one that was open last time is the likeliest.
+	const FVector SideStart = FVector(0, 0, ClimbTracker.ClearRow * 5) + OutTopHit.ImpactPoint + FVector(0, 0, 2);
+	const FVector SideEnd = SideStart + (UParkourFunctionLibrary::GetRightVector(HitWallRotation) * 15 * GetHorizontalAxis());
+	FHitResult SideHit;
+	return LineTrace(SideHit, SideStart, SideEnd) == false;
+}
+
+void UParkourMovementComponent::UpdateClimbTracker(const FHitResult& WallHit, const FHitResult& TopHit, const int WallRow, const int ClearRow, const bool bSurfaceChecked)
+{
+	// A new segment starts where the hands are, on the old segment or under the hands of the hanging character.
+	const FVector HandPoint = ClimbTracker.IsValid() ? ClimbTracker.GetHandPoint() : PlayerCharacter->GetActorLocation() - GetClimbHangOffset(PlayerCharacter->GetActorRotation());
+
+	WallRotation = UParkourFunctionLibrary::NormalReverseRotationZ(WallHit.ImpactNormal);
+	ClimbTracker.bValid = true;
+	ClimbTracker.WallRow = WallRow;
+	ClimbTracker.ClearRow = ClearRow;
+	ClimbTracker.LedgePoint = FVector(WallHit.ImpactPoint.X, WallHit.ImpactPoint.Y, TopHit.ImpactPoint.Z);
+	ClimbTracker.SegmentStart = HandPoint;
+	ClimbTracker.Offset = 0;
+	ClimbTracker.Direction = FMath::Sign(GetHorizontalAxis());
+	ClimbTracker.WallNormal = WallHit.ImpactNormal;
+	if (bSurfaceChecked)
+	{
+		ClimbTracker.SurfaceCheckLocation = WallHit.ImpactPoint;
+		ClimbTracker.SurfaceCheckDirection = FMath::Sign(GetHorizontalAxis());
+	}
+
+	// Keep the held ledge current for the hop and air hang checks.
+	ClimbedLedgeHitResult = WallHit;
+	ClimbedLedgeHitResult.Location = TopHit.Location;
+	ClimbedLedgeHitResult.ImpactPoint = ClimbTracker.LedgePoint;
+}
+
 bool UParkourMovementComponent::CheckClimbMovementSurface(FHitResult HitResult)
 {
 	FVector Vector = HitResult.ImpactPoint + (UParkourFunctionLibrary::GetRightVector(Arrow->GetComponentRotation()) * GetHorizontalAxis() * 13) + FVector(0, 0, -90);
@@ -989,7 +2280,7 @@ bool UParkourMovementComponent::CheckClimbMovementSurface(FHitResult HitResult)
 	FVector TraceEnd = Vector + (UParkourFunctionLibrary::GetForwardVector(Arrow->GetComponentRotation()) * -25);
 
 	FHitResult TraceHitResult;
-	float HalfHeight = (ClimbStyleTag == FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced"))) ? 50.0f : 82.0f;
+	float HalfHeight = (ClimbStyle == EParkourClimbStyle::Braced) ? 50.0f : 82.0f;
 
 	bool bGotHit = CapsuleTrace(TraceHitResult, TraceStart, TraceEnd, 5.0f, HalfHeight, EDrawDebugTrace::ForDuration);
 
@@ -1001,7 +2292,7 @@ float UParkourMovementComponent::GetClimbMoveSpeed()
 	float MoveSpeed = 0;
 	if (CharacterAnimInstance)
 	{
-		if (ClimbStyleTag == FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced")))
+		if (ClimbStyle == EParkourClimbStyle::Braced)
 		{
 			MoveSpeed = FMath::Clamp(CharacterAnimInstance->GetCurveValue(FName("Climb Move Speed")), 1.0f, 98.0f) * 0.05f;
 		}
@@ -1018,12 +2309,14 @@ void UParkourMovementComponent::StopClimbMovement()
 	if (CharacterMovement)
 	{
 		CharacterMovement->StopMovementImmediately();
-		SetClimbDirection(FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.NoDirection")));
+		SetClimbDirection(EParkourDirection::NoDirection);
 	}
 }
 
 bool UParkourMovementComponent::CheckMantleSurface()
 {
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::SurfaceCheck);
+
 	bool bCapsuleTraceGotHit = false;
 	if (UWorld* World = GetWorld())
 	{
@@ -1039,6 +2332,8 @@ bool UParkourMovementComponent::CheckMantleSurface()
 
 bool UParkourMovementComponent::CheckVaultSurface()
 {
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::SurfaceCheck);
+
 	bool bCapsuleTraceGotHit = false;
 	if (UWorld* World = GetWorld())
 	{
@@ -1054,6 +2349,8 @@ bool UParkourMovementComponent::CheckVaultSurface()
 
 bool UParkourMovementComponent::CheckClimbSurface()
 {
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::SurfaceCheck);
+
 	bool bCapsuleTraceGotHit = false;
 	if (UWorld* World = GetWorld())
 	{
@@ -1069,6 +2366,8 @@ bool UParkourMovementComponent::CheckClimbSurface()
 
 void UParkourMovementComponent::CheckClimbStyle()
 {	
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::SurfaceCheck);
+
 	if (UWorld* World = GetWorld())
 	{
 		FVector SphereTraceStart = WallTopResult.ImpactPoint + (UParkourFunctionLibrary::GetForwardVector(WallRotation) * -10) + FVector(0, 0, -125);
@@ -1079,11 +2378,11 @@ void UParkourMovementComponent::CheckClimbStyle()
 
 		if (bSphereTraceGotHit)
 		{
-			SetClimbStyle(FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced")));
+			SetClimbStyle(EParkourClimbStyle::Braced);
 		}
 		else
 		{
-			SetClimbStyle(FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.FreeHang")));
+			SetClimbStyle(EParkourClimbStyle::FreeHang);
 		}
 	}
 }
@@ -1092,19 +2391,21 @@ void UParkourMovementComponent::CheckClimbOrHop()
 {
 	if (CheckMantleSurface())
 	{
-		if (ClimbStyleTag == FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced")))
+		if (ClimbStyle == EParkourClimbStyle::Braced)
 		{
-			SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.ClimbingUp")));
+			SetParkourAction(ParkourTags::Action_ClimbingUp);
 		}
 		else
 		{			
-			SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.FreeHangClimbUp")));
+			SetParkourAction(ParkourTags::Action_FreeHangClimbUp);
 		}
 	}
 }
 
 void UParkourMovementComponent::GetClimbedLedgeHitResult()
 {
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::SurfaceCheck);
+
 	if (UWorld* World = GetWorld())
 	{
 		FVector SphereTraceStart = WallHitResult.ImpactPoint + (UParkourFunctionLibrary::GetForwardVector(UParkourFunctionLibrary::NormalReverseRotationZ(WallHitResult.ImpactNormal)) * -30);
@@ -1156,18 +2457,26 @@ void UParkourMovementComponent::PlayParkourMontage()
 {	
 	if (CharacterMotionWarping && ParkourVariablesDataAsset)
 	{	
-		SetParkourState(ParkourVariablesDataAsset->ParkourInState);
+		SetParkourState(ParkourTags::ToState(ParkourVariablesDataAsset->ParkourInState));
 		CharacterMotionWarping->AddOrUpdateWarpTargetFromLocationAndRotation(FName("Warp 1"), FindWarpTargetLocation_1(ParkourVariablesDataAsset->Warp1XOffset, ParkourVariablesDataAsset->Warp1ZOffset), WallRotation);
 		CharacterMotionWarping->AddOrUpdateWarpTargetFromLocationAndRotation(FName("Warp 2"), FindWarpTargetLocation_2(ParkourVariablesDataAsset->Warp2XOffset, ParkourVariablesDataAsset->Warp2ZOffset), WallRotation);
 		CharacterMotionWarping->AddOrUpdateWarpTargetFromLocationAndRotation(FName("Warp 3"), FindWarpTargetLocation_3(ParkourVariablesDataAsset->Warp3XOffset, ParkourVariablesDataAsset->Warp3ZOffset), WallRotation);
 		CharacterMotionWarping->AddOrUpdateWarpTargetFromLocationAndRotation(FName("Warp 4"), FindWarpTargetLocation_4(ParkourVariablesDataAsset->Warp2XOffset, ParkourVariablesDataAsset->Warp2ZOffset), WallRotation);
 		CharacterMotionWarping->AddOrUpdateWarpTargetFromLocationAndRotation(FName("Warp 5"), FindWarpTargetLocation_1(ParkourVariablesDataAsset->Warp2XOffset, ParkourVariablesDataAsset->Warp2ZOffset), WallRotation);
 
-		if (CharacterAnimInstance && ParkourVariablesDataAsset->ParkourMontage)
+		UAnimMontage* ParkourMontage = ParkourVariablesDataAsset->ParkourMontage.Get();
+		if (ParkourMontage == nullptr && ParkourVariablesDataAsset->ParkourMontage.IsNull() == false)
 		{
-			CharacterAnimInstance->Montage_Play(ParkourVariablesDataAsset->ParkourMontage, 1.0f, EMontagePlayReturnType::MontageLength, GetMontageStartTime());
-			CharacterAnimInstance->Montage_GetBlendingOutDelegate(ParkourVariablesDataAsset->ParkourMontage)->BindUFunction(this, FName("OnMontageBlendOut"));
-			MontageBlendOutState = ParkourVariablesDataAsset->ParkourOutState;
+			// Only happens when the action is used before the preload finished, or was never registered.
+			UE_LOG(LogParkour, Warning, TEXT("%s was not preloaded, loading it now."), *ParkourVariablesDataAsset->ParkourMontage.ToString());
+			ParkourMontage = ParkourVariablesDataAsset->ParkourMontage.LoadSynchronous();
+		}
+
+		if (CharacterAnimInstance && ParkourMontage)
+		{
+			CharacterAnimInstance->Montage_Play(ParkourMontage, 1.0f, EMontagePlayReturnType::MontageLength, GetMontageStartTime());
+			CharacterAnimInstance->Montage_GetBlendingOutDelegate(ParkourMontage)->BindUFunction(this, FName("OnMontageBlendOut"));
+			MontageBlendOutState = ParkourTags::ToState(ParkourVariablesDataAsset->ParkourOutState);
 		}
 	}
 }
@@ -1175,13 +2484,13 @@ void UParkourMovementComponent::PlayParkourMontage()
 void UParkourMovementComponent::OnMontageBlendOut(UAnimMontage* Montage, bool bInterrupted)
 {
 	SetParkourState(MontageBlendOutState);
-	SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.NoAction")));
+	SetParkourAction(ParkourTags::Action_NoAction);
 }
 
 float UParkourMovementComponent::GetMontageStartTime()
 {
 	float MontageStartTime = ParkourVariablesDataAsset->MontageStartPosition;
-	if (ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.Climb")) || ParkourActionTag == FGameplayTag::RequestGameplayTag(FName("Parkour.Action.FreeHangClimb")))
+	if (ParkourActionTag == ParkourTags::Action_Climb || ParkourActionTag == ParkourTags::Action_FreeHangClimb)
 	{
 		if (bInGround == false)
 		{
@@ -1208,6 +2517,8 @@ FVector UParkourMovementComponent::FindWarpTargetLocation_3(const float WarpXOff
 
 FVector UParkourMovementComponent::FindWarpTargetLocation_4(const float WarpXOffset, const float WarpZOffset)
 {
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::SurfaceCheck);
+
 	if (UWorld* World = GetWorld())
 	{
 		FVector SphereTraceStart = WallTopResult.ImpactPoint + (UParkourFunctionLibrary::GetForwardVector(WallRotation) * WarpXOffset) + FVector(0, 0, 40);
@@ -1227,20 +2538,44 @@ FVector UParkourMovementComponent::FindWarpTargetLocation_4(const float WarpXOff
 
 float UParkourMovementComponent::FirstClimbHeight()
 {
+	if (ScanContext && ScanContext->ClimbHeight.IsSet())
+	{
+		ScanContext->QueriesSaved += ScanContext->ClimbHeightQueries;
+		return ScanContext->ClimbHeight.GetValue();
+	}
+
+	const int QueriesBefore = ScanContext ? ScanContext->QueriesIssued : 0;
+	const float ClimbHeight = CalculateFirstClimbHeight();
+	if (ScanContext)
+	{
+		ScanContext->ClimbHeight = ClimbHeight;
+		ScanContext->ClimbHeightQueries = ScanContext->QueriesIssued - QueriesBefore;
+	}
+	return ClimbHeight;
+}
+
+float UParkourMovementComponent::CalculateFirstClimbHeight()
+{
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::FirstClimbHeight);
+
 	float ClimbHeight = 0;
-	if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.Climb")))
+	if (ParkourState == EParkourState::Climb)
 	{
-		for (int Index = 0; Index <= 4; Index++)
+		FVector HandRLocation = CharacterMesh->GetSocketLocation(FName("hand_r"));
+		FVector HandLLocation = CharacterMesh->GetSocketLocation(FName("hand_l"));
+		float HandZ = (HandRLocation.Z < HandLLocation.Z) ? HandLLocation.Z : HandRLocation.Z;
+		if (ReplayedScan)
 		{
-			FVector HandRLocation = CharacterMesh->GetSocketLocation(FName("hand_r"));
-			FVector HandLLocation = CharacterMesh->GetSocketLocation(FName("hand_l"));
-			float HandZ = (HandRLocation.Z < HandLLocation.Z) ? HandLLocation.Z : HandRLocation.Z;
+			HandZ = ReplayedScan->Snapshot.HandZ;
+		}
 
-			FVector Vector1 = FVector(PlayerCharacter->GetActorLocation().X, PlayerCharacter->GetActorLocation().Y, HandZ - CharacterHeightDifference - CharacterHandUpDifference);
+		for (int Index = 0; Index <= 4; Index++)
+		{
+			FVector Vector1 = FVector(GetScanActorLocation().X, GetScanActorLocation().Y, HandZ - CharacterHeightDifference - CharacterHandUpDifference);
 
 			FHitResult SphereTraceHit;
-			FVector TraceStart = Vector1 + (PlayerCharacter->GetActorForwardVector() * -20);
-			FVector TraceEnd = Vector1 + (PlayerCharacter->GetActorForwardVector() * Index * 20);
+			FVector TraceStart = Vector1 + (GetScanActorForwardVector() * -20);
+			FVector TraceEnd = Vector1 + (GetScanActorForwardVector() * Index * 20);
 
 			bool bTraceGotHit = SphereTrace(SphereTraceHit, TraceStart, TraceEnd, 5, EDrawDebugTrace::ForDuration);
 			if (SphereTraceHit.bBlockingHit)
@@ -1259,7 +2594,7 @@ float UParkourMovementComponent::FirstClimbHeight()
 						break;
 					}
 				}
-				return (ClimbHeight - PlayerCharacter->GetActorLocation().Z - 4);
+				return (ClimbHeight - GetScanActorLocation().Z - 4);
 			}
 		}
 
@@ -1296,62 +2631,62 @@ FRotator UParkourMovementComponent::GetDesiredRotation()
 	}
 }
 
-FGameplayTag UParkourMovementComponent::GetDesiredClimbRotation()
+EParkourDirection UParkourMovementComponent::GetDesiredClimbRotation()
 {
-	FGameplayTag DesiredDirection;
+	EParkourDirection DesiredDirection;
 
 	float RotZ = GetVerticalAxis();
 	float RotY = GetHorizontalAxis();
 
 	if ((RotZ >= 0.5f && RotZ <= 1.0f) && (RotY >= -0.5f && RotY <= 0.5f))
 	{
-		DesiredDirection = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Forward"));
+		DesiredDirection = EParkourDirection::Forward;
 	}
 	else 
 	{
 		if ((RotZ >= -0.5f && RotZ <= 0.5f) && (RotY >= 0.5f && RotY <= 1.0f))
 		{
-			DesiredDirection = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Right"));
+			DesiredDirection = EParkourDirection::Right;
 		}
 		else 
 		{
 			if ((RotZ >= -0.5f && RotZ <= 0.5f) && (RotY >= -1.0f && RotY <= -0.5f))
 			{
-				DesiredDirection = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Left"));
+				DesiredDirection = EParkourDirection::Left;
 			}
 			else 
 			{
 				if ((RotZ >= -1.0f && RotZ <= -0.5f) && (RotY >= -0.5f && RotY <= 0.5f))
 				{
-					DesiredDirection = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Backward"));
+					DesiredDirection = EParkourDirection::Backward;
 				}
 				else 
 				{
 					if ((RotZ >= 0.5f && RotZ <= 1.0f) && (RotY >= 0.5f && RotY <= 1.0f))
 					{
-						DesiredDirection = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.ForwardRight"));
+						DesiredDirection = EParkourDirection::ForwardRight;
 					}
 					else 
 					{
 						if ((RotZ >= 0.5f && RotZ <= 1.0f) && (RotY >= -1.0f && RotY <= -0.5f))
 						{
-							DesiredDirection = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.ForwardLeft"));
+							DesiredDirection = EParkourDirection::ForwardLeft;
 						}
 						else 
 						{
 							if ((RotZ >= -1.0f && RotZ <= -0.5f) && (RotY >= 0.5f && RotY <= 1.0f))
 							{
-								DesiredDirection = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.BackwardRight"));
+								DesiredDirection = EParkourDirection::BackwardRight;
 							}
 							else 
 							{
 								if ((RotZ >= -1.0f && RotZ <= -0.5f) && (RotY >= -1.0f && RotY <= -0.5f))
 								{
-									DesiredDirection = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.BackwardLeft"));
+									DesiredDirection = EParkourDirection::BackwardLeft;
 								}
 								else
 								{
-									DesiredDirection = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Forward"));
+									DesiredDirection = EParkourDirection::Forward;
 								}
 							}
 						}
@@ -1366,6 +2701,9 @@ FGameplayTag UParkourMovementComponent::GetDesiredClimbRotation()
 
 void UParkourMovementComponent::FindDropDownHangLocation()
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(FindDropDownHangLocation);
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::FindDropDownHangLocation);
+
 	FVector TraceStart = PlayerCharacter->GetActorLocation();
 	FVector TraceEnd = PlayerCharacter->GetActorLocation() - FVector(0, 0, 120);
 
@@ -1457,13 +2795,13 @@ void UParkourMovementComponent::FindDropDownHangLocation()
 					{
 						CheckClimbStyle();
 						GetClimbedLedgeHitResult();
-						if (ClimbStyleTag == FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced")))
+						if (ClimbStyle == EParkourClimbStyle::Braced)
 						{
-							SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.DropDown")));
+							SetParkourAction(ParkourTags::Action_DropDown);
 						}
 						else
 						{
-							SetParkourAction(FGameplayTag::RequestGameplayTag(FName("Parkour.Action.FreeHangDropDown")));
+							SetParkourAction(ParkourTags::Action_FreeHangDropDown);
 						}
 					}
 					else
@@ -1519,7 +2857,18 @@ void UParkourMovementComponent::ParkourStateSettings(ECollisionEnabled::Type New
 	if (CharacterCapsule && CharacterMovement && CharacterCameraBoom)
 	{
 		CharacterCapsule->SetCollisionEnabled(NewType);
-		CharacterMovement->SetMovementMode(NewMovementMode);
+		if (NewMovementMode != MOVE_Custom)
+		{
+			CharacterMovement->SetMovementMode(NewMovementMode);
+		}
+		else if (CharacterMovement->IsA<UParkourCharacterMovementComponent>())
+		{
+			CharacterMovement->SetMovementMode(MOVE_Custom, (uint8)EParkourCustomMovementMode::Climb);
+		}
+		else
+		{
+			CharacterMovement->SetMovementMode(MOVE_Flying);
+		}
 		CharacterMovement->RotationRate = RotationRate;
 		if (bStopMovementImmediately)
 		{
@@ -1531,11 +2880,14 @@ void UParkourMovementComponent::ParkourStateSettings(ECollisionEnabled::Type New
 
 void UParkourMovementComponent::LimbsClimbIK(bool bFirst, bool bIsLeft)
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(LimbsClimbIK);
+	TGuardValue<EParkourTraceCallSite> CallSiteGuard(TraceCallSite, EParkourTraceCallSite::LimbsClimbIK);
+
 	int LimbDir = bIsLeft ? -1 : 1;
 	if (bFirst == false)
 	{
 		FHitResult LedgeHitResult = ClimbedLedgeHitResult;
-		if (ParkourStateTag == FGameplayTag::RequestGameplayTag(FName("Parkour.State.ReachLedge")))
+		if (ParkourState == EParkourState::ReachLedge)
 		{
 			if (LedgeHitResult.bBlockingHit)
 			{
@@ -1578,7 +2930,7 @@ void UParkourMovementComponent::LimbsClimbIK(bool bFirst, bool bIsLeft)
 											{
 												if (AnimClass->ImplementsInterface(UParkourABPInterface::StaticClass()))
 												{
-													float Offset = (ClimbStyleTag == FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced"))) ? CharacterHandFrontDifference : 0;
+													float Offset = (ClimbStyle == EParkourClimbStyle::Braced) ? CharacterHandFrontDifference : 0;
 													FVector Vector = SphereTraceHitOut.ImpactPoint + (ReversedImpactNormalForward * (-3 + Offset));
 													float TargetHandZ = SphereTrace2HitOut.ImpactPoint.Z + CharacterHeightDifference + CharacterHandUpDifference - 9;
 
@@ -1642,7 +2994,7 @@ void UParkourMovementComponent::LimbsClimbIK(bool bFirst, bool bIsLeft)
 
 
 		//Legs Location...
-		if (ClimbStyleTag == FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced")))
+		if (ClimbStyle == EParkourClimbStyle::Braced)
 		{
 			for (int Index = 0; Index <= 2; Index++)
 			{
@@ -1742,63 +3094,216 @@ void UParkourMovementComponent::ResetMovement()
 {
 	ForwardValue = 0;
 	RightValue = 0;
-	SetClimbDirection(FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.NoDirection")));
+	SetClimbDirection(EParkourDirection::NoDirection);
 }
 
 bool UParkourMovementComponent::LineTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, EDrawDebugTrace::Type DrawDebugType /*= EDrawDebugTrace::None*/)
+{
+	PARKOUR_SCOPE_CYCLE_COUNTER(LineTrace);
+
+	return QueryCollisionScene(EParkourTraceShape::Line, Start, End, FVector::ZeroVector, FQuat::Identity, OutHit, DrawDebugType, FColor::Red, FColor::Green);
+}
+
+bool UParkourMovementComponent::SphereTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const float Radius, EDrawDebugTrace::Type DrawDebugType /*= EDrawDebugTrace::None*/)
+{
+	PARKOUR_SCOPE_CYCLE_COUNTER(SphereTrace);
+
+	return QueryCollisionScene(EParkourTraceShape::Sphere, Start, End, FVector(Radius), FQuat::Identity, OutHit, DrawDebugType, FColor::Blue, FColor::Yellow);
+}
+
+bool UParkourMovementComponent::CapsuleTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const float Radius, const float HalfHeight, EDrawDebugTrace::Type DrawDebugType /*= EDrawDebugTrace::None*/)
+{
+	PARKOUR_SCOPE_CYCLE_COUNTER(CapsuleTrace);
+
+	return QueryCollisionScene(EParkourTraceShape::Capsule, Start, End, FVector(Radius, Radius, HalfHeight), FQuat::Identity, OutHit, DrawDebugType, FColor::Red, FColor::Green);
+}
+
+bool UParkourMovementComponent::BoxTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const FVector& HalfSize, const FQuat& Rotation, EDrawDebugTrace::Type DrawDebugType /*= EDrawDebugTrace::None*/)
+{
+	PARKOUR_SCOPE_CYCLE_COUNTER(BoxTrace);
+
+	return QueryCollisionScene(EParkourTraceShape::Box, Start, End, HalfSize, Rotation, OutHit, DrawDebugType, FColor::Red, FColor::Green);
+}
+
+bool UParkourMovementComponent::QueryCollisionScene(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, FHitResult& OutHit, EDrawDebugTrace::Type DrawDebugType, const FColor& TraceColor, const FColor& HitColor)
 {
 	bool bTraceGotHit = false;
-	if (UWorld* World = GetWorld())
+	if (const IParkourCollisionScene* Scene = CollisionScene ? CollisionScene : WorldCollisionScene.Get())
 	{
-		FCollisionQueryParams LineTraceParams = FCollisionQueryParams();
-		LineTraceParams.bTraceComplex = false;
-		LineTraceParams.AddIgnoredActor(PlayerCharacter);
-		bTraceGotHit = World->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, LineTraceParams);
-		DrawDebugLineTraceSingle(World, Start, End, DrawDebugType, bTraceGotHit, OutHit, FColor::Red, FColor::Green, 1.0f);
+		bTraceGotHit = Scene->Sweep(Shape, Start, End, Extent, Rotation, OutHit);
+#if PARKOUR_DEBUG_DRAW
+		if (UParkourDebugSubsystem* DebugSubsystem = UParkourDebugSubsystem::Get(GetWorld(), (DrawDebugType == EDrawDebugTrace::None) ? 2 : 1))
+		{
+			static const EParkourDebugShape DebugShapes[] = { EParkourDebugShape::Line, EParkourDebugShape::Sphere, EParkourDebugShape::Capsule, EParkourDebugShape::Box };
+			DebugSubsystem->AddTrace(DebugShapes[(uint8)Shape], Start, End, Extent, Rotation, bTraceGotHit, OutHit, TraceColor, HitColor);
+		}
+#endif
+#if PARKOUR_TRACE_RECORDING
+		RecordTrace(Shape, Start, End, Extent, Rotation, bTraceGotHit, OutHit);
+#endif
+#if PARKOUR_TRACE_STATS
+		FParkourTraceStats::AddTrace(TraceCallSite);
+#endif
+		if (ScanContext)
+		{
+			ScanContext->QueriesIssued++;
+		}
 	}
 	return bTraceGotHit;
 }
 
-bool UParkourMovementComponent::SphereTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const float Radius, EDrawDebugTrace::Type DrawDebugType /*= EDrawDebugTrace::None*/)
+void UParkourMovementComponent::SetCollisionScene(const IParkourCollisionScene* Scene)
 {
-	bool bSphereTraceGotHit = false;
-	if (UWorld* World = GetWorld())
-	{
-		FCollisionQueryParams SphereParams = FCollisionQueryParams();
-		SphereParams.bTraceComplex = false;
-		SphereParams.AddIgnoredActor(PlayerCharacter);
-		bSphereTraceGotHit = World->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeSphere(Radius), SphereParams);
-		DrawDebugSphereTraceSingle(World, Start, End, Radius, DrawDebugType, bSphereTraceGotHit, OutHit, FColor::Blue, FColor::Yellow, 1.0f);
-	}
-	return bSphereTraceGotHit;
+	CancelAsyncWallScan();
+	CollisionScene = Scene;
 }
 
-bool UParkourMovementComponent::CapsuleTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const float Radius, const float HalfHeight, EDrawDebugTrace::Type DrawDebugType /*= EDrawDebugTrace::None*/)
+void UParkourMovementComponent::RecordTrace(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, const bool bHit, const FHitResult& Hit)
 {
-	bool bCapsuleTraceGotHit = false;
-	if (UWorld* World = GetWorld())
+	if (FParkourTraceRecorder::IsRecording() && bEvaluatingScan == false)
 	{
-		FCollisionQueryParams CapsuleParams = FCollisionQueryParams();
-		CapsuleParams.bTraceComplex = false;
-		CapsuleParams.AddIgnoredActor(PlayerCharacter);
-		bCapsuleTraceGotHit = World->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeCapsule(Radius, HalfHeight), CapsuleParams);
+		FParkourTraceRecord Record = FParkourTraceRecord::MakeQuery(Shape, Start, End, Extent, Rotation);
+		Record.Owner = GetUniqueID();
+		Record.CallSite = TraceCallSite;
+		Record.State = ParkourState;
+		Record.bHit = bHit;
+		Record.Hit = Hit;
+		FParkourTraceRecorder::RecordQuery(Record);
+	}
+}
 
-		DrawDebugCapsuleTraceSingle(World, Start, End, Radius, HalfHeight, DrawDebugType, bCapsuleTraceGotHit, OutHit, FColor::Red, FColor::Green, 1.0f);
+void UParkourMovementComponent::BeginRecordedScan(const bool bAutoClimb, const bool bBaked)
+{
+	if (FParkourTraceRecorder::IsRecording() && PlayerCharacter && CharacterMesh && CharacterMovement)
+	{
+		FParkourScanSnapshot Snapshot;
+		Snapshot.Owner = GetUniqueID();
+		Snapshot.Frame = GFrameCounter;
+		Snapshot.ActorLocation = PlayerCharacter->GetActorLocation();
+		Snapshot.ActorRotation = PlayerCharacter->GetActorQuat();
+		Snapshot.Velocity = CharacterMovement->Velocity;
+		Snapshot.RootZ = CharacterMesh->GetSocketLocation(FName("root")).Z;
+		Snapshot.HandZ = FMath::Max(CharacterMesh->GetSocketLocation(FName("hand_r")).Z, CharacterMesh->GetSocketLocation(FName("hand_l")).Z);
+		Snapshot.State = ParkourState;
+		Snapshot.ClimbStyle = ClimbStyle;
+		Snapshot.bInGround = bInGround;
+		Snapshot.bAutoClimb = bAutoClimb;
+		Snapshot.bBaked = bBaked;
+		Snapshot.bAsync = bBaked == false && bUseAsyncWallScan;
+		FParkourTraceRecorder::BeginScan(Snapshot);
 	}
-	return bCapsuleTraceGotHit;
 }
 
-bool UParkourMovementComponent::BoxTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const FVector& HalfSize, EDrawDebugTrace::Type DrawDebugType /*= EDrawDebugTrace::None*/)
+void UParkourMovementComponent::EndRecordedScan()
 {
-	bool bTraceGotHit = false;
-	if (UWorld* World = GetWorld())
+	if (FParkourTraceRecorder::IsRecording())
 	{
-		FCollisionQueryParams BoxParams = FCollisionQueryParams();
-		BoxParams.bTraceComplex = false;
-		BoxParams.AddIgnoredActor(PlayerCharacter);
-		bTraceGotHit = World->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeBox(HalfSize), BoxParams);
-
-		DrawDebugBoxTraceSingle(World, Start, End, HalfSize, FRotator::ZeroRotator, DrawDebugType, bTraceGotHit, OutHit, FColor::Red, FColor::Green, 1.0f);
+		FParkourTraceRecorder::EndScan(GetUniqueID(), ParkourActionTag.GetTagName());
 	}
-	return bTraceGotHit;
+}
+
+FParkourScanEvaluation UParkourMovementComponent::EvaluateDropDown()
+{
+	FParkourScanEvaluation Evaluation;
+	if (PlayerCharacter == nullptr || CharacterMesh == nullptr || CharacterMovement == nullptr)
+	{
+		return Evaluation;
+	}
+
+	TGuardValue<bool> EvaluatingGuard(bEvaluatingScan, true);
+	TGuardValue<EParkourClimbStyle> ClimbStyleGuard(ClimbStyle, ClimbStyle);
+	EvaluatedAction = ParkourTags::Action_NoAction;
+	ResetParkourResult();
+
+	FParkourScanContext Context(PlayerCharacter->GetActorTransform());
+	TGuardValue<FParkourScanContext*> ScanContextGuard(ScanContext, &Context);
+	const double StartTime = FPlatformTime::Seconds();
+	FindDropDownHangLocation();
+
+	Evaluation.Action = EvaluatedAction;
+	Evaluation.ClimbStyle = ClimbStyle;
+	Evaluation.WallShapeSeconds = FPlatformTime::Seconds() - StartTime;
+	Evaluation.QueriesIssued = Context.QueriesIssued;
+	Evaluation.WallRotation = WallRotation;
+	Evaluation.WallTopResult = WallTopResult;
+	Evaluation.ClimbedLedgeResult = ClimbedLedgeHitResult;
+	return Evaluation;
+}
+
+FGameplayTag UParkourMovementComponent::ReplayRecordedScan(const FParkourRecordedScan& Scan, int& OutUnmatchedQueries)
+{
+	OutUnmatchedQueries = 0;
+	if (PlayerCharacter == nullptr || CharacterMesh == nullptr || CharacterMovement == nullptr)
+	{
+		return FGameplayTag();
+	}
+
+	// Recorded scans that ran on baked ledges are not replayed, the rest traced the world.
+	TGuardValue<bool> BakedGuard(bUseBakedLedges, false);
+	TGuardValue<bool> SimpleCollisionGuard(bUseSimpleCollisionLedges, false);
+	TGuardValue<bool> TemplateGuard(bUseLedgeTemplates, false);
+
+	const FParkourScanSnapshot& Snapshot = Scan.Snapshot;
+	PlayerCharacter->SetActorLocationAndRotation(Snapshot.ActorLocation, Snapshot.ActorRotation);
+	CharacterMovement->Velocity = Snapshot.Velocity;
+	FVector MeshLocation = CharacterMesh->GetComponentLocation();
+	MeshLocation.Z = Snapshot.RootZ;
+	CharacterMesh->SetWorldLocation(MeshLocation);
+	ParkourState = Snapshot.State;
+	ClimbStyle = Snapshot.ClimbStyle;
+	bInGround = Snapshot.bInGround;
+	ResetParkourResult();
+
+	FParkourReplayCollisionScene ReplayScene(Scan);
+	TGuardValue<const IParkourCollisionScene*> SceneGuard(CollisionScene, &ReplayScene);
+	TGuardValue<const FParkourRecordedScan*> ReplayGuard(ReplayedScan, &Scan);
+	const FParkourScanEvaluation Evaluation = EvaluateWallScan(Snapshot.bAutoClimb);
+
+	OutUnmatchedQueries = ReplayScene.GetNumUnmatchedQueries();
+	return Evaluation.Action;
+}
+
+FParkourScanEvaluation UParkourMovementComponent::EvaluateWallScan(const bool bAutoClimb)
+{
+	FParkourScanEvaluation Evaluation;
+	if (PlayerCharacter == nullptr || CharacterMesh == nullptr || CharacterMovement == nullptr)
+	{
+		return Evaluation;
+	}
+
+	TGuardValue<bool> EvaluatingGuard(bEvaluatingScan, true);
+	TGuardValue<EParkourClimbStyle> ClimbStyleGuard(ClimbStyle, ClimbStyle);
+	EvaluatedAction = ParkourTags::Action_NoAction;
+
+	// Probes are reused across fixtures without ticking, nothing of the previous evaluation may carry over.
+	ResetParkourResult();
+
+	FParkourScanContext Context(PlayerCharacter->GetActorTransform());
+	TGuardValue<FParkourScanContext*> ScanContextGuard(ScanContext, &Context);
+	const double StartTime = FPlatformTime::Seconds();
+	const bool bBaked = FindBakedWallShape();
+	if (bBaked == false)
+	{
+		CheckWallShape();
+	}
+	const double WallShapeTime = FPlatformTime::Seconds();
+	const int WallShapeQueries = Context.QueriesIssued;
+	CheckDistance();
+	ParkourType(bAutoClimb);
+
+	Evaluation.Action = EvaluatedAction;
+	Evaluation.ClimbStyle = ClimbStyle;
+	Evaluation.bBaked = bBaked;
+	Evaluation.WallShapeSeconds = WallShapeTime - StartTime;
+	Evaluation.DecisionSeconds = FPlatformTime::Seconds() - WallShapeTime;
+	Evaluation.QueriesIssued = WallShapeQueries;
+	Evaluation.WallHeight = WallHeight;
+	Evaluation.WallDepth = WallDepth;
+	Evaluation.VaultHeight = VaultHeight;
+	Evaluation.WallRotation = WallRotation;
+	Evaluation.WallTopResult = WallTopResult;
+	Evaluation.WallDepthResult = WallDepthResult;
+	Evaluation.WallVaultResult = WallVaultResult;
+	Evaluation.ClimbedLedgeResult = ClimbedLedgeHitResult;
+	return Evaluation;
 }
@@ -0,0 +1,10 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DataAssets/ParkourActionRegistryDataAsset.h"
+
+UParkourVariablesDataAsset* UParkourActionRegistryDataAsset::FindAction(const FGameplayTag& ActionTag) const
+{
+	UParkourVariablesDataAsset* const* Action = Actions.Find(ActionTag);
+	return Action ? *Action : nullptr;
+}
@@ -0,0 +1,17 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DataAssets/ParkourLedgeDataAsset.h"
+
+void UParkourLedgeDataAsset::PostLoad()
+{
+	Super::PostLoad();
+
+	// Assets baked before the packed format kept their ledges in world space.
+	if (BakedBounds_DEPRECATED.IsValid || Ledges_DEPRECATED.Num() > 0)
+	{
+		Chunk.Pack(BakedBounds_DEPRECATED, Ledges_DEPRECATED);
+		BakedBounds_DEPRECATED = FBox(ForceInit);
+		Ledges_DEPRECATED.Empty();
+	}
+}
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Debug/ParkourDebugSubsystem.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+static TAutoConsoleVariable<int32> CVarParkourDebug(
+	TEXT("parkour.Debug"),
+	0,
+	TEXT("Parkour debug drawing. 0: off, 1: scan results, state and flagged traces, 2: every parkour trace."));
+
+static TAutoConsoleVariable<int32> CVarParkourDebugBufferSize(
+	TEXT("parkour.Debug.BufferSize"),
+	4096,
+	TEXT("Number of parkour debug shapes kept before the oldest are overwritten."));
+
+bool UParkourDebugSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if PARKOUR_DEBUG_DRAW
+	return Super::ShouldCreateSubsystem(Outer);
+#else
+	return false;
+#endif
+}
+
+TStatId UParkourDebugSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UParkourDebugSubsystem, STATGROUP_Tickables);
+}
+
+bool UParkourDebugSubsystem::IsEnabled(const int Level)
+{
+#if PARKOUR_DEBUG_DRAW
+	return CVarParkourDebug.GetValueOnGameThread() >= Level;
+#else
+	return false;
+#endif
+}
+
+UParkourDebugSubsystem* UParkourDebugSubsystem::Get(const UWorld* World, const int Level)
+{
+	return (World && IsEnabled(Level)) ? World->GetSubsystem<UParkourDebugSubsystem>() : nullptr;
+}
+
+void UParkourDebugSubsystem::AddShape(const EParkourDebugShape Type, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, const FColor& Color, const float Duration)
+{
+	const int32 BufferSize = FMath::Max(CVarParkourDebugBufferSize.GetValueOnGameThread(), 1);
+	if (Shapes.Num() != BufferSize)
+	{
+		Shapes.SetNum(BufferSize);
+		NextShape = NextShape % BufferSize;
+	}
+
+	FParkourDebugShape& Shape = Shapes[NextShape];
+	Shape.Type = Type;
+	Shape.Start = Start;
+	Shape.End = End;
+	Shape.Extent = Extent;
+	Shape.Rotation = Rotation;
+	Shape.Color = Color;
+	Shape.ExpireTime = GetWorld()->GetTimeSeconds() + Duration;
+
+	NextShape = (NextShape + 1) % BufferSize;
+}
+
+void UParkourDebugSubsystem::AddTrace(const EParkourDebugShape Type, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, const bool bHit, const FHitResult& Hit, const FColor& TraceColor, const FColor& HitColor)
+{
+	if (bHit && Hit.bBlockingHit)
+	{
+		AddShape(EParkourDebugShape::Line, Start, Hit.Location, FVector::ZeroVector, Rotation, TraceColor);
+		AddShape(EParkourDebugShape::Line, Hit.Location, End, FVector::ZeroVector, Rotation, HitColor);
+		if (Type != EParkourDebugShape::Line)
+		{
+			AddShape(Type, Hit.Location, Hit.Location, Extent, Rotation, TraceColor);
+		}
+		AddShape(EParkourDebugShape::Point, Hit.ImpactPoint, Hit.ImpactPoint, FVector(10), Rotation, TraceColor);
+	}
+	else
+	{
+		AddShape(EParkourDebugShape::Line, Start, End, FVector::ZeroVector, Rotation, TraceColor);
+		if (Type != EParkourDebugShape::Line)
+		{
+			AddShape(Type, End, End, Extent, Rotation, TraceColor);
+		}
+	}
+}
+
+void UParkourDebugSubsystem::SetStateText(const UObject* Owner, TArray<FString>&& Lines)
+{
+	StateText.FindOrAdd(Owner) = MoveTemp(Lines);
+}
+
+void UParkourDebugSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const UWorld* World = GetWorld();
+	if (IsEnabled() == false)
+	{
+		// Drop whatever was recorded so turning the cvar back on does not flash stale shapes.
+		Shapes.Reset();
+		NextShape = 0;
+		StateText.Reset();
+		return;
+	}
+
+	const double Now = World->GetTimeSeconds();
+	for (const FParkourDebugShape& Shape : Shapes)
+	{
+		if (Shape.ExpireTime > Now)
+		{
+			DrawShape(World, Shape);
+		}
+	}
+
+	if (GEngine)
+	{
+		for (auto It = StateText.CreateIterator(); It; ++It)
+		{
+			if (It->Key.IsValid() == false)
+			{
+				It.RemoveCurrent();
+				continue;
+			}
+
+			for (const FString& Line : It->Value)
+			{
+				GEngine->AddOnScreenDebugMessage(-1, DeltaTime, FColor::Cyan, Line);
+			}
+		}
+	}
+}
+
+void UParkourDebugSubsystem::DrawShape(const UWorld* World, const FParkourDebugShape& Shape) const
+{
+	switch (Shape.Type)
+	{
+	case EParkourDebugShape::Line:
+		DrawDebugLine(World, Shape.Start, Shape.End, Shape.Color);
+		break;
+	case EParkourDebugShape::Sphere:
+		DrawDebugSphere(World, Shape.Start, Shape.Extent.X, 12, Shape.Color);
+		break;
+	case EParkourDebugShape::Box:
+		DrawDebugBox(World, Shape.Start, Shape.Extent, Shape.Rotation, Shape.Color);
+		break;
+	case EParkourDebugShape::Capsule:
+		DrawDebugCapsule(World, Shape.Start, Shape.Extent.Z, Shape.Extent.X, Shape.Rotation, Shape.Color);
+		break;
+	case EParkourDebugShape::Point:
+		DrawDebugPoint(World, Shape.Start, Shape.Extent.X, Shape.Color);
+		break;
+	}
+}
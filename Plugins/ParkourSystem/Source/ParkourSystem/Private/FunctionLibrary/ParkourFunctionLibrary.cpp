@@ -26,148 +26,87 @@ FVector UParkourFunctionLibrary::GetRightVector(FRotator Rotation)
 	return FRotationMatrix(Rotation).GetUnitAxis(EAxis::Y);
 }
 
-float UParkourFunctionLibrary::SelectClimbStyleFloat(const float Braced, const float FreeHang, const FGameplayTag ClimbStyle)
+FVector UParkourFunctionLibrary::TransformNormal(const FTransform& Transform, const FVector& Normal)
 {
-	FGameplayTag BracedTag = FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.Braced"));
-	FGameplayTag FreeHangTag = FGameplayTag::RequestGameplayTag(FName("Parkour.ClimbStyle.FreeHang"));
+	return Transform.TransformVectorNoScale(Normal * FTransform::GetSafeScaleReciprocal(Transform.GetScale3D())).GetSafeNormal();
+}
 
-	if (ClimbStyle == BracedTag)
+float UParkourFunctionLibrary::SelectClimbStyleFloat(const float Braced, const float FreeHang, const EParkourClimbStyle ClimbStyle)
+{
+	switch (ClimbStyle)
 	{
+	case EParkourClimbStyle::Braced:
 		return Braced;
-	}
-	else if (ClimbStyle == FreeHangTag)
-	{
+	case EParkourClimbStyle::FreeHang:
 		return FreeHang;
-	}
-	else
-	{
+	default:
 		return -1;
 	}
 }
 
-float UParkourFunctionLibrary::SelectParkourDirectionFloat(const float Forward, const float Backward, const float Left, const float Right, const float ForwardLeft, const float ForwardRight, const float BackwardLeft, const float BackwardRight, const FGameplayTag Direction)
+float UParkourFunctionLibrary::SelectParkourDirectionFloat(const float Forward, const float Backward, const float Left, const float Right, const float ForwardLeft, const float ForwardRight, const float BackwardLeft, const float BackwardRight, const EParkourDirection Direction)
 {
-	FGameplayTag ForwardTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Forward"));
-	FGameplayTag BackwardTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Backward"));
-	FGameplayTag LeftTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Left"));
-	FGameplayTag RightTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Right"));
-	FGameplayTag ForwardLeftTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.ForwardLeft"));
-	FGameplayTag ForwardRightTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.ForwardRight"));
-	FGameplayTag BackwardLeftTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.BackwardLeft"));
-	FGameplayTag BackwardRightTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.BackwardRight"));
-
-	if (Direction == ForwardTag)
+	switch (Direction)
 	{
+	case EParkourDirection::Forward:
 		return Forward;
-	}
-	else if (Direction == BackwardTag)
-	{
+	case EParkourDirection::Backward:
 		return Backward;
-	}
-	else if (Direction == LeftTag)
-	{
+	case EParkourDirection::Left:
 		return Left;
-	}
-	else if (Direction == RightTag)
-	{
+	case EParkourDirection::Right:
 		return Right;
-	}
-	else if (Direction == ForwardLeftTag)
-	{
+	case EParkourDirection::ForwardLeft:
 		return ForwardLeft;
-	}
-	else if (Direction == ForwardRightTag)
-	{
+	case EParkourDirection::ForwardRight:
 		return ForwardRight;
-	}
-	else if (Direction == BackwardLeftTag)
-	{
+	case EParkourDirection::BackwardLeft:
 		return BackwardLeft;
-	}
-	else if (Direction == BackwardRightTag)
-	{
+	case EParkourDirection::BackwardRight:
 		return BackwardRight;
-	}
-	else
-	{
+	default:
 		return -1;
 	}
 }
 
-float UParkourFunctionLibrary::SelectParkoutStateFloat(const float NotBusy, const float Vault, const float Mantle, const float Climb, const FGameplayTag StateTag)
+float UParkourFunctionLibrary::SelectParkoutStateFloat(const float NotBusy, const float Vault, const float Mantle, const float Climb, const EParkourState State)
 {
-	FGameplayTag NotBusyTag = FGameplayTag::RequestGameplayTag(FName("Parkour.State.NotBusy"));
-	FGameplayTag VaultTag = FGameplayTag::RequestGameplayTag(FName("Parkour.State.Vault"));
-	FGameplayTag MantleTag = FGameplayTag::RequestGameplayTag(FName("Parkour.State.Mantle"));
-	FGameplayTag ClimbTag = FGameplayTag::RequestGameplayTag(FName("Parkour.State.Climb"));
-
-	if (StateTag == NotBusyTag)
+	switch (State)
 	{
+	case EParkourState::NotBusy:
 		return NotBusy;
-	}
-	else if (StateTag == VaultTag)
-	{
+	case EParkourState::Vault:
 		return Vault;
-	}
-	else if (StateTag == MantleTag)
-	{
+	case EParkourState::Mantle:
 		return Mantle;
-	}
-	else if (StateTag == ClimbTag)
-	{
+	case EParkourState::Climb:
 		return Climb;
-	}
-	else
-	{
+	default:
 		return -1;
 	}
 }
 
-FGameplayTag UParkourFunctionLibrary::SelectParkourDirectionHopAction(const FGameplayTag Forward, const FGameplayTag Backward, const FGameplayTag Left, const FGameplayTag Right, const FGameplayTag ForwardLeft, const FGameplayTag ForwardRight, const FGameplayTag BackwardLeft, const FGameplayTag BackwardRight, const FGameplayTag Direction)
+FGameplayTag UParkourFunctionLibrary::SelectParkourDirectionHopAction(const FGameplayTag Forward, const FGameplayTag Backward, const FGameplayTag Left, const FGameplayTag Right, const FGameplayTag ForwardLeft, const FGameplayTag ForwardRight, const FGameplayTag BackwardLeft, const FGameplayTag BackwardRight, const EParkourDirection Direction)
 {
-	FGameplayTag ForwardTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Forward"));
-	FGameplayTag BackwardTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Backward"));
-	FGameplayTag LeftTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Left"));
-	FGameplayTag RightTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.Right"));
-	FGameplayTag ForwardLeftTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.ForwardLeft"));
-	FGameplayTag ForwardRightTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.ForwardRight"));
-	FGameplayTag BackwardLeftTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.BackwardLeft"));
-	FGameplayTag BackwardRightTag = FGameplayTag::RequestGameplayTag(FName("Parkour.Direction.BackwardRight"));
-
-	if (Direction == ForwardTag)
+	switch (Direction)
 	{
+	case EParkourDirection::Forward:
 		return Forward;
-	}
-	else if (Direction == BackwardTag)
-	{
+	case EParkourDirection::Backward:
 		return Backward;
-	}
-	else if (Direction == LeftTag)
-	{
+	case EParkourDirection::Left:
 		return Left;
-	}
-	else if (Direction == RightTag)
-	{
+	case EParkourDirection::Right:
 		return Right;
-	}
-	else if (Direction == ForwardLeftTag)
-	{
+	case EParkourDirection::ForwardLeft:
 		return ForwardLeft;
-	}
-	else if (Direction == ForwardRightTag)
-	{
+	case EParkourDirection::ForwardRight:
 		return ForwardRight;
-	}
-	else if (Direction == BackwardLeftTag)
-	{
+	case EParkourDirection::BackwardLeft:
 		return BackwardLeft;
-	}
-	else if (Direction == BackwardRightTag)
-	{
+	case EParkourDirection::BackwardRight:
 		return BackwardRight;
-	}
-	else
-	{
+	default:
 		return FGameplayTag();
 	}
-}
\ No newline at end of file
+}
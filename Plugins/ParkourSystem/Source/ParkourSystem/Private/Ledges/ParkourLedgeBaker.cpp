@@ -0,0 +1,315 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Ledges/ParkourLedgeBaker.h"
+#include "Components/ParkourDynamicLedgeComponent.h"
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+
+FVector FParkourLedgeBakeSettings::GetProbeReach() const
+{
+	// The far edge and landing probes reach furthest sideways, the floor and landing probes furthest down.
+	const float Horizontal = MaxDepth + SampleSpacing + 100.0f;
+	const float Vertical = FMath::Max(MaxWallProbeHeight, 200.0f) + 20.0f;
+	return FVector(Horizontal, Horizontal, Vertical);
+}
+
+FParkourLedgeBaker::FParkourLedgeBaker(const UWorld* InWorld, const FParkourLedgeBakeSettings& InSettings)
+	: World(InWorld)
+	, Settings(InSettings)
+	, QueryParams(SCENE_QUERY_STAT(ParkourLedgeBake), false)
+{
+	// Characters standing in the level are not part of the level geometry, and moving geometry keeps its own ledges.
+	if (World)
+	{
+		for (TActorIterator<AActor> It(const_cast<UWorld*>(World)); It; ++It)
+		{
+			if (It->IsA<APawn>() || It->FindComponentByClass<UParkourDynamicLedgeComponent>())
+			{
+				QueryParams.AddIgnoredActor(*It);
+			}
+		}
+	}
+}
+
+FParkourLedgeBaker::FParkourLedgeBaker(const UPrimitiveComponent* InComponent, const FParkourLedgeBakeSettings& InSettings)
+	: World(InComponent ? InComponent->GetWorld() : nullptr)
+	, Component(InComponent)
+	, Settings(InSettings)
+	, QueryParams(SCENE_QUERY_STAT(ParkourLedgeBake), false)
+{
+}
+
+void FParkourLedgeBaker::BakeRegion(const FBox& Region, TArray<FParkourLedge>& OutLedges, FParkourLedgeBakeStats* OutStats) const
+{
+	if (World == nullptr || Region.IsValid == false)
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const float Spacing = FMath::Max(Settings.SampleSpacing, 1.0f);
+	const FIntPoint NumColumns(FMath::CeilToInt((Region.Max.X - Region.Min.X) / Spacing) + 1, FMath::CeilToInt((Region.Max.Y - Region.Min.Y) / Spacing) + 1);
+
+	// Tiles are made of whole sample columns, so together they probe exactly the columns of a single pass.
+	const int ColumnsPerTile = (Settings.TileSize > 0) ? FMath::Max(FMath::FloorToInt(Settings.TileSize / Spacing), 1) : FMath::Max(NumColumns.X, NumColumns.Y);
+	const FIntPoint NumTiles(FMath::DivideAndRoundUp(NumColumns.X, ColumnsPerTile), FMath::DivideAndRoundUp(NumColumns.Y, ColumnsPerTile));
+
+	TArray<TArray<FParkourLedge>> TileSamples;
+	TileSamples.SetNum(NumTiles.X * NumTiles.Y);
+	ParallelFor(TileSamples.Num(), [&](const int32 TileIndex)
+	{
+		const FIntPoint MinColumn = FIntPoint(TileIndex % NumTiles.X, TileIndex / NumTiles.X) * ColumnsPerTile;
+		const FIntPoint MaxColumn(FMath::Min(MinColumn.X + ColumnsPerTile, NumColumns.X), FMath::Min(MinColumn.Y + ColumnsPerTile, NumColumns.Y));
+		ProbeColumns(Region, MinColumn, MaxColumn, TileSamples[TileIndex]);
+	});
+
+	// An edge crossing a seam has samples in both tiles. Merging all samples at once, in tile order, joins it the same way every run.
+	TArray<FParkourLedge> Samples;
+	for (const TArray<FParkourLedge>& Tile : TileSamples)
+	{
+		Samples.Append(Tile);
+	}
+
+	const int32 NumLedgesBefore = OutLedges.Num();
+	MergeLedgeSamples(Samples, Spacing, OutLedges);
+
+	if (OutStats)
+	{
+		OutStats->NumTiles += TileSamples.Num();
+		OutStats->NumLedges += OutLedges.Num() - NumLedgesBefore;
+		OutStats->Seconds += FPlatformTime::Seconds() - StartTime;
+	}
+}
+
+void FParkourLedgeBaker::ProbeColumns(const FBox& Region, const FIntPoint& MinColumn, const FIntPoint& MaxColumn, TArray<FParkourLedge>& OutSamples) const
+{
+	const float Spacing = FMath::Max(Settings.SampleSpacing, 1.0f);
+	const FVector Directions[4] = { FVector::ForwardVector, FVector::BackwardVector, FVector::RightVector, FVector::LeftVector };
+
+	for (int IndexX = MinColumn.X; IndexX < MaxColumn.X; IndexX++)
+	{
+		for (int IndexY = MinColumn.Y; IndexY < MaxColumn.Y; IndexY++)
+		{
+			const float X = FMath::Min(Region.Min.X + (IndexX * Spacing), Region.Max.X);
+			const float Y = FMath::Min(Region.Min.Y + (IndexY * Spacing), Region.Max.Y);
+			FVector ColumnStart = FVector(X, Y, Region.Max.Z);
+			const FVector ColumnEnd = FVector(X, Y, Region.Min.Z);
+
+			// Walk down the column. A line trace that starts inside a body does not report it,
+			// so stepping just below each hit finds every stacked surface.
+			for (int Layer = 0; Layer < Settings.MaxSurfaceLayers; Layer++)
+			{
+				FHitResult SurfaceHit;
+				if (LineTrace(SurfaceHit, ColumnStart, ColumnEnd) == false)
+				{
+					break;
+				}
+
+				if (SurfaceHit.ImpactNormal.Z >= Settings.MinTopNormalZ)
+				{
+					// Edges past the tile border still count, only the columns are split between tiles.
+					for (const FVector& Direction : Directions)
+					{
+						FParkourLedge Sample;
+						if (ProbeEdge(SurfaceHit.ImpactPoint, Direction, Sample) && Region.IsInsideOrOn(Sample.Start))
+						{
+							OutSamples.Add(Sample);
+						}
+					}
+				}
+
+				ColumnStart = SurfaceHit.ImpactPoint - FVector(0, 0, 1);
+			}
+		}
+	}
+}
+
+void FParkourLedgeBaker::RebakeRegion(const FBox& Region, const FBox& DirtyRegion, TArray<FParkourLedge>& InOutLedges, FParkourLedgeBakeStats* OutStats) const
+{
+	FBox RebakeRegion = FBox(FVector(DirtyRegion.Min.X, DirtyRegion.Min.Y, Region.Min.Z), FVector(DirtyRegion.Max.X, DirtyRegion.Max.Y, Region.Max.Z)).Overlap(Region);
+	if (RebakeRegion.IsValid == false)
+	{
+		return;
+	}
+
+	// Ledges reaching into the region are baked again whole, so their new samples join up the way they do in a full bake.
+	bool bGrown = true;
+	while (bGrown)
+	{
+		bGrown = false;
+		for (const FParkourLedge& Ledge : InOutLedges)
+		{
+			const FBox LedgeBounds = Ledge.GetBounds();
+			if (LedgeBounds.IntersectXY(RebakeRegion) && (RebakeRegion + LedgeBounds) != RebakeRegion)
+			{
+				RebakeRegion += LedgeBounds;
+				bGrown = true;
+			}
+		}
+	}
+	RebakeRegion = RebakeRegion.Overlap(Region);
+
+	InOutLedges.RemoveAll([&RebakeRegion](const FParkourLedge& Ledge) { return Ledge.GetBounds().IntersectXY(RebakeRegion); });
+	BakeRegion(RebakeRegion, InOutLedges, OutStats);
+}
+
+bool FParkourLedgeBaker::ProbeEdge(const FVector& SurfacePoint, const FVector& Direction, FParkourLedge& OutSample) const
+{
+	const FVector Beyond = SurfacePoint + (Direction * Settings.SampleSpacing);
+
+	// The surface carries on (or only steps down a little) past this sample, so there is no edge here.
+	FHitResult DropHit;
+	if (LineTrace(DropHit, Beyond + FVector(0, 0, 5), Beyond - FVector(0, 0, Settings.MinLedgeDrop)))
+	{
+		return false;
+	}
+
+	// Come back in just below the top to find the wall face and its normal.
+	FHitResult WallHit;
+	if (LineTrace(WallHit, Beyond - FVector(0, 0, 10), SurfacePoint - FVector(0, 0, 10)) == false || FMath::Abs(WallHit.ImpactNormal.Z) > 0.3f)
+	{
+		return false;
+	}
+
+	const FVector WallNormal = WallHit.ImpactNormal.GetSafeNormal2D();
+
+	// Same top probe as the runtime scan: a small sphere dropped just inside the face.
+	FHitResult TopHit;
+	const FVector TopTraceStart = WallHit.ImpactPoint - (WallNormal * 2) + FVector(0, 0, 17);
+	if (SphereTrace(TopHit, TopTraceStart, TopTraceStart - FVector(0, 0, 14), 2.5f) == false || TopHit.bStartPenetrating)
+	{
+		return false;
+	}
+
+	OutSample = FParkourLedge();
+	OutSample.Start = FVector(WallHit.ImpactPoint.X, WallHit.ImpactPoint.Y, TopHit.ImpactPoint.Z);
+	OutSample.End = OutSample.Start;
+	OutSample.WallNormal = WallNormal;
+	MeasureLedge(OutSample);
+	return true;
+}
+
+void FParkourLedgeBaker::MeasureLedge(FParkourLedge& Sample) const
+{
+	const FVector Edge = Sample.Start;
+	const FVector Normal = Sample.WallNormal;
+
+	FHitResult FloorHit;
+	const FVector FloorTraceStart = Edge + (Normal * 30);
+	Sample.WallHeight = LineTrace(FloorHit, FloorTraceStart, FloorTraceStart - FVector(0, 0, Settings.MaxWallProbeHeight)) ? (Edge.Z - FloorHit.ImpactPoint.Z) : Settings.MaxWallProbeHeight;
+
+	// CheckClimbStyle: anything to brace the feet against under the ledge.
+	FHitResult BraceHit;
+	const bool bBraced = SphereTrace(BraceHit, Edge + (Normal * 10) + FVector(0, 0, -125), Edge + (Normal * -30) + FVector(0, 0, -125), 10.0f);
+	Sample.ClimbStyle = bBraced ? EParkourLedgeClimbStyle::Braced : EParkourLedgeClimbStyle::FreeHang;
+
+	// Come back towards the face from the far side to find the far edge.
+	Sample.Depth = 0;
+	Sample.VaultHeight = 0;
+	FHitResult FarHit;
+	const FVector FarTraceEnd = Edge - FVector(0, 0, 5);
+	if (LineTrace(FarHit, FarTraceEnd - (Normal * Settings.MaxDepth), FarTraceEnd) && FVector::DotProduct(FarHit.ImpactNormal, -Normal) > 0.7f)
+	{
+		const FVector FarEdge = FVector(FarHit.ImpactPoint.X, FarHit.ImpactPoint.Y, Edge.Z);
+		Sample.Depth = FVector::Dist2D(Edge, FarEdge);
+
+		FHitResult LandingHit;
+		const FVector LandingTraceStart = FarEdge - (Normal * 70);
+		if (SphereTrace(LandingHit, LandingTraceStart, LandingTraceStart - FVector(0, 0, 200), 10.0f))
+		{
+			Sample.VaultHeight = Edge.Z - LandingHit.ImpactPoint.Z;
+		}
+	}
+}
+
+void FParkourLedgeBaker::MergeLedgeSamples(TArray<FParkourLedge>& Samples, const float SampleSpacing, TArray<FParkourLedge>& OutLedges)
+{
+	struct FSampleKey
+	{
+		int Yaw;
+		int Height;
+		int Offset;
+		float Along;
+	};
+
+	auto MakeKey = [](const FParkourLedge& Sample)
+	{
+		const FVector Tangent = FVector(-Sample.WallNormal.Y, Sample.WallNormal.X, 0);
+		FSampleKey Key;
+		Key.Yaw = FMath::RoundToInt(FMath::RadiansToDegrees(FMath::Atan2(Sample.WallNormal.Y, Sample.WallNormal.X)) / 5.0f);
+		Key.Height = FMath::RoundToInt(Sample.Start.Z / 5.0f);
+		Key.Offset = FMath::RoundToInt(FVector::DotProduct(Sample.Start, Sample.WallNormal) / 5.0f);
+		Key.Along = FVector::DotProduct(Sample.Start, Tangent);
+		return Key;
+	};
+
+	auto KeyLess = [](const FSampleKey& A, const FSampleKey& B)
+	{
+		if (A.Yaw != B.Yaw) return A.Yaw < B.Yaw;
+		if (A.Height != B.Height) return A.Height < B.Height;
+		if (A.Offset != B.Offset) return A.Offset < B.Offset;
+		return A.Along < B.Along;
+	};
+
+	Samples.Sort([&](const FParkourLedge& A, const FParkourLedge& B)
+	{
+		return KeyLess(MakeKey(A), MakeKey(B));
+	});
+
+	bool bHasOpenLedge = false;
+	FSampleKey OpenKey;
+	FParkourLedge OpenLedge;
+	for (const FParkourLedge& Sample : Samples)
+	{
+		const FSampleKey Key = MakeKey(Sample);
+		const bool bContinues = bHasOpenLedge
+			&& Key.Yaw == OpenKey.Yaw && Key.Height == OpenKey.Height && Key.Offset == OpenKey.Offset
+			&& (Key.Along - OpenKey.Along) <= (SampleSpacing * 1.5f)
+			&& Sample.ClimbStyle == OpenLedge.ClimbStyle
+			&& FMath::Abs(Sample.Depth - OpenLedge.Depth) <= 10.0f
+			&& FMath::Abs(Sample.VaultHeight - OpenLedge.VaultHeight) <= 10.0f
+			&& FMath::Abs(Sample.WallHeight - OpenLedge.WallHeight) <= 10.0f;
+
+		if (bContinues)
+		{
+			OpenLedge.End = Sample.Start;
+		}
+		else
+		{
+			if (bHasOpenLedge)
+			{
+				OutLedges.Add(OpenLedge);
+			}
+			OpenLedge = Sample;
+			bHasOpenLedge = true;
+		}
+		OpenKey = Key;
+	}
+
+	if (bHasOpenLedge)
+	{
+		OutLedges.Add(OpenLedge);
+	}
+}
+
+bool FParkourLedgeBaker::LineTrace(FHitResult& OutHit, const FVector& Start, const FVector& End) const
+{
+	if (Component)
+	{
+		return Component->LineTraceComponent(OutHit, Start, End, QueryParams);
+	}
+	return World->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams);
+}
+
+bool FParkourLedgeBaker::SphereTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const float Radius) const
+{
+	if (Component)
+	{
+		return Component->SweepComponent(OutHit, Start, End, FQuat::Identity, FCollisionShape::MakeSphere(Radius));
+	}
+	return World->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeSphere(Radius), QueryParams);
+}
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Ledges/ParkourLedgeChunk.h"
+
+// Offsets never get finer than this, a chunk holding a single point would otherwise divide by zero.
+static constexpr double ParkourLedgeChunkMinStep = 0.01;
+
+// Lengths are stored in millimeters.
+static constexpr float ParkourLedgeLengthScale = 10.0f;
+
+static int16 QuantizeOffset(const double Units)
+{
+	return (int16)FMath::Clamp(FMath::RoundToInt(Units), -MAX_int16, MAX_int16);
+}
+
+static uint16 QuantizeLength(const float Length)
+{
+	return (uint16)FMath::Clamp(FMath::RoundToInt(Length * ParkourLedgeLengthScale), 0, (int32)MAX_uint16);
+}
+
+static double SignNotZero(const double Value)
+{
+	return (Value >= 0) ? 1.0 : -1.0;
+}
+
+/** Folds the unit sphere onto the square [-1, 1]², the lower half into the corners. */
+static FVector2D EncodeOctahedral(const FVector& Normal)
+{
+	const FVector Projected = Normal / (FMath::Abs(Normal.X) + FMath::Abs(Normal.Y) + FMath::Abs(Normal.Z));
+	if (Projected.Z >= 0)
+	{
+		return FVector2D(Projected.X, Projected.Y);
+	}
+	return FVector2D((1.0 - FMath::Abs(Projected.Y)) * SignNotZero(Projected.X), (1.0 - FMath::Abs(Projected.X)) * SignNotZero(Projected.Y));
+}
+
+static FVector DecodeOctahedral(const FVector2D& Encoded)
+{
+	FVector Normal(Encoded.X, Encoded.Y, 1.0 - FMath::Abs(Encoded.X) - FMath::Abs(Encoded.Y));
+	if (Normal.Z < 0)
+	{
+		Normal.X = (1.0 - FMath::Abs(Encoded.Y)) * SignNotZero(Encoded.X);
+		Normal.Y = (1.0 - FMath::Abs(Encoded.X)) * SignNotZero(Encoded.Y);
+	}
+	return Normal.GetSafeNormal();
+}
+
+void FParkourLedgeChunk::MarkStale(const FBox& Region)
+{
+	FBox StaleRegion = Region.Overlap(Bounds);
+	if (StaleRegion.IsValid == false)
+	{
+		return;
+	}
+
+	// Overlapping regions are joined, edits tend to land on the same spot over and over.
+	for (int32 Index = StaleRegions.Num() - 1; Index >= 0; Index--)
+	{
+		if (StaleRegions[Index].Intersect(StaleRegion))
+		{
+			StaleRegion += StaleRegions[Index];
+			StaleRegions.RemoveAtSwap(Index);
+		}
+	}
+	StaleRegions.Add(StaleRegion);
+}
+
+bool FParkourLedgeChunk::IsStale(const FVector& Location) const
+{
+	for (const FBox& StaleRegion : StaleRegions)
+	{
+		if (StaleRegion.IsInsideOrOn(Location))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FParkourLedgeChunk::IsStale(const FBox& Region) const
+{
+	for (const FBox& StaleRegion : StaleRegions)
+	{
+		if (StaleRegion.Intersect(Region))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FParkourLedgeChunk::Pack(const FBox& InBounds, TConstArrayView<FParkourLedge> InLedges)
+{
+	Bounds = InBounds;
+	StaleRegions.Reset();
+	Origin = InBounds.IsValid ? InBounds.GetCenter() : FVector::ZeroVector;
+
+	double MaxOffset = InBounds.IsValid ? InBounds.GetExtent().GetMax() : 0.0;
+	for (const FParkourLedge& Ledge : InLedges)
+	{
+		MaxOffset = FMath::Max3(MaxOffset, (Ledge.Start - Origin).GetAbsMax(), (Ledge.End - Origin).GetAbsMax());
+	}
+	Step = FMath::Max(MaxOffset / MAX_int16, ParkourLedgeChunkMinStep);
+
+	Ledges.Reset(InLedges.Num());
+	for (const FParkourLedge& Ledge : InLedges)
+	{
+		FParkourPackedLedge& Packed = Ledges.AddDefaulted_GetRef();
+		const FVector StartOffset = (Ledge.Start - Origin) / Step;
+		const FVector EndOffset = (Ledge.End - Origin) / Step;
+		for (int Axis = 0; Axis < 3; Axis++)
+		{
+			Packed.Start[Axis] = QuantizeOffset(StartOffset[Axis]);
+			Packed.End[Axis] = QuantizeOffset(EndOffset[Axis]);
+		}
+
+		const FVector2D Normal = EncodeOctahedral(Ledge.WallNormal.GetSafeNormal());
+		Packed.WallNormal[0] = QuantizeOffset(Normal.X * MAX_int16);
+		Packed.WallNormal[1] = QuantizeOffset(Normal.Y * MAX_int16);
+
+		Packed.WallHeight = QuantizeLength(Ledge.WallHeight);
+		Packed.Depth = QuantizeLength(Ledge.Depth);
+		Packed.VaultHeight = QuantizeLength(Ledge.VaultHeight);
+		Packed.ClimbStyle = Ledge.ClimbStyle;
+	}
+}
+
+FParkourLedge FParkourLedgeChunk::Unpack(const int32 Index) const
+{
+	const FParkourPackedLedge& Packed = Ledges[Index];
+
+	FParkourLedge Ledge;
+	Ledge.Start = Decode(Packed.Start);
+	Ledge.End = Decode(Packed.End);
+	Ledge.WallNormal = DecodeOctahedral(FVector2D(Packed.WallNormal[0], Packed.WallNormal[1]) / MAX_int16);
+	Ledge.WallHeight = Packed.WallHeight / ParkourLedgeLengthScale;
+	Ledge.Depth = Packed.Depth / ParkourLedgeLengthScale;
+	Ledge.VaultHeight = Packed.VaultHeight / ParkourLedgeLengthScale;
+	Ledge.ClimbStyle = Packed.ClimbStyle;
+	return Ledge;
+}
+
+void FParkourLedgeChunk::UnpackAll(TArray<FParkourLedge>& OutLedges) const
+{
+	OutLedges.Reserve(OutLedges.Num() + Ledges.Num());
+	for (int32 Index = 0; Index < Ledges.Num(); Index++)
+	{
+		OutLedges.Add(Unpack(Index));
+	}
+}
+
+FVector FParkourLedgeChunk::Decode(const int16 Offset[3]) const
+{
+	return Origin + (FVector(Offset[0], Offset[1], Offset[2]) * Step);
+}
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Ledges/ParkourLedgeTemplateUserData.h"
+#include "Engine/StaticMesh.h"
+#include "FunctionLibrary/ParkourFunctionLibrary.h"
+
+const UParkourLedgeTemplateUserData* UParkourLedgeTemplateUserData::Get(const UStaticMesh* StaticMesh)
+{
+	const TArray<UAssetUserData*>* UserDataArray = StaticMesh ? StaticMesh->GetAssetUserDataArray() : nullptr;
+	if (UserDataArray == nullptr)
+	{
+		return nullptr;
+	}
+
+	for (const UAssetUserData* UserData : *UserDataArray)
+	{
+		if (const UParkourLedgeTemplateUserData* Template = Cast<UParkourLedgeTemplateUserData>(UserData))
+		{
+			return Template;
+		}
+	}
+	return nullptr;
+}
+
+void UParkourLedgeTemplateUserData::TransformLedges(const FTransform& Transform, TArray<FParkourLedge>& OutLedges) const
+{
+	TransformLedges(Transform, Ledges, OutLedges);
+}
+
+void UParkourLedgeTemplateUserData::TransformLedges(const FTransform& Transform, TConstArrayView<FParkourLedge> InLedges, TArray<FParkourLedge>& OutLedges)
+{
+	OutLedges.Reserve(OutLedges.Num() + InLedges.Num());
+	for (const FParkourLedge& Ledge : InLedges)
+	{
+		FParkourLedge& PlacedLedge = OutLedges.Add_GetRef(Ledge);
+		PlacedLedge.Start = Transform.TransformPosition(Ledge.Start);
+		PlacedLedge.End = Transform.TransformPosition(Ledge.End);
+		PlacedLedge.WallNormal = UParkourFunctionLibrary::TransformNormal(Transform, Ledge.WallNormal).GetSafeNormal2D();
+		PlacedLedge.WallHeight = 0;
+		PlacedLedge.VaultHeight = 0;
+
+		// Scaling stretches the top along the mesh axes, so the far edge is moved with the mesh too.
+		if (Ledge.Depth > 0)
+		{
+			PlacedLedge.Depth = FVector::Dist2D(PlacedLedge.Start, Transform.TransformPosition(Ledge.Start - (Ledge.WallNormal * Ledge.Depth)));
+		}
+	}
+}
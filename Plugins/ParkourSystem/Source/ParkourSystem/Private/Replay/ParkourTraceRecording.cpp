@@ -0,0 +1,329 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Replay/ParkourTraceRecording.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "ParkourSystem.h"
+
+enum class EParkourTraceRecordType : uint8
+{
+	Query,
+	ScanBegin,
+	ScanEnd
+};
+
+TUniquePtr<FArchive> FParkourTraceRecorder::Writer;
+
+static void SerializeCompact(FArchive& Ar, FVector& Vector)
+{
+	FVector3f Compact = FVector3f(Vector);
+	Ar << Compact;
+	Vector = FVector(Compact);
+}
+
+static void SerializeCompact(FArchive& Ar, FQuat& Quat)
+{
+	FQuat4f Compact = FQuat4f(Quat);
+	Ar << Compact;
+	Quat = FQuat(Compact);
+}
+
+static FIntVector Quantize(const FVector& Vector)
+{
+	// 1/16 cm, well below anything the scans tell apart.
+	return FIntVector(FMath::RoundToInt(Vector.X * 16), FMath::RoundToInt(Vector.Y * 16), FMath::RoundToInt(Vector.Z * 16));
+}
+
+FParkourTraceRecord FParkourTraceRecord::MakeQuery(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation)
+{
+	FParkourTraceRecord Record;
+	Record.Shape = Shape;
+	Record.Start = Start;
+	Record.End = End;
+	Record.Extent = Extent;
+	Record.Rotation = Rotation;
+	Record.Hit = FHitResult(Start, End);
+	return Record;
+}
+
+uint32 FParkourTraceRecord::GetQueryHash() const
+{
+	uint32 Hash = GetTypeHash((uint8)Shape);
+	Hash = HashCombine(Hash, GetTypeHash(Quantize(Start)));
+	Hash = HashCombine(Hash, GetTypeHash(Quantize(End)));
+	Hash = HashCombine(Hash, GetTypeHash(Quantize(Extent)));
+	return Hash;
+}
+
+bool FParkourTraceRecord::MatchesQuery(const FParkourTraceRecord& Other) const
+{
+	return Shape == Other.Shape
+		&& Quantize(Start) == Quantize(Other.Start)
+		&& Quantize(End) == Quantize(Other.End)
+		&& Quantize(Extent) == Quantize(Other.Extent)
+		&& Rotation.Equals(Other.Rotation, 1.e-3f);
+}
+
+FArchive& operator<<(FArchive& Ar, FParkourTraceRecord& Record)
+{
+	Ar << Record.Owner;
+	Ar << Record.Shape;
+	Ar << Record.CallSite;
+	Ar << Record.State;
+	SerializeCompact(Ar, Record.Start);
+	SerializeCompact(Ar, Record.End);
+	SerializeCompact(Ar, Record.Extent);
+	SerializeCompact(Ar, Record.Rotation);
+	Ar << Record.bHit;
+
+	if (Ar.IsLoading())
+	{
+		Record.Hit = FHitResult(Record.Start, Record.End);
+	}
+
+	// Misses are fully described by the query, only hits carry their result.
+	if (Record.bHit)
+	{
+		bool bBlockingHit = Record.Hit.bBlockingHit;
+		bool bStartPenetrating = Record.Hit.bStartPenetrating;
+		Ar << bBlockingHit;
+		Ar << bStartPenetrating;
+		Ar << Record.Hit.Time;
+		Ar << Record.Hit.Distance;
+		Ar << Record.Hit.PenetrationDepth;
+		SerializeCompact(Ar, Record.Hit.Location);
+		SerializeCompact(Ar, Record.Hit.ImpactPoint);
+		SerializeCompact(Ar, Record.Hit.Normal);
+		SerializeCompact(Ar, Record.Hit.ImpactNormal);
+		Record.Hit.bBlockingHit = bBlockingHit;
+		Record.Hit.bStartPenetrating = bStartPenetrating;
+	}
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FParkourScanSnapshot& Snapshot)
+{
+	Ar << Snapshot.Owner;
+	Ar << Snapshot.Frame;
+	SerializeCompact(Ar, Snapshot.ActorLocation);
+	SerializeCompact(Ar, Snapshot.ActorRotation);
+	SerializeCompact(Ar, Snapshot.Velocity);
+	Ar << Snapshot.RootZ;
+	Ar << Snapshot.HandZ;
+	Ar << Snapshot.State;
+	Ar << Snapshot.ClimbStyle;
+	Ar << Snapshot.bInGround;
+	Ar << Snapshot.bAutoClimb;
+	Ar << Snapshot.bBaked;
+	Ar << Snapshot.bAsync;
+	return Ar;
+}
+
+const FParkourTraceRecord* FParkourRecordedScan::FindQuery(const FParkourTraceRecord& Query) const
+{
+	TArray<int32, TInlineAllocator<4>> Candidates;
+	QueryIndex.MultiFind(Query.GetQueryHash(), Candidates);
+	for (const int32 Index : Candidates)
+	{
+		if (Queries[Index].MatchesQuery(Query))
+		{
+			return &Queries[Index];
+		}
+	}
+	return nullptr;
+}
+
+void FParkourRecordedScan::BuildQueryIndex()
+{
+	QueryIndex.Reset();
+	for (int32 Index = 0; Index < Queries.Num(); Index++)
+	{
+		QueryIndex.Add(Queries[Index].GetQueryHash(), Index);
+	}
+}
+
+bool FParkourReplayCollisionScene::Sweep(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, FHitResult& OutHit) const
+{
+	const FParkourTraceRecord Query = FParkourTraceRecord::MakeQuery(Shape, Start, End, Extent, Rotation);
+	bool bHit = false;
+	if (const FParkourTraceRecord* Record = Scan.FindQuery(Query))
+	{
+		OutHit = Record->Hit;
+		bHit = Record->bHit;
+	}
+	else
+	{
+		// The scan took a path the recording never saw.
+		OutHit = Query.Hit;
+		NumUnmatchedQueries++;
+	}
+	OutHit.TraceStart = Start;
+	OutHit.TraceEnd = End;
+	return bHit;
+}
+
+bool FParkourTraceRecording::LoadFromFile(const FString& Filename)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename));
+	if (Reader.IsValid() == false)
+	{
+		UE_LOG(LogParkour, Error, TEXT("Could not open parkour trace recording %s."), *Filename);
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	*Reader << Magic;
+	*Reader << Version;
+	if (Magic != FParkourTraceRecorder::FileMagic || Version != FParkourTraceRecorder::FileVersion)
+	{
+		UE_LOG(LogParkour, Error, TEXT("%s is not a version %u parkour trace recording."), *Filename, FParkourTraceRecorder::FileVersion);
+		return false;
+	}
+
+	Scans.Reset();
+	NumOtherQueries = 0;
+	NumUnfinishedScans = 0;
+
+	// Several characters can record at once, so scans are rebuilt per owner.
+	TMap<uint32, FParkourRecordedScan> OpenScans;
+	while (Reader->AtEnd() == false && Reader->IsError() == false)
+	{
+		EParkourTraceRecordType RecordType;
+		*Reader << RecordType;
+
+		if (RecordType == EParkourTraceRecordType::Query)
+		{
+			FParkourTraceRecord Record;
+			*Reader << Record;
+			if (FParkourRecordedScan* OpenScan = OpenScans.Find(Record.Owner))
+			{
+				OpenScan->Queries.Add(MoveTemp(Record));
+			}
+			else
+			{
+				NumOtherQueries++;
+			}
+		}
+		else if (RecordType == EParkourTraceRecordType::ScanBegin)
+		{
+			FParkourScanSnapshot Snapshot;
+			*Reader << Snapshot;
+			if (OpenScans.Contains(Snapshot.Owner))
+			{
+				NumUnfinishedScans++;
+			}
+			FParkourRecordedScan& OpenScan = OpenScans.Add(Snapshot.Owner);
+			OpenScan.Snapshot = Snapshot;
+		}
+		else if (RecordType == EParkourTraceRecordType::ScanEnd)
+		{
+			uint32 Owner = 0;
+			FString Action;
+			*Reader << Owner;
+			*Reader << Action;
+
+			FParkourRecordedScan FinishedScan;
+			if (OpenScans.RemoveAndCopyValue(Owner, FinishedScan))
+			{
+				FinishedScan.Action = FName(*Action);
+				FinishedScan.BuildQueryIndex();
+				Scans.Add(MoveTemp(FinishedScan));
+			}
+		}
+		else
+		{
+			UE_LOG(LogParkour, Error, TEXT("%s is corrupt, stopped reading after %d scans."), *Filename, Scans.Num());
+			break;
+		}
+	}
+
+	NumUnfinishedScans += OpenScans.Num();
+	return true;
+}
+
+bool FParkourTraceRecorder::Start(const FString& Filename)
+{
+	Stop();
+
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*Filename));
+	if (Writer.IsValid() == false)
+	{
+		UE_LOG(LogParkour, Error, TEXT("Could not create parkour trace recording %s."), *Filename);
+		return false;
+	}
+
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	*Writer << Magic;
+	*Writer << Version;
+
+	UE_LOG(LogParkour, Log, TEXT("Recording parkour traces to %s."), *Filename);
+	return true;
+}
+
+void FParkourTraceRecorder::Stop()
+{
+	if (Writer.IsValid())
+	{
+		Writer->Close();
+		Writer.Reset();
+		UE_LOG(LogParkour, Log, TEXT("Stopped recording parkour traces."));
+	}
+}
+
+void FParkourTraceRecorder::RecordQuery(FParkourTraceRecord& Record)
+{
+	if (Writer.IsValid())
+	{
+		EParkourTraceRecordType RecordType = EParkourTraceRecordType::Query;
+		*Writer << RecordType;
+		*Writer << Record;
+	}
+}
+
+void FParkourTraceRecorder::BeginScan(FParkourScanSnapshot& Snapshot)
+{
+	if (Writer.IsValid())
+	{
+		EParkourTraceRecordType RecordType = EParkourTraceRecordType::ScanBegin;
+		*Writer << RecordType;
+		*Writer << Snapshot;
+	}
+}
+
+void FParkourTraceRecorder::EndScan(const uint32 Owner, const FName Action)
+{
+	if (Writer.IsValid())
+	{
+		EParkourTraceRecordType RecordType = EParkourTraceRecordType::ScanEnd;
+		uint32 OwnerId = Owner;
+		FString ActionName = Action.ToString();
+		*Writer << RecordType;
+		*Writer << OwnerId;
+		*Writer << ActionName;
+	}
+}
+
+#if PARKOUR_TRACE_RECORDING
+static FAutoConsoleCommandWithArgsAndOutputDevice ParkourRecordStartCommand(
+	TEXT("parkour.Record.Start"),
+	TEXT("Records every parkour collision query to a file. parkour.Record.Start [filename], defaults to Saved/Parkour/<timestamp>.pktr."),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, FOutputDevice& Ar)
+	{
+		const FString Filename = Args.Num() > 0 ? Args[0] : FPaths::ProjectSavedDir() / TEXT("Parkour") / (FDateTime::Now().ToString() + TEXT(".pktr"));
+		if (FParkourTraceRecorder::Start(Filename))
+		{
+			Ar.Logf(TEXT("Recording parkour traces to %s"), *Filename);
+		}
+	}));
+
+static FAutoConsoleCommandWithArgsAndOutputDevice ParkourRecordStopCommand(
+	TEXT("parkour.Record.Stop"),
+	TEXT("Stops the parkour trace recording."),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, FOutputDevice& Ar)
+	{
+		FParkourTraceRecorder::Stop();
+	}));
+#endif
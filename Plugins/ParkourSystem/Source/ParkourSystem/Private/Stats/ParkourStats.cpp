@@ -0,0 +1,223 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Stats/ParkourStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDevice.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traces: CheckWallShape"), STAT_ParkourTracesCheckWallShape, STATGROUP_Parkour);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traces: FirstClimbHeight"), STAT_ParkourTracesFirstClimbHeight, STATGROUP_Parkour);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traces: Surface Checks"), STAT_ParkourTracesSurfaceCheck, STATGROUP_Parkour);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traces: ClimbMovement"), STAT_ParkourTracesClimbMovement, STATGROUP_Parkour);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traces: LimbsClimbIK"), STAT_ParkourTracesLimbsClimbIK, STATGROUP_Parkour);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traces: FindDropDownHangLocation"), STAT_ParkourTracesFindDropDownHangLocation, STATGROUP_Parkour);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traces: AutoClimb"), STAT_ParkourTracesAutoClimb, STATGROUP_Parkour);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traces: Other"), STAT_ParkourTracesOther, STATGROUP_Parkour);
+
+FParkourTraceStats::FCallSiteCounts FParkourTraceStats::Counts[(uint8)EParkourTraceCallSite::Count];
+
+uint64 FParkourTraceStats::CountedFrame = 0;
+
+uint64 FParkourTraceStats::FramesWithTraces = 0;
+
+FParkourCycleStats::FStatCounts FParkourCycleStats::Counts[(uint8)EParkourCycleStat::Count];
+
+static FAutoConsoleCommandWithArgsAndOutputDevice ParkourStatsCommand(
+	TEXT("parkour.stats"),
+	TEXT("Prints parkour trace counts per call site (last frame, peak frame, total) and the cycle counter totals. 'parkour.stats reset' clears them."),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, FOutputDevice& Ar)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			FParkourTraceStats::Reset();
+			FParkourCycleStats::Reset();
+			return;
+		}
+		FParkourTraceStats::Dump(Ar);
+		FParkourCycleStats::Dump(Ar);
+	}));
+
+void FParkourTraceStats::AddTrace(EParkourTraceCallSite CallSite)
+{
+	AdvanceFrame();
+
+	FCallSiteCounts& CallSiteCounts = Counts[(uint8)CallSite];
+	CallSiteCounts.CurrentFrame++;
+	CallSiteCounts.Total++;
+
+	switch (CallSite)
+	{
+	case EParkourTraceCallSite::CheckWallShape:
+		INC_DWORD_STAT(STAT_ParkourTracesCheckWallShape);
+		break;
+	case EParkourTraceCallSite::FirstClimbHeight:
+		INC_DWORD_STAT(STAT_ParkourTracesFirstClimbHeight);
+		break;
+	case EParkourTraceCallSite::SurfaceCheck:
+		INC_DWORD_STAT(STAT_ParkourTracesSurfaceCheck);
+		break;
+	case EParkourTraceCallSite::ClimbMovement:
+		INC_DWORD_STAT(STAT_ParkourTracesClimbMovement);
+		break;
+	case EParkourTraceCallSite::LimbsClimbIK:
+		INC_DWORD_STAT(STAT_ParkourTracesLimbsClimbIK);
+		break;
+	case EParkourTraceCallSite::FindDropDownHangLocation:
+		INC_DWORD_STAT(STAT_ParkourTracesFindDropDownHangLocation);
+		break;
+	case EParkourTraceCallSite::AutoClimb:
+		INC_DWORD_STAT(STAT_ParkourTracesAutoClimb);
+		break;
+	default:
+		INC_DWORD_STAT(STAT_ParkourTracesOther);
+		break;
+	}
+}
+
+void FParkourTraceStats::AdvanceFrame()
+{
+	if (CountedFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	bool bHadTraces = false;
+	for (FCallSiteCounts& CallSiteCounts : Counts)
+	{
+		bHadTraces |= CallSiteCounts.CurrentFrame > 0;
+	}
+
+	// Frames without any trace keep the previous "last frame" numbers, so they stay readable from the console.
+	if (bHadTraces)
+	{
+		FramesWithTraces++;
+		for (FCallSiteCounts& CallSiteCounts : Counts)
+		{
+			CallSiteCounts.LastFrame = CallSiteCounts.CurrentFrame;
+			CallSiteCounts.PeakFrame = FMath::Max(CallSiteCounts.PeakFrame, CallSiteCounts.CurrentFrame);
+			CallSiteCounts.CurrentFrame = 0;
+		}
+	}
+	CountedFrame = GFrameCounter;
+}
+
+void FParkourTraceStats::Reset()
+{
+	for (FCallSiteCounts& CallSiteCounts : Counts)
+	{
+		CallSiteCounts = FCallSiteCounts();
+	}
+	FramesWithTraces = 0;
+	CountedFrame = GFrameCounter;
+}
+
+void FParkourTraceStats::Dump(FOutputDevice& Ar)
+{
+	AdvanceFrame();
+
+	Ar.Logf(TEXT("Parkour traces over %llu frames with traces:"), FramesWithTraces);
+	Ar.Logf(TEXT("%-26s %10s %10s %12s"), TEXT("Call Site"), TEXT("Last"), TEXT("Peak"), TEXT("Total"));
+	for (uint8 Index = 0; Index < (uint8)EParkourTraceCallSite::Count; Index++)
+	{
+		const FCallSiteCounts& CallSiteCounts = Counts[Index];
+		Ar.Logf(TEXT("%-26s %10u %10u %12llu"), GetCallSiteName((EParkourTraceCallSite)Index), CallSiteCounts.LastFrame, CallSiteCounts.PeakFrame, CallSiteCounts.Total);
+	}
+}
+
+const TCHAR* FParkourTraceStats::GetCallSiteName(EParkourTraceCallSite CallSite)
+{
+	switch (CallSite)
+	{
+	case EParkourTraceCallSite::CheckWallShape:
+		return TEXT("CheckWallShape");
+	case EParkourTraceCallSite::FirstClimbHeight:
+		return TEXT("FirstClimbHeight");
+	case EParkourTraceCallSite::SurfaceCheck:
+		return TEXT("SurfaceCheck");
+	case EParkourTraceCallSite::ClimbMovement:
+		return TEXT("ClimbMovement");
+	case EParkourTraceCallSite::LimbsClimbIK:
+		return TEXT("LimbsClimbIK");
+	case EParkourTraceCallSite::FindDropDownHangLocation:
+		return TEXT("FindDropDownHangLocation");
+	case EParkourTraceCallSite::AutoClimb:
+		return TEXT("AutoClimb");
+	default:
+		return TEXT("Other");
+	}
+}
+
+uint64 FParkourTraceStats::GetTotalTraces(EParkourTraceCallSite CallSite)
+{
+	return Counts[(uint8)CallSite].Total;
+}
+
+void FParkourCycleStats::AddCycles(EParkourCycleStat Stat, uint64 Cycles)
+{
+	FStatCounts& StatCounts = Counts[(uint8)Stat];
+	StatCounts.Cycles += Cycles;
+	StatCounts.Calls++;
+}
+
+void FParkourCycleStats::Reset()
+{
+	for (FStatCounts& StatCounts : Counts)
+	{
+		StatCounts = FStatCounts();
+	}
+}
+
+void FParkourCycleStats::Dump(FOutputDevice& Ar)
+{
+	Ar.Logf(TEXT("Parkour cycle counters:"));
+	Ar.Logf(TEXT("%-26s %12s %12s %12s"), TEXT("Counter"), TEXT("Calls"), TEXT("Total ms"), TEXT("Per call us"));
+	for (uint8 Index = 0; Index < (uint8)EParkourCycleStat::Count; Index++)
+	{
+		const FStatCounts& StatCounts = Counts[Index];
+		const double Milliseconds = FPlatformTime::ToMilliseconds64(StatCounts.Cycles);
+		Ar.Logf(TEXT("%-26s %12llu %12.3f %12.3f"), GetStatName((EParkourCycleStat)Index), StatCounts.Calls, Milliseconds, StatCounts.Calls > 0 ? Milliseconds * 1000 / StatCounts.Calls : 0.0);
+	}
+}
+
+const TCHAR* FParkourCycleStats::GetStatName(EParkourCycleStat Stat)
+{
+	switch (Stat)
+	{
+	case EParkourCycleStat::CheckWallShape:
+		return TEXT("CheckWallShape");
+	case EParkourCycleStat::ParkourType:
+		return TEXT("ParkourType");
+	case EParkourCycleStat::ClimbMovement:
+		return TEXT("ClimbMovement");
+	case EParkourCycleStat::LimbsClimbIK:
+		return TEXT("LimbsClimbIK");
+	case EParkourCycleStat::FindDropDownHangLocation:
+		return TEXT("FindDropDownHangLocation");
+	case EParkourCycleStat::AutoClimb:
+		return TEXT("AutoClimb");
+	case EParkourCycleStat::LedgeLookup:
+		return TEXT("LedgeLookup");
+	case EParkourCycleStat::MontageSelection:
+		return TEXT("MontageSelection");
+	case EParkourCycleStat::LineTrace:
+		return TEXT("LineTrace");
+	case EParkourCycleStat::SphereTrace:
+		return TEXT("SphereTrace");
+	case EParkourCycleStat::CapsuleTrace:
+		return TEXT("CapsuleTrace");
+	case EParkourCycleStat::BoxTrace:
+		return TEXT("BoxTrace");
+	default:
+		return TEXT("Unknown");
+	}
+}
+
+uint64 FParkourCycleStats::GetTotalCycles(EParkourCycleStat Stat)
+{
+	return Counts[(uint8)Stat].Cycles;
+}
+
+uint64 FParkourCycleStats::GetTotalCalls(EParkourCycleStat Stat)
+{
+	return Counts[(uint8)Stat].Calls;
+}
@@ -0,0 +1,698 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/ParkourLedgeSubsystem.h"
+#include "DataAssets/ParkourLedgeDataAsset.h"
+#include "Ledges/ParkourLedgeChunk.h"
+#include "Ledges/ParkourLedgeTemplateUserData.h"
+#include "Stats/ParkourStats.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "TimerManager.h"
+#include "WorldPartition/WorldPartitionSubsystem.h"
+
+DECLARE_MEMORY_STAT(TEXT("Loaded Ledge Data"), STAT_ParkourLedgeMemory, STATGROUP_Parkour);
+DECLARE_CYCLE_STAT(TEXT("LedgeLookup"), STAT_ParkourLedgeLookup, STATGROUP_Parkour);
+
+// Seconds of travel whose ledge cells are streamed in ahead of a prefetch actor.
+static constexpr float ParkourLedgePrefetchTime = 2.0f;
+
+// Slower than this the streaming source of the player controller already covers what a scan can reach.
+static constexpr float ParkourLedgePrefetchMinSpeed = 100.0f;
+
+// Added around the travel path, a scan reaches about this far past the character.
+static constexpr float ParkourLedgePrefetchMargin = 500.0f;
+
+// Ledges are kept level like the templates, a dynamic primitive tilted further than this is left to the traces.
+static constexpr float ParkourDynamicLedgeMinUpZ = 0.999f;
+
+// A hop reaches this far up, down and to either side of the held point.
+static constexpr float ParkourHopMaxOffset = 150.0f;
+
+// Closer than this the hands shimmy over instead of hopping.
+static constexpr float ParkourHopMinOffset = 30.0f;
+
+// A ledge further in or out from the held wall is reached with a corner move, not a hop.
+static constexpr float ParkourHopMaxWallOffset = 40.0f;
+
+// Cosine of the largest angle between the held wall and the wall hopped to.
+static constexpr float ParkourHopMinNormalDot = 0.9f;
+
+// The hands hang a little off the baked edge, the held ledge is looked for this far around them.
+static constexpr float ParkourHopHeldTolerance = 15.0f;
+
+/** Which way a hop from From to To goes on a wall facing WallNormal, NoDirection when it is not a hop. */
+static EParkourDirection GetHopDirection(const FVector& From, const FVector& To, const FVector& WallNormal)
+{
+	const FVector Offset = To - From;
+	const FVector Right = FVector::CrossProduct(FVector::UpVector, -WallNormal).GetSafeNormal();
+	const float Up = Offset.Z;
+	const float Side = FVector::DotProduct(Offset, Right);
+	if (FMath::Abs(Up) > ParkourHopMaxOffset || FMath::Abs(Side) > ParkourHopMaxOffset || FMath::Abs(FVector::DotProduct(Offset, WallNormal)) > ParkourHopMaxWallOffset)
+	{
+		return EParkourDirection::NoDirection;
+	}
+
+	const bool bRight = Side > ParkourHopMinOffset;
+	const bool bLeft = Side < -ParkourHopMinOffset;
+	if (Up > ParkourHopMinOffset)
+	{
+		return bRight ? EParkourDirection::ForwardRight : (bLeft ? EParkourDirection::ForwardLeft : EParkourDirection::Forward);
+	}
+	if (Up < -ParkourHopMinOffset)
+	{
+		return bRight ? EParkourDirection::BackwardRight : (bLeft ? EParkourDirection::BackwardLeft : EParkourDirection::Backward);
+	}
+	return bRight ? EParkourDirection::Right : (bLeft ? EParkourDirection::Left : EParkourDirection::NoDirection);
+}
+
+void UParkourLedgeSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (UWorldPartitionSubsystem* WorldPartitionSubsystem = InWorld.GetSubsystem<UWorldPartitionSubsystem>())
+	{
+		WorldPartitionSubsystem->RegisterStreamingSourceProvider(this);
+	}
+}
+
+void UParkourLedgeSubsystem::Deinitialize()
+{
+	if (UWorldPartitionSubsystem* WorldPartitionSubsystem = GetWorld()->GetSubsystem<UWorldPartitionSubsystem>())
+	{
+		WorldPartitionSubsystem->UnregisterStreamingSourceProvider(this);
+	}
+
+	for (const FChunkIndex& ChunkIndex : Chunks)
+	{
+		DEC_MEMORY_STAT_BY(STAT_ParkourLedgeMemory, ChunkIndex.AllocatedSize);
+	}
+	Chunks.Reset();
+	NumLedges = 0;
+
+	for (const FDynamicLedges& DynamicLedges : DynamicPrimitives)
+	{
+		if (UPrimitiveComponent* Primitive = DynamicLedges.Primitive.Get())
+		{
+			Primitive->TransformUpdated.RemoveAll(this);
+		}
+	}
+	DynamicPrimitives.Reset();
+	GetWorld()->GetTimerManager().ClearTimer(DynamicBakeTimerHandle);
+
+	Super::Deinitialize();
+}
+
+void UParkourLedgeSubsystem::RegisterLedgeData(UParkourLedgeDataAsset* LedgeData)
+{
+	if (LedgeData && LedgeDataAssets.Contains(LedgeData) == false)
+	{
+		LedgeDataAssets.Add(LedgeData);
+		RegisterLedgeChunk(LedgeData->Chunk);
+	}
+}
+
+void UParkourLedgeSubsystem::UnregisterLedgeData(UParkourLedgeDataAsset* LedgeData)
+{
+	if (LedgeDataAssets.Remove(LedgeData) > 0)
+	{
+		UnregisterLedgeChunk(LedgeData->Chunk);
+	}
+}
+
+void UParkourLedgeSubsystem::RegisterLedgeChunk(const FParkourLedgeChunk& Chunk)
+{
+	if (Chunks.ContainsByPredicate([&Chunk](const FChunkIndex& ChunkIndex) { return ChunkIndex.Chunk == &Chunk; }))
+	{
+		return;
+	}
+
+	FChunkIndex& ChunkIndex = Chunks.AddDefaulted_GetRef();
+	ChunkIndex.Chunk = &Chunk;
+	IndexChunk(ChunkIndex);
+	ChunkIndex.NumLedges = Chunk.Num();
+	ChunkIndex.AllocatedSize = Chunk.GetAllocatedSize() + ChunkIndex.Cells.GetAllocatedSize();
+	NumLedges += ChunkIndex.NumLedges;
+	INC_MEMORY_STAT_BY(STAT_ParkourLedgeMemory, ChunkIndex.AllocatedSize);
+}
+
+void UParkourLedgeSubsystem::UnregisterLedgeChunk(const FParkourLedgeChunk& Chunk)
+{
+	const int32 Index = Chunks.IndexOfByPredicate([&Chunk](const FChunkIndex& ChunkIndex) { return ChunkIndex.Chunk == &Chunk; });
+	if (Index != INDEX_NONE)
+	{
+		NumLedges -= Chunks[Index].NumLedges;
+		DEC_MEMORY_STAT_BY(STAT_ParkourLedgeMemory, Chunks[Index].AllocatedSize);
+		Chunks.RemoveAtSwap(Index);
+	}
+}
+
+void UParkourLedgeSubsystem::ReindexLedgeChunk(const FParkourLedgeChunk& Chunk)
+{
+	if (Chunks.ContainsByPredicate([&Chunk](const FChunkIndex& ChunkIndex) { return ChunkIndex.Chunk == &Chunk; }))
+	{
+		UnregisterLedgeChunk(Chunk);
+		RegisterLedgeChunk(Chunk);
+	}
+}
+
+void UParkourLedgeSubsystem::RegisterDynamicPrimitive(UPrimitiveComponent* Primitive, const FParkourLedgeBakeSettings& BakeSettings)
+{
+	if (Primitive == nullptr || DynamicPrimitives.ContainsByPredicate([Primitive](const FDynamicLedges& DynamicLedges) { return DynamicLedges.Primitive == Primitive; }))
+	{
+		return;
+	}
+
+	FDynamicLedges& DynamicLedges = DynamicPrimitives.AddDefaulted_GetRef();
+	DynamicLedges.Primitive = Primitive;
+	DynamicLedges.BakeSettings = BakeSettings;
+	Primitive->TransformUpdated.AddUObject(this, &UParkourLedgeSubsystem::OnDynamicTransformUpdated);
+	PrepareDynamicLedges(DynamicLedges);
+}
+
+void UParkourLedgeSubsystem::UnregisterDynamicPrimitive(UPrimitiveComponent* Primitive)
+{
+	if (Primitive)
+	{
+		Primitive->TransformUpdated.RemoveAll(this);
+	}
+	DynamicPrimitives.RemoveAllSwap([Primitive](const FDynamicLedges& DynamicLedges) { return DynamicLedges.Primitive == Primitive || DynamicLedges.Primitive.IsValid() == false; });
+}
+
+void UParkourLedgeSubsystem::InvalidateDynamicPrimitive(const UPrimitiveComponent* Primitive)
+{
+	for (FDynamicLedges& DynamicLedges : DynamicPrimitives)
+	{
+		if (DynamicLedges.Primitive == Primitive)
+		{
+			PrepareDynamicLedges(DynamicLedges);
+		}
+	}
+}
+
+bool UParkourLedgeSubsystem::HasDynamicGeometry(const FBox& Bounds) const
+{
+	for (const FDynamicLedges& DynamicLedges : DynamicPrimitives)
+	{
+		const UPrimitiveComponent* Primitive = DynamicLedges.Primitive.Get();
+		if (Primitive && Primitive->Bounds.GetBox().Intersect(Bounds))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void UParkourLedgeSubsystem::AddPrefetchActor(const AActor* Actor)
+{
+	PrefetchActors.AddUnique(Actor);
+}
+
+void UParkourLedgeSubsystem::RemovePrefetchActor(const AActor* Actor)
+{
+	PrefetchActors.Remove(Actor);
+}
+
+bool UParkourLedgeSubsystem::IsCovered(const FVector& Location) const
+{
+	bool bCovered = false;
+	for (const FChunkIndex& ChunkIndex : Chunks)
+	{
+		if (ChunkIndex.Chunk->Bounds.IsInsideOrOn(Location))
+		{
+			// Changed collision the bake has not caught up with is traced, wherever it lies.
+			if (ChunkIndex.Chunk->IsStale(Location))
+			{
+				return false;
+			}
+			bCovered = true;
+		}
+	}
+	return bCovered;
+}
+
+bool UParkourLedgeSubsystem::IsCovered(const FBox& Bounds) const
+{
+	for (const FChunkIndex& ChunkIndex : Chunks)
+	{
+		if (ChunkIndex.Chunk->IsStale(Bounds))
+		{
+			return false;
+		}
+	}
+
+	for (FDynamicLedges& DynamicLedges : DynamicPrimitives)
+	{
+		const UPrimitiveComponent* Primitive = DynamicLedges.Primitive.Get();
+		if (Primitive && Primitive->Bounds.GetBox().Intersect(Bounds) && UpdateDynamicLedges(DynamicLedges) == nullptr)
+		{
+			return false;
+		}
+	}
+
+	// The regions are boxes, so a box whose corners are all covered is covered unless it spans a hole between regions.
+	for (int Corner = 0; Corner < 8; Corner++)
+	{
+		const FVector Point((Corner & 1) ? Bounds.Max.X : Bounds.Min.X, (Corner & 2) ? Bounds.Max.Y : Bounds.Min.Y, (Corner & 4) ? Bounds.Max.Z : Bounds.Min.Z);
+		if (IsCovered(Point) == false)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool UParkourLedgeSubsystem::FindLedge(const FParkourLedgeQuery& Query, FParkourLedge& OutLedge, FVector& OutEdgePoint) const
+{
+	PARKOUR_SCOPE_CYCLE_COUNTER(LedgeLookup);
+
+	if (Query.Forward.GetSafeNormal2D().IsNearlyZero())
+	{
+		return false;
+	}
+
+	bool bFound = false;
+	float BestDistance = 0;
+	auto MatchLedge = [&](const FParkourLedge& Ledge)
+	{
+		FVector EdgePoint;
+		float ForwardDistance;
+		if (Query.Match(Ledge, EdgePoint, ForwardDistance) == false)
+		{
+			return;
+		}
+
+		if (bFound == false || FParkourLedgeQuery::IsBetterMatch(EdgePoint, ForwardDistance, OutEdgePoint, BestDistance))
+		{
+			bFound = true;
+			BestDistance = ForwardDistance;
+			OutEdgePoint = EdgePoint;
+			OutLedge = Ledge;
+		}
+	};
+
+	const FBox QueryBounds = Query.GetBounds();
+	const FIntVector MinCell = GetCell(QueryBounds.Min);
+	const FIntVector MaxCell = GetCell(QueryBounds.Max);
+
+	TSet<int32> Visited;
+	for (const FChunkIndex& ChunkIndex : Chunks)
+	{
+		// Unpacked ledges can stick out of the chunk bounds by the packing error.
+		if (ChunkIndex.Chunk->Bounds.ExpandBy(ChunkIndex.Chunk->GetPackingError()).Intersect(QueryBounds) == false)
+		{
+			continue;
+		}
+
+		Visited.Reset();
+		for (int X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			for (int Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			{
+				for (int Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+				{
+					const TArray<int32>* Cell = ChunkIndex.Cells.Find(FIntVector(X, Y, Z));
+					if (Cell == nullptr)
+					{
+						continue;
+					}
+
+					for (const int32 LedgeIndex : *Cell)
+					{
+						bool bAlreadyVisited = false;
+						Visited.Add(LedgeIndex, &bAlreadyVisited);
+						if (bAlreadyVisited == false)
+						{
+							MatchLedge(ChunkIndex.Chunk->Unpack(LedgeIndex));
+						}
+					}
+				}
+			}
+		}
+	}
+
+	for (FDynamicLedges& DynamicLedges : DynamicPrimitives)
+	{
+		const UPrimitiveComponent* Primitive = DynamicLedges.Primitive.Get();
+		if (Primitive && Primitive->Bounds.GetBox().Intersect(QueryBounds))
+		{
+			if (const TArray<FParkourLedge>* Ledges = UpdateDynamicLedges(DynamicLedges))
+			{
+				for (const FParkourLedge& Ledge : *Ledges)
+				{
+					MatchLedge(Ledge);
+				}
+			}
+		}
+	}
+
+	return bFound;
+}
+
+bool UParkourLedgeSubsystem::FindHop(const FVector& HeldPoint, const FVector& WallNormal, const EParkourDirection Direction, FParkourLedge& OutLedge, FVector& OutLandingPoint) const
+{
+	PARKOUR_SCOPE_CYCLE_COUNTER(LedgeLookup);
+
+	if (Direction == EParkourDirection::NoDirection || Direction >= EParkourDirection::Count)
+	{
+		return false;
+	}
+
+	const uint16 DirectionBit = 1 << (int)Direction;
+	const FVector HeldWallNormal = WallNormal.GetSafeNormal2D();
+	for (const FChunkIndex& ChunkIndex : Chunks)
+	{
+		const FParkourLedgeChunk& Chunk = *ChunkIndex.Chunk;
+		if (Chunk.Bounds.ExpandBy(ParkourHopHeldTolerance + Chunk.GetPackingError()).IsInsideOrOn(HeldPoint) == false || Chunk.IsStale(HeldPoint))
+		{
+			continue;
+		}
+
+		// The held ledge is the closest one facing the same way.
+		int32 HeldIndex = INDEX_NONE;
+		FParkourLedge HeldLedge;
+		float HeldDistanceSquared = FMath::Square(ParkourHopHeldTolerance);
+		ForEachCellLedge(ChunkIndex, FBox(HeldPoint - FVector(ParkourHopHeldTolerance), HeldPoint + FVector(ParkourHopHeldTolerance)), [&](const int32 LedgeIndex)
+		{
+			const FParkourLedge Ledge = Chunk.Unpack(LedgeIndex);
+			const float DistanceSquared = FVector::DistSquared(Ledge.GetClosestPoint(HeldPoint), HeldPoint);
+			if (DistanceSquared <= HeldDistanceSquared && FVector::DotProduct(Ledge.WallNormal, HeldWallNormal) >= ParkourHopMinNormalDot)
+			{
+				HeldIndex = LedgeIndex;
+				HeldLedge = Ledge;
+				HeldDistanceSquared = DistanceSquared;
+			}
+		});
+
+		if (HeldIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		// The graph only knows a hop can go this way from somewhere on the held ledge, the held point decides.
+		bool bFound = false;
+		float BestDistanceSquared = 0;
+		for (const FHopEdge& Hop : GetHops(ChunkIndex, HeldIndex))
+		{
+			if ((Hop.DirectionMask & DirectionBit) == 0)
+			{
+				continue;
+			}
+
+			const FParkourLedge Target = Chunk.Unpack(Hop.TargetLedge);
+			const FVector LandingPoint = Target.GetClosestPoint(HeldPoint);
+			if (GetHopDirection(HeldPoint, LandingPoint, HeldLedge.WallNormal) != Direction || Chunk.IsStale(LandingPoint))
+			{
+				continue;
+			}
+
+			const float DistanceSquared = FVector::DistSquared(HeldPoint, LandingPoint);
+			if (bFound == false || DistanceSquared < BestDistanceSquared)
+			{
+				bFound = true;
+				BestDistanceSquared = DistanceSquared;
+				OutLedge = Target;
+				OutLandingPoint = LandingPoint;
+			}
+		}
+
+		if (bFound)
+		{
+			return HasDynamicGeometry(FBox(HeldPoint.ComponentMin(OutLandingPoint), HeldPoint.ComponentMax(OutLandingPoint)).ExpandBy(ParkourHopMaxWallOffset)) == false;
+		}
+	}
+	return false;
+}
+
+bool UParkourLedgeSubsystem::HasLedgeNear(const FVector& Location, const float Radius) const
+{
+	PARKOUR_SCOPE_CYCLE_COUNTER(LedgeLookup);
+
+	const FBox NearBounds(Location - FVector(Radius), Location + FVector(Radius));
+	const FIntVector MinCell = GetCell(NearBounds.Min);
+	const FIntVector MaxCell = GetCell(NearBounds.Max);
+	for (const FChunkIndex& ChunkIndex : Chunks)
+	{
+		if (ChunkIndex.Chunk->Bounds.ExpandBy(ChunkIndex.Chunk->GetPackingError()).Intersect(NearBounds) == false)
+		{
+			continue;
+		}
+
+		for (int X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			for (int Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			{
+				for (int Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+				{
+					if (const TArray<int32>* Cell = ChunkIndex.Cells.Find(FIntVector(X, Y, Z)))
+					{
+						for (const int32 LedgeIndex : *Cell)
+						{
+							if (FVector::DistSquared(ChunkIndex.Chunk->Unpack(LedgeIndex).GetClosestPoint(Location), Location) <= FMath::Square(Radius))
+							{
+								return true;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	for (FDynamicLedges& DynamicLedges : DynamicPrimitives)
+	{
+		const UPrimitiveComponent* Primitive = DynamicLedges.Primitive.Get();
+		if (Primitive == nullptr || Primitive->Bounds.GetBox().Intersect(NearBounds) == false)
+		{
+			continue;
+		}
+
+		if (const TArray<FParkourLedge>* Ledges = UpdateDynamicLedges(DynamicLedges))
+		{
+			for (const FParkourLedge& Ledge : *Ledges)
+			{
+				if (FVector::DistSquared(Ledge.GetClosestPoint(Location), Location) <= FMath::Square(Radius))
+				{
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+bool UParkourLedgeSubsystem::GetStreamingSources(TArray<FWorldPartitionStreamingSource>& OutStreamingSources) const
+{
+	bool bAdded = false;
+	for (const TWeakObjectPtr<const AActor>& PrefetchActor : PrefetchActors)
+	{
+		const AActor* Actor = PrefetchActor.Get();
+		if (Actor == nullptr)
+		{
+			continue;
+		}
+
+		const FVector Velocity = Actor->GetVelocity();
+		if (Velocity.SizeSquared() < FMath::Square(ParkourLedgePrefetchMinSpeed))
+		{
+			continue;
+		}
+
+		// One sphere over the whole path, so nothing between the actor and where it is heading is left out.
+		const FVector Travel = Velocity * ParkourLedgePrefetchTime;
+		FWorldPartitionStreamingSource& Source = OutStreamingSources.AddDefaulted_GetRef();
+		Source.Name = FName(*FString::Printf(TEXT("ParkourLedgePrefetch_%s"), *Actor->GetName()));
+		Source.Location = Actor->GetActorLocation() + (Travel * 0.5);
+		Source.Rotation = Velocity.Rotation();
+		Source.TargetState = EStreamingSourceTargetState::Activated;
+		Source.Priority = EStreamingSourcePriority::Low;
+
+		FStreamingSourceShape& Shape = Source.Shapes.AddDefaulted_GetRef();
+		Shape.bUseGridLoadingRange = false;
+		Shape.Radius = (Travel.Size() * 0.5) + ParkourLedgePrefetchMargin;
+		bAdded = true;
+	}
+	return bAdded;
+}
+
+void UParkourLedgeSubsystem::IndexChunk(FChunkIndex& ChunkIndex) const
+{
+	for (int32 LedgeIndex = 0; LedgeIndex < ChunkIndex.Chunk->Num(); LedgeIndex++)
+	{
+		const FBox Bounds = ChunkIndex.Chunk->Unpack(LedgeIndex).GetBounds();
+		const FIntVector MinCell = GetCell(Bounds.Min);
+		const FIntVector MaxCell = GetCell(Bounds.Max);
+		for (int X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			for (int Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			{
+				for (int Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+				{
+					ChunkIndex.Cells.FindOrAdd(FIntVector(X, Y, Z)).Add(LedgeIndex);
+				}
+			}
+		}
+	}
+}
+
+const TArray<UParkourLedgeSubsystem::FHopEdge>& UParkourLedgeSubsystem::GetHops(const FChunkIndex& ChunkIndex, const int32 LedgeIndex) const
+{
+	if (const TArray<FHopEdge>* Hops = ChunkIndex.Hops.Find(LedgeIndex))
+	{
+		return *Hops;
+	}
+
+	// Only the ledges a character actually hops from get edges, most of a streamed chunk is never held.
+	const SIZE_T HopsSizeBefore = ChunkIndex.Hops.GetAllocatedSize();
+	TArray<FHopEdge>& Hops = ChunkIndex.Hops.Add(LedgeIndex);
+	const FParkourLedge Ledge = ChunkIndex.Chunk->Unpack(LedgeIndex);
+
+	TSet<int32> Visited;
+	ForEachCellLedge(ChunkIndex, Ledge.GetBounds().ExpandBy(ParkourHopMaxOffset), [&](const int32 TargetIndex)
+	{
+		bool bAlreadyVisited = false;
+		Visited.Add(TargetIndex, &bAlreadyVisited);
+		if (bAlreadyVisited || TargetIndex == LedgeIndex)
+		{
+			return;
+		}
+
+		const FParkourLedge Target = ChunkIndex.Chunk->Unpack(TargetIndex);
+		if (FVector::DotProduct(Ledge.WallNormal, Target.WallNormal) < ParkourHopMinNormalDot)
+		{
+			return;
+		}
+
+		// Where the hop goes depends on where the ledge is held, the ends and the point closest to Target bound that.
+		FVector ClosestPoint;
+		FVector TargetClosestPoint;
+		FMath::SegmentDistToSegmentSafe(Ledge.Start, Ledge.End, Target.Start, Target.End, ClosestPoint, TargetClosestPoint);
+
+		uint16 DirectionMask = 0;
+		for (const FVector& From : { Ledge.Start, Ledge.End, ClosestPoint })
+		{
+			const EParkourDirection Direction = GetHopDirection(From, Target.GetClosestPoint(From), Ledge.WallNormal);
+			if (Direction != EParkourDirection::NoDirection)
+			{
+				DirectionMask |= 1 << (int)Direction;
+			}
+		}
+
+		if (DirectionMask != 0)
+		{
+			FHopEdge& Hop = Hops.AddDefaulted_GetRef();
+			Hop.TargetLedge = TargetIndex;
+			Hop.DirectionMask = DirectionMask;
+		}
+	});
+
+	const SIZE_T HopsSize = ChunkIndex.Hops.GetAllocatedSize() - HopsSizeBefore + Hops.GetAllocatedSize();
+	ChunkIndex.AllocatedSize += HopsSize;
+	INC_MEMORY_STAT_BY(STAT_ParkourLedgeMemory, HopsSize);
+	return Hops;
+}
+
+void UParkourLedgeSubsystem::ForEachCellLedge(const FChunkIndex& ChunkIndex, const FBox& Bounds, TFunctionRef<void(int32 LedgeIndex)> Function) const
+{
+	const FIntVector MinCell = GetCell(Bounds.Min);
+	const FIntVector MaxCell = GetCell(Bounds.Max);
+	for (int X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				if (const TArray<int32>* Cell = ChunkIndex.Cells.Find(FIntVector(X, Y, Z)))
+				{
+					for (const int32 LedgeIndex : *Cell)
+					{
+						Function(LedgeIndex);
+					}
+				}
+			}
+		}
+	}
+}
+
+void UParkourLedgeSubsystem::OnDynamicTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	// Only noted here, a lift moves every frame while its ledges are only needed when a scan reaches it.
+	for (FDynamicLedges& DynamicLedges : DynamicPrimitives)
+	{
+		if (DynamicLedges.Primitive == Component)
+		{
+			DynamicLedges.bPlaced = false;
+		}
+	}
+}
+
+void UParkourLedgeSubsystem::PrepareDynamicLedges(FDynamicLedges& DynamicLedges)
+{
+	DynamicLedges.bBaked = false;
+	DynamicLedges.bPlaced = false;
+	DynamicLedges.LocalLedges.Reset();
+
+	// Mesh space is component space, so a template is used as it is. Instances each have their own transform.
+	const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(DynamicLedges.Primitive.Get());
+	const UParkourLedgeTemplateUserData* Template = (MeshComponent && MeshComponent->IsA<UInstancedStaticMeshComponent>() == false) ? UParkourLedgeTemplateUserData::Get(MeshComponent->GetStaticMesh()) : nullptr;
+	if (Template)
+	{
+		DynamicLedges.LocalLedges = Template->Ledges;
+		DynamicLedges.bBaked = true;
+	}
+	else if (DynamicBakeTimerHandle.IsValid() == false)
+	{
+		DynamicBakeTimerHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UParkourLedgeSubsystem::BakeNextDynamicPrimitive);
+	}
+}
+
+void UParkourLedgeSubsystem::BakeNextDynamicPrimitive()
+{
+	DynamicBakeTimerHandle.Invalidate();
+
+	FDynamicLedges* DynamicLedges = DynamicPrimitives.FindByPredicate([](const FDynamicLedges& Candidate) { return Candidate.bBaked == false && Candidate.Primitive.IsValid(); });
+	if (DynamicLedges == nullptr)
+	{
+		return;
+	}
+
+	const UPrimitiveComponent* Primitive = DynamicLedges->Primitive.Get();
+	TArray<FParkourLedge> Ledges;
+	FParkourLedgeBaker(Primitive, DynamicLedges->BakeSettings).BakeRegion(Primitive->Bounds.GetBox().ExpandBy(DynamicLedges->BakeSettings.SampleSpacing), Ledges);
+	UParkourLedgeTemplateUserData::TransformLedges(Primitive->GetComponentTransform().Inverse(), Ledges, DynamicLedges->LocalLedges);
+	DynamicLedges->bBaked = true;
+	DynamicLedges->bPlaced = false;
+
+	if (DynamicPrimitives.ContainsByPredicate([](const FDynamicLedges& Candidate) { return Candidate.bBaked == false && Candidate.Primitive.IsValid(); }))
+	{
+		DynamicBakeTimerHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UParkourLedgeSubsystem::BakeNextDynamicPrimitive);
+	}
+}
+
+const TArray<FParkourLedge>* UParkourLedgeSubsystem::UpdateDynamicLedges(FDynamicLedges& DynamicLedges) const
+{
+	const UPrimitiveComponent* Primitive = DynamicLedges.Primitive.Get();
+	if (Primitive == nullptr || DynamicLedges.bBaked == false)
+	{
+		return nullptr;
+	}
+
+	const FTransform& Transform = Primitive->GetComponentTransform();
+	if (Transform.GetUnitAxis(EAxis::Z).Z < ParkourDynamicLedgeMinUpZ)
+	{
+		return nullptr;
+	}
+
+	if (DynamicLedges.bPlaced == false)
+	{
+		DynamicLedges.WorldLedges.Reset();
+		UParkourLedgeTemplateUserData::TransformLedges(Transform, DynamicLedges.LocalLedges, DynamicLedges.WorldLedges);
+		DynamicLedges.bPlaced = true;
+	}
+	return &DynamicLedges.WorldLedges;
+}
+
+FIntVector UParkourLedgeSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Types/ParkourGameplayTags.h"
+
+namespace ParkourTags
+{
+	UE_DEFINE_GAMEPLAY_TAG(Action_NoAction, "Parkour.Action.NoAction");
+	UE_DEFINE_GAMEPLAY_TAG(Action_ThinVault, "Parkour.Action.ThinVault");
+	UE_DEFINE_GAMEPLAY_TAG(Action_HighVault, "Parkour.Action.HighVault");
+	UE_DEFINE_GAMEPLAY_TAG(Action_Vault, "Parkour.Action.Vault");
+	UE_DEFINE_GAMEPLAY_TAG(Action_Mantle, "Parkour.Action.Mantle");
+	UE_DEFINE_GAMEPLAY_TAG(Action_LowMantle, "Parkour.Action.LowMantle");
+	UE_DEFINE_GAMEPLAY_TAG(Action_Climb, "Parkour.Action.Climb");
+	UE_DEFINE_GAMEPLAY_TAG(Action_FreeHangClimb, "Parkour.Action.FreeHangClimb");
+	UE_DEFINE_GAMEPLAY_TAG(Action_ClimbingUp, "Parkour.Action.ClimbingUp");
+	UE_DEFINE_GAMEPLAY_TAG(Action_FreeHangClimbUp, "Parkour.Action.FreeHangClimbUp");
+	UE_DEFINE_GAMEPLAY_TAG(Action_FallingBraced, "Parkour.Action.FallingBraced");
+	UE_DEFINE_GAMEPLAY_TAG(Action_FallingFreeHang, "Parkour.Action.FallingFreeHang");
+	UE_DEFINE_GAMEPLAY_TAG(Action_DropDown, "Parkour.Action.DropDown");
+	UE_DEFINE_GAMEPLAY_TAG(Action_FreeHangDropDown, "Parkour.Action.FreeHangDropDown");
+	UE_DEFINE_GAMEPLAY_TAG(Action_CornerMove, "Parkour.Action.CornerMove");
+	UE_DEFINE_GAMEPLAY_TAG(Action_ClimbHopDown, "Parkour.Action.ClimbHopDown");
+	UE_DEFINE_GAMEPLAY_TAG(Action_ClimbHopLeft, "Parkour.Action.ClimbHopLeft");
+	UE_DEFINE_GAMEPLAY_TAG(Action_ClimbHopLeftUp, "Parkour.Action.ClimbHopLeftUp");
+	UE_DEFINE_GAMEPLAY_TAG(Action_ClimbHopRight, "Parkour.Action.ClimbHopRight");
+	UE_DEFINE_GAMEPLAY_TAG(Action_ClimbHopRightUp, "Parkour.Action.ClimbHopRightUp");
+	UE_DEFINE_GAMEPLAY_TAG(Action_ClimbHopUp, "Parkour.Action.ClimbHopUp");
+	UE_DEFINE_GAMEPLAY_TAG(Action_FreeClimbHopDown, "Parkour.Action.FreeClimbHopDown");
+	UE_DEFINE_GAMEPLAY_TAG(Action_FreeClimbHopLeft, "Parkour.Action.FreeClimbHopLeft");
+	UE_DEFINE_GAMEPLAY_TAG(Action_FreeClimbHopRight, "Parkour.Action.FreeClimbHopRight");
+
+	UE_DEFINE_GAMEPLAY_TAG(State_NotBusy, "Parkour.State.NotBusy");
+	UE_DEFINE_GAMEPLAY_TAG(State_ReachLedge, "Parkour.State.ReachLedge");
+	UE_DEFINE_GAMEPLAY_TAG(State_Climb, "Parkour.State.Climb");
+	UE_DEFINE_GAMEPLAY_TAG(State_Mantle, "Parkour.State.Mantle");
+	UE_DEFINE_GAMEPLAY_TAG(State_Vault, "Parkour.State.Vault");
+
+	UE_DEFINE_GAMEPLAY_TAG(ClimbStyle, "Parkour.ClimbStyle");
+	UE_DEFINE_GAMEPLAY_TAG(ClimbStyle_Braced, "Parkour.ClimbStyle.Braced");
+	UE_DEFINE_GAMEPLAY_TAG(ClimbStyle_FreeHang, "Parkour.ClimbStyle.FreeHang");
+
+	UE_DEFINE_GAMEPLAY_TAG(Direction_NoDirection, "Parkour.Direction.NoDirection");
+	UE_DEFINE_GAMEPLAY_TAG(Direction_Forward, "Parkour.Direction.Forward");
+	UE_DEFINE_GAMEPLAY_TAG(Direction_Backward, "Parkour.Direction.Backward");
+	UE_DEFINE_GAMEPLAY_TAG(Direction_Left, "Parkour.Direction.Left");
+	UE_DEFINE_GAMEPLAY_TAG(Direction_Right, "Parkour.Direction.Right");
+	UE_DEFINE_GAMEPLAY_TAG(Direction_ForwardLeft, "Parkour.Direction.ForwardLeft");
+	UE_DEFINE_GAMEPLAY_TAG(Direction_ForwardRight, "Parkour.Direction.ForwardRight");
+	UE_DEFINE_GAMEPLAY_TAG(Direction_BackwardLeft, "Parkour.Direction.BackwardLeft");
+	UE_DEFINE_GAMEPLAY_TAG(Direction_BackwardRight, "Parkour.Direction.BackwardRight");
+
+	// Indexed by the enums, so keep them in enum order.
+	static const FNativeGameplayTag* const StateTags[] = { &State_NotBusy, &State_ReachLedge, &State_Climb, &State_Mantle, &State_Vault };
+	static const FNativeGameplayTag* const ClimbStyleTags[] = { &ClimbStyle, &ClimbStyle_Braced, &ClimbStyle_FreeHang };
+	static const FNativeGameplayTag* const DirectionTags[] = { &Direction_NoDirection, &Direction_Forward, &Direction_Backward, &Direction_Left, &Direction_Right, &Direction_ForwardLeft, &Direction_ForwardRight, &Direction_BackwardLeft, &Direction_BackwardRight };
+
+	static_assert(UE_ARRAY_COUNT(StateTags) == (int)EParkourState::Count, "StateTags must match EParkourState");
+	static_assert(UE_ARRAY_COUNT(ClimbStyleTags) == (int)EParkourClimbStyle::Count, "ClimbStyleTags must match EParkourClimbStyle");
+	static_assert(UE_ARRAY_COUNT(DirectionTags) == (int)EParkourDirection::Count, "DirectionTags must match EParkourDirection");
+
+	FGameplayTag FromState(const EParkourState State)
+	{
+		return State < EParkourState::Count ? StateTags[(int)State]->GetTag() : FGameplayTag();
+	}
+
+	EParkourState ToState(const FGameplayTag& Tag)
+	{
+		for (int Index = 0; Index < UE_ARRAY_COUNT(StateTags); Index++)
+		{
+			if (Tag == StateTags[Index]->GetTag())
+			{
+				return (EParkourState)Index;
+			}
+		}
+		return EParkourState::Count;
+	}
+
+	FGameplayTag FromClimbStyle(const EParkourClimbStyle Style)
+	{
+		return Style < EParkourClimbStyle::Count ? ClimbStyleTags[(int)Style]->GetTag() : FGameplayTag();
+	}
+
+	FGameplayTag FromDirection(const EParkourDirection Direction)
+	{
+		return Direction < EParkourDirection::Count ? DirectionTags[(int)Direction]->GetTag() : FGameplayTag();
+	}
+
+	EParkourDirection ToDirection(const FGameplayTag& Tag)
+	{
+		for (int Index = 0; Index < UE_ARRAY_COUNT(DirectionTags); Index++)
+		{
+			if (Tag == DirectionTags[Index]->GetTag())
+			{
+				return (EParkourDirection)Index;
+			}
+		}
+		return EParkourDirection::Count;
+	}
+
+	FGameplayTag HopAction(const EParkourDirection Direction, const EParkourClimbStyle Style)
+	{
+		// Free hanging there is nothing to push off upwards, and the diagonal hops down use the sideways ones.
+		if (Style == EParkourClimbStyle::FreeHang)
+		{
+			switch (Direction)
+			{
+			case EParkourDirection::Backward:
+				return Action_FreeClimbHopDown;
+			case EParkourDirection::Left:
+			case EParkourDirection::BackwardLeft:
+				return Action_FreeClimbHopLeft;
+			case EParkourDirection::Right:
+			case EParkourDirection::BackwardRight:
+				return Action_FreeClimbHopRight;
+			default:
+				return FGameplayTag();
+			}
+		}
+
+		switch (Direction)
+		{
+		case EParkourDirection::Forward:
+			return Action_ClimbHopUp;
+		case EParkourDirection::Backward:
+			return Action_ClimbHopDown;
+		case EParkourDirection::Left:
+		case EParkourDirection::BackwardLeft:
+			return Action_ClimbHopLeft;
+		case EParkourDirection::Right:
+		case EParkourDirection::BackwardRight:
+			return Action_ClimbHopRight;
+		case EParkourDirection::ForwardLeft:
+			return Action_ClimbHopLeftUp;
+		case EParkourDirection::ForwardRight:
+			return Action_ClimbHopRightUp;
+		default:
+			return FGameplayTag();
+		}
+	}
+}
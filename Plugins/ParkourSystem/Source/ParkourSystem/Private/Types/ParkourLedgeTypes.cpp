@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Types/ParkourLedgeTypes.h"
+
+FBox FParkourLedgeQuery::GetBounds() const
+{
+	const FVector ForwardLine = Forward.GetSafeNormal2D();
+	const FVector Reach = ForwardLine * MaxReach;
+	const FVector Side = FVector(-ForwardLine.Y, ForwardLine.X, 0) * MaxSideOffset;
+
+	FBox Bounds(ForceInit);
+	Bounds += FVector(Location.X, Location.Y, MinTopZ) - Side;
+	Bounds += FVector(Location.X, Location.Y, MinTopZ) + Side;
+	Bounds += FVector(Location.X, Location.Y, MaxTopZ) + Reach - Side;
+	Bounds += FVector(Location.X, Location.Y, MaxTopZ) + Reach + Side;
+	return Bounds;
+}
+
+bool FParkourLedgeQuery::Match(const FParkourLedge& Ledge, FVector& OutEdgePoint, float& OutForwardDistance) const
+{
+	const FVector ForwardLine = Forward.GetSafeNormal2D();
+	if (ForwardLine.IsNearlyZero() || FVector::DotProduct(-Ledge.WallNormal, ForwardLine) <= 0.5f)
+	{
+		return false;
+	}
+
+	// Where the forward line crosses the edge in 2D, clamped onto the segment.
+	const FVector Right = FVector(-ForwardLine.Y, ForwardLine.X, 0);
+	const FVector EdgeDelta = Ledge.End - Ledge.Start;
+	const float Denominator = (ForwardLine.X * EdgeDelta.Y) - (ForwardLine.Y * EdgeDelta.X);
+	float Alpha = 0;
+	if (FMath::Abs(Denominator) > KINDA_SMALL_NUMBER)
+	{
+		const FVector ToStart = Ledge.Start - Location;
+		Alpha = FMath::Clamp(((ForwardLine.Y * ToStart.X) - (ForwardLine.X * ToStart.Y)) / Denominator, 0.0f, 1.0f);
+	}
+	const FVector EdgePoint = Ledge.Start + (EdgeDelta * Alpha);
+
+	const FVector ToEdge = EdgePoint - Location;
+	const float ForwardDistance = FVector::DotProduct(ToEdge, ForwardLine);
+	if (ForwardDistance <= 0 || ForwardDistance > MaxReach)
+	{
+		return false;
+	}
+	if (FMath::Abs(FVector::DotProduct(ToEdge, Right)) > MaxSideOffset)
+	{
+		return false;
+	}
+	if (EdgePoint.Z < MinTopZ || EdgePoint.Z > MaxTopZ)
+	{
+		return false;
+	}
+
+	OutEdgePoint = EdgePoint;
+	OutForwardDistance = ForwardDistance;
+	return true;
+}
+
+bool FParkourLedgeQuery::IsBetterMatch(const FVector& EdgePoint, const float ForwardDistance, const FVector& BestEdgePoint, const float BestForwardDistance)
+{
+	return EdgePoint.Z < BestEdgePoint.Z - 1.0f
+		|| (FMath::Abs(EdgePoint.Z - BestEdgePoint.Z) <= 1.0f && ForwardDistance < BestForwardDistance);
+}
+
+const FParkourLedge* FParkourLedgeQuery::FindBest(TConstArrayView<FParkourLedge> Ledges, FVector& OutEdgePoint) const
+{
+	const FParkourLedge* BestLedge = nullptr;
+	float BestDistance = 0;
+	for (const FParkourLedge& Ledge : Ledges)
+	{
+		FVector EdgePoint;
+		float ForwardDistance;
+		if (Match(Ledge, EdgePoint, ForwardDistance))
+		{
+			if (BestLedge == nullptr || IsBetterMatch(EdgePoint, ForwardDistance, OutEdgePoint, BestDistance))
+			{
+				BestLedge = &Ledge;
+				BestDistance = ForwardDistance;
+				OutEdgePoint = EdgePoint;
+			}
+		}
+	}
+	return BestLedge;
+}
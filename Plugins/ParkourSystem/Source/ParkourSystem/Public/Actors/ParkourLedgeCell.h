@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Ledges/ParkourLedgeChunk.h"
+#include "ParkourLedgeCell.generated.h"
+
+class AParkourLedgeVolume;
+
+/**
+ * The baked ledges of one streaming cell of an AParkourLedgeVolume. It sits in the middle of its cell, so World Partition
+ * or the streaming level it was baked into loads the ledges with the rest of the cell and drops them again with it.
+ */
+UCLASS(NotPlaceable)
+class PARKOURSYSTEM_API AParkourLedgeCell : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	AParkourLedgeCell();
+
+	const FParkourLedgeChunk& GetChunk() const { return Chunk; }
+
+#if WITH_EDITOR
+	void SetLedges(AParkourLedgeVolume* Volume, const FBox& Region, TConstArrayView<FParkourLedge> Ledges);
+
+	bool WasBakedBy(const AParkourLedgeVolume* Volume) const;
+
+	FParkourLedgeChunk& GetMutableChunk() { return Chunk; }
+#endif
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+
+	UPROPERTY(VisibleAnywhere, Category = Parkour)
+	FParkourLedgeChunk Chunk;
+
+#if WITH_EDITORONLY_DATA
+	/** Soft, so the volume is not pulled into every cell it baked. */
+	UPROPERTY(VisibleAnywhere, Category = Parkour)
+	TSoftObjectPtr<AParkourLedgeVolume> SourceVolume;
+#endif
+};
@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Volume.h"
+#include "Ledges/ParkourLedgeBaker.h"
+#include "ParkourLedgeVolume.generated.h"
+
+class UParkourLedgeDataAsset;
+struct FParkourLedgeChunk;
+
+/**
+ * Marks a region whose ledges are baked into LedgeData, or into one AParkourLedgeCell per streaming cell for maps too
+ * big to hold all their ledges at once. Inside the baked bounds the parkour component uses the ledge database instead
+ * of tracing the wall.
+ */
+UCLASS()
+class PARKOURSYSTEM_API AParkourLedgeVolume : public AVolume
+{
+	GENERATED_BODY()
+
+public:
+
+	AParkourLedgeVolume();
+
+	UParkourLedgeDataAsset* GetLedgeData() const { return LedgeData; }
+
+#if WITH_EDITOR
+	/** Bakes the ledges inside the volume into LedgeData or its streaming cells. */
+	UFUNCTION(CallInEditor, Category = Parkour)
+	void BakeLedges();
+
+	void BakeLedges(FParkourLedgeBakeStats& OutStats);
+
+	/** Marks the baked ledges whose probes reach ChangedBounds stale. False when none of them do. */
+	bool MarkLedgesStale(const FBox& ChangedBounds);
+
+	/** Bakes the stale regions of the baked ledges again, in place. */
+	void RebakeStaleLedges(FParkourLedgeBakeStats& OutStats);
+
+	void GetStaleRegions(TArray<FBox>& OutRegions) const;
+#endif
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Parkour, meta = (AllowPrivateAccess = "true"))
+	UParkourLedgeDataAsset* LedgeData;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Parkour, meta = (AllowPrivateAccess = "true"))
+	FParkourLedgeBakeSettings BakeSettings;
+
+	/** Bake into AParkourLedgeCell actors that stream with the level instead of into LedgeData. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Parkour, meta = (AllowPrivateAccess = "true"))
+	bool bBakeStreamingCells = false;
+
+	/** Size of the streaming cells, keep it at the cell size of the World Partition runtime grid they go into. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Parkour, meta = (AllowPrivateAccess = "true", EditCondition = "bBakeStreamingCells", ClampMin = "1000"))
+	float StreamingCellSize = 25600.0f;
+
+#if WITH_EDITOR
+	void BakeStreamingCells(const FBox& Region, FParkourLedgeBakeStats& OutStats);
+
+	/** Calls Function with LedgeData's chunk or the chunks of the loaded cells, and the object that saves each of them. */
+	void ForEachBakedChunk(TFunctionRef<void(UObject& Owner, FParkourLedgeChunk& Chunk)> Function) const;
+#endif
+};
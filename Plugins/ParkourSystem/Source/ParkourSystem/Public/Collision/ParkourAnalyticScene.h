@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Collision/ParkourCollisionScene.h"
+
+/** A box of an analytic scene, only ever turned about Z. */
+struct FParkourAnalyticBox
+{
+	FVector Center = FVector::ZeroVector;
+
+	FVector HalfSize = FVector::ZeroVector;
+
+	FQuat Rotation = FQuat::Identity;
+};
+
+/**
+ * A scene of boxes and floor slabs answered without physics, so scans can run against it headless.
+ * Sweeps test against the box grown by the query shape, which is exact for lines and boxes and treats
+ * the rounded edges of sphere and capsule sweeps as square.
+ */
+class PARKOURSYSTEM_API FParkourAnalyticScene : public IParkourCollisionScene
+{
+public:
+
+	void AddBox(const FVector& Center, const FVector& HalfSize, const FRotator& Rotation = FRotator::ZeroRotator);
+
+	/** A floor layer without horizontal bounds, its top at TopZ. */
+	void AddSlab(const float TopZ, const float Thickness = 20);
+
+	void Reset() { Boxes.Reset(); }
+
+	const TArray<FParkourAnalyticBox>& GetBoxes() const { return Boxes; }
+
+	virtual bool Sweep(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, FHitResult& OutHit) const override;
+
+	/** Hits carry the index of the box they landed on as their Item. */
+	virtual bool GetHitElement(const FHitResult& Hit, FParkourCollisionElement& OutElement) const override;
+
+private:
+
+	bool SweepBox(const FParkourAnalyticBox& Box, const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, FHitResult& OutHit) const;
+
+	TArray<FParkourAnalyticBox> Boxes;
+};
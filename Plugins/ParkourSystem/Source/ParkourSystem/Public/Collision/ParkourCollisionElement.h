@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBodySetup;
+struct FParkourLedge;
+
+/**
+ * One convex element of a body's simple collision in world space. Boxes and convex hulls are kept as their
+ * face planes, spheres and capsules as a segment and a radius.
+ */
+struct PARKOURSYSTEM_API FParkourCollisionElement
+{
+	static FParkourCollisionElement MakeBox(const FTransform& ElementTransform, const FVector& HalfSize, const FTransform& BodyTransform);
+
+	static FParkourCollisionElement MakeCapsule(const FVector& Start, const FVector& End, const float Radius);
+
+	/** Appends the elements of BodySetup's simple collision, with the body placed at BodyTransform. */
+	static void GatherElements(const UBodySetup& BodySetup, const FTransform& BodyTransform, TArray<FParkourCollisionElement>& OutElements);
+
+	/** Adds the face through Point with the outward Normal, both given in the space of ElementTransform inside BodyTransform. */
+	void AddPlane(const FVector& Point, const FVector& Normal, const FTransform& ElementTransform, const FTransform& BodyTransform);
+
+	/** Negative inside and positive outside. For planes only the sign and the surface itself are exact. */
+	double GetSignedDistance(const FVector& Point) const;
+
+	/** Outward normal of the surface nearest to Point. */
+	FVector GetNormal(const FVector& Point) const;
+
+	/** How far a ray from Point, which has to be inside, travels along Direction before it leaves. MaxDistance when it does not. */
+	double GetExitDistance(const FVector& Point, const FVector& Direction, const double MaxDistance) const;
+
+	/**
+	 * Works out the ledge above WallPoint on the element's side the way the wall scan sees it: the top straight above
+	 * the face, the edge where the face meets it and the far edge across it. Depth stays 0 when the far edge is more
+	 * than MaxDepth away. False when the top is more than MaxRise above WallPoint or too steep to stand on.
+	 */
+	bool ExtractLedge(const FVector& WallPoint, const float MaxRise, const float MaxDepth, FParkourLedge& OutLedge) const;
+
+	/** Face planes with outward normals, empty for spheres and capsules. */
+	TArray<FPlane> Planes;
+
+	FVector SegmentStart = FVector::ZeroVector;
+
+	FVector SegmentEnd = FVector::ZeroVector;
+
+	float Radius = 0;
+};
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "CollisionQueryParams.h"
+
+class UWorld;
+struct FParkourCollisionElement;
+class UParkourLedgeTemplateUserData;
+
+enum class EParkourTraceShape : uint8
+{
+	Line,
+	Sphere,
+	Capsule,
+	Box
+};
+
+/** Answers the collision queries of the parkour scans. */
+class PARKOURSYSTEM_API IParkourCollisionScene
+{
+public:
+
+	virtual ~IParkourCollisionScene() = default;
+
+	/**
+	 * Single blocking sweep from Start to End, with the same results a visibility channel sweep gives.
+	 * Extent holds the sphere radius in X, the capsule radius and half height in X and Z, or the box half size.
+	 */
+	virtual bool Sweep(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, FHitResult& OutHit) const = 0;
+
+	/**
+	 * The simple collision element a hit of this scene landed on. False when the scene cannot tell,
+	 * or when the body it hit is traced against something else than its simple collision.
+	 */
+	virtual bool GetHitElement(const FHitResult& Hit, FParkourCollisionElement& OutElement) const { return false; }
+
+	/** The ledge template of the static mesh a hit of this scene landed on, and where that mesh or instance is placed. */
+	virtual const UParkourLedgeTemplateUserData* GetHitLedgeTemplate(const FHitResult& Hit, FTransform& OutTransform) const { return nullptr; }
+};
+
+/** The scene of a world, queried on the visibility channel. */
+class PARKOURSYSTEM_API FParkourWorldCollisionScene : public IParkourCollisionScene
+{
+public:
+
+	FParkourWorldCollisionScene(const UWorld* InWorld, const FCollisionQueryParams& InQueryParams);
+
+	virtual bool Sweep(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, FHitResult& OutHit) const override;
+
+	virtual bool GetHitElement(const FHitResult& Hit, FParkourCollisionElement& OutElement) const override;
+
+	virtual const UParkourLedgeTemplateUserData* GetHitLedgeTemplate(const FHitResult& Hit, FTransform& OutTransform) const override;
+
+private:
+
+	TWeakObjectPtr<const UWorld> World;
+
+	FCollisionQueryParams QueryParams;
+};
@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "ParkourCharacterMovementComponent.generated.h"
+
+/** Custom movement modes of UParkourCharacterMovementComponent, used with MOVE_Custom. */
+UENUM(BlueprintType)
+enum class EParkourCustomMovementMode : uint8
+{
+	/** Hanging from a ledge. The parkour component places the character along the ledge, only montage root motion is simulated. */
+	Climb
+};
+
+/**
+ * Character movement with a climb mode for UParkourMovementComponent. Characters without it climb in MOVE_Flying,
+ * which runs the flying simulation every frame for a character the parkour component positions itself.
+ */
+UCLASS()
+class PARKOURSYSTEM_API UParkourCharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual void PhysCustom(float DeltaTime, int32 Iterations) override;
+};
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Ledges/ParkourLedgeBaker.h"
+#include "ParkourDynamicLedgeComponent.generated.h"
+
+/**
+ * Marks an actor whose geometry moves or changes at runtime, like doors, lifts and destructible crates. Ledge bakes
+ * leave it out, and the ledge subsystem keeps the ledges of its primitives in component space and moves them with
+ * the primitives instead. Static meshes with a ledge template use the template, other primitives are baked on their own
+ * over the frames after BeginPlay, one per frame, and traced until then.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class PARKOURSYSTEM_API UParkourDynamicLedgeComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UParkourDynamicLedgeComponent();
+
+	/** Bakes the ledges of the actor again on a later frame. Call it when its shape changed, moving is followed without it. */
+	UFUNCTION(BlueprintCallable, Category = Parkour)
+	void InvalidateLedges();
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Parkour, meta = (AllowPrivateAccess = "true"))
+	FParkourLedgeBakeSettings BakeSettings;
+
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> Primitives;
+};
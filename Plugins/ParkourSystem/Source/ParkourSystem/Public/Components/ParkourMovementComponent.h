@@ -7,12 +7,72 @@
 #include "Interfaces/ParkourInterface.h"
 #include "GameplayTagContainer.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "WorldCollision.h"
+#include "Types/ParkourScanContext.h"
+#include "Types/ParkourClimbTracker.h"
+#include "Types/ParkourStateTypes.h"
+#include "Stats/ParkourStats.h"
+#include "Replay/ParkourTraceRecording.h"
 #include "ParkourMovementComponent.generated.h"
 
 class UCharacterMovementComponent;
 class UCapsuleComponent;
 class UParkourVariablesDataAsset;
+class UParkourActionRegistryDataAsset;
+struct FStreamableHandle;
 class UArrowComponent;
+struct FParkourLedge;
+
+UENUM(BlueprintType)
+enum class EParkourWallProbeMode : uint8
+{
+	/** Sweep every height row at every forward step. */
+	Grid,
+	/** Rule out empty height ranges with one bounding sweep and bisect the rest down to single rows. */
+	Hierarchical
+};
+
+UENUM(BlueprintType)
+enum class EParkourActivationMode : uint8
+{
+	/** Run AutoClimb every tick, like a plain component. */
+	AlwaysTick,
+	/** Stop ticking while grounded and not busy, and wake on movement events or near baked ledges. */
+	EventDriven
+};
+
+/** Tick interval of the component in each parkour state, 0 ticks every frame. */
+USTRUCT(BlueprintType)
+struct FParkourStateTickIntervals
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Activation)
+	float NotBusy = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Activation)
+	float ReachLedge = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Activation)
+	float Climb = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Activation)
+	float Mantle = 0.1f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Activation)
+	float Vault = 0.1f;
+};
+
+enum class EParkourWallScanStage : uint8
+{
+	None,
+	Grid,
+	Rows,
+	Hop,
+	Top,
+	Depth,
+	Vault
+};
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class PARKOURSYSTEM_API UParkourMovementComponent : public UActorComponent, public IParkourInterface
@@ -27,6 +87,8 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:	
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -35,24 +97,150 @@ public:
 
 	void AddMovementInput(float ScaleValue, bool bFront);
 
+	/** Both axes of one input event, X right and Y forward. Climbing consumes the input once per tick. */
+	void AddMovementInput(const FVector2D& MovementVector);
+
 	UFUNCTION(BlueprintCallable)
 	void ParkourAction(bool bAutoClimb);
 
 	UFUNCTION(BlueprintCallable)
 	void ParkourDrop();
 
+	/** Montages of the registered actions that are currently loaded. */
+	UFUNCTION(BlueprintCallable)
+	void GetResidentMontages(TArray<UAnimMontage*>& OutMontages) const;
+
+	/** True once every registered action montage has finished preloading. */
+	UFUNCTION(BlueprintCallable)
+	bool AreActionMontagesLoaded() const;
+
+	/** Traces issued by the last wall scan, and traces it avoided by reusing scan-scoped results. */
+	void GetLastScanQueryCounts(int& OutQueriesIssued, int& OutQueriesSaved) const;
+
+	/**
+	 * Runs a recorded wall scan again from its snapshot, with the recorded query results standing in for the world.
+	 * Returns the action the scan picks, OutUnmatchedQueries counts queries the recording has no result for.
+	 */
+	FGameplayTag ReplayRecordedScan(const FParkourRecordedScan& Scan, int& OutUnmatchedQueries);
+
+	/**
+	 * Runs a synchronous wall scan from the current pose, or reads the baked ledges where the component uses them,
+	 * and reports the action it picks and what it cost without performing the action.
+	 */
+	FParkourScanEvaluation EvaluateWallScan(const bool bAutoClimb);
+
+	/**
+	 * Runs the drop down search ParkourDrop starts from the current pose without performing the drop.
+	 * The whole search is reported as WallShapeSeconds.
+	 */
+	FParkourScanEvaluation EvaluateDropDown();
+
+	void SetWallProbeMode(const EParkourWallProbeMode NewWallProbeMode) { WallProbeMode = NewWallProbeMode; }
+
+	void SetUseBakedLedges(const bool bNewUseBakedLedges) { bUseBakedLedges = bNewUseBakedLedges; }
+
+	void SetUseSimpleCollisionLedges(const bool bNewUseSimpleCollisionLedges) { bUseSimpleCollisionLedges = bNewUseSimpleCollisionLedges; }
+
+	void SetUseLedgeTemplates(const bool bNewUseLedgeTemplates) { bUseLedgeTemplates = bNewUseLedgeTemplates; }
+
+	/** Answers the collision queries from Scene instead of the world until it is set back to nullptr. */
+	void SetCollisionScene(const IParkourCollisionScene* Scene);
+
+	FGameplayTag GetParkourAction() const { return ParkourActionTag; }
+
+	EParkourState GetParkourState() const { return ParkourState; }
+
 private:
 
 	void CheckWallShape();
 
+	bool ProbeWallGrid(FHitResult& OutHit);
+
+	bool ProbeWallRows(const int FirstRow, const int LastRow, const float ClimbHeight, FHitResult& OutHit);
+
+	/** One box sweep bounding the sphere sweeps of the rows. False means none of them can hit anything. */
+	bool SweepWallRows(const int FirstRow, const int LastRow, const float ClimbHeight);
+
+	void GetWallRowsBox(const int FirstRow, const int LastRow, const float ClimbHeight, FVector& OutStart, FVector& OutEnd, FVector& OutHalfSize, FQuat& OutRotation);
+
+	bool ProbeWallRow(const int Index, const float ClimbHeight, FHitResult& OutHit);
+
+	void GetWallScanTrace(const int Index, const int Index2, const float ClimbHeight, FVector& OutStart, FVector& OutEnd);
+
+	void GetHopTrace(const FHitResult& WallScanHit, const int Index3, FVector& OutStart, FVector& OutEnd);
+
+	bool FindHopLedgeTrace(TConstArrayView<FHitResult> HopHitTraces, FHitResult& OutLedgeTrace);
+
+	void SelectWallHitResult(const TArray<FHitResult>& WallHitTraces);
+
+	void GetWallTopTrace(const int Index5, FVector& OutStart, FVector& OutEnd);
+
+	void BeginAsyncWallScan(const bool bAutoClimb);
+
+	void AsyncLineTrace(const FVector& Start, const FVector& End);
+
+	void AsyncSphereTrace(const FVector& Start, const FVector& End, const float Radius);
+
+	void AsyncBoxTrace(const FVector& Start, const FVector& End, const FVector& HalfSize, const FQuat& Rotation);
+
+	/** Issues the next range of AsyncWallRowRanges, a box sweep for several rows and a sphere sweep for one. */
+	void IssueNextAsyncWallRows();
+
+	void OnAsyncTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	void AdvanceAsyncWallScan();
+
+	void FinishAsyncWallScan();
+
+	void CancelAsyncWallScan();
+
+	void StartWallScan(const bool bAutoClimb);
+
+	void BuildActionRegistry();
+
+	void PreloadActionMontages();
+
+	bool FindBakedWallShape();
+
+	/** Hops to the ledge the hop graph of the baked ledges links towards the climb input, without a wall scan. */
+	bool FindBakedHop();
+
+	void SetWallShapeFromLedge(const FParkourLedge& Ledge, const FVector& EdgePoint);
+
+	/** Reads the wall shape from the body WallScanHit landed on, its mesh's ledge template first and its simple collision second. */
+	bool FindBodyWallShape(const FHitResult& WallScanHit);
+
+	bool FindTemplateWallShape(const IParkourCollisionScene& Scene, const FHitResult& WallScanHit);
+
+	bool FindSimpleCollisionWallShape(const IParkourCollisionScene& Scene, const FHitResult& WallScanHit);
+
+	/** Checks with a few traces that nothing around the body changes its ledge, then takes the wall shape from it. */
+	bool ConfirmBodyLedge(FParkourLedge& Ledge, const FVector& EdgePoint);
+
+	void BuildTraceQueryParams();
+
+	void FinishScanContext(const FParkourScanContext& Context);
+
+	FVector GetScanActorLocation() const;
+
+	FVector GetScanActorForwardVector() const;
+
 	void ShowHitResults();
 
 	void CheckDistance();
 
 	void AutoClimb();
 
+	bool ShouldRunAirborneScan();
+
 	void ParkourType(const bool bAutoClimb);
 
+	void RecordTrace(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, const bool bHit, const FHitResult& Hit);
+
+	void BeginRecordedScan(const bool bAutoClimb, const bool bBaked);
+
+	void EndRecordedScan();
+
 	void ClimbSurface();
 
 	void CheckSurfaceAndSetActionAsHighVault();
@@ -67,15 +255,32 @@ private:
 
 	void SetParkourAction(FGameplayTag NewParkourActionTag);
 
-	void SetParkourState(FGameplayTag NewParkourStateTag);
+	void SetParkourState(const EParkourState NewParkourState);
+
+	void PreviousState(const EParkourState PreviousParkourState, const EParkourState NewParkourState);
+
+	void SetClimbStyle(const EParkourClimbStyle NewClimbStyle);
 
-	void PreviousState(FGameplayTag PreviousParkourStateTag, FGameplayTag NewParkourStateTag);
+	void SetClimbDirection(const EParkourDirection NewDirection);
 
-	void SetClimbStyle(FGameplayTag NewClimbStyle);
+	/** Runs one climb move for the input that arrived since the last tick. */
+	void UpdateClimbMovement(const float DeltaTime);
 
-	void SetClimbDirection(const FGameplayTag NewDirection);
+	void ClimbMovement(const float DeltaTime);
 
-	void ClimbMovement();
+	/** Slides the hands along the tracked ledge segment for one tick of climb input and hangs the character below them. */
+	void MoveAlongClimbLedge(const float DeltaTime);
+
+	/** True while the hands have enough confirmed ledge ahead of them to move without tracing. */
+	bool CanAdvanceAlongClimbLedge();
+
+	/** Actor location relative to the hands for the climb style, with the character facing Rotation. */
+	FVector GetClimbHangOffset(const FRotator& Rotation) const;
+
+	/** Finds the tracked ledge again at the hands with one trace each for the wall, the top and the side. */
+	bool ConfirmClimbLedge(FHitResult& OutWallHit, FHitResult& OutTopHit);
+
+	void UpdateClimbTracker(const FHitResult& WallHit, const FHitResult& TopHit, const int WallRow, const int ClearRow, const bool bSurfaceChecked);
 
 	bool CheckClimbMovementSurface(FHitResult HitResult);
 
@@ -102,6 +307,22 @@ private:
 	UFUNCTION()
 	void OnMontageBlendOut(UAnimMontage* Montage, bool bInterrupted);
 
+	UFUNCTION()
+	void OnMovementModeChanged(ACharacter* Character, EMovementMode PrevMovementMode, uint8 PreviousCustomMode);
+
+	UFUNCTION()
+	void OnLanded(const FHitResult& Hit);
+
+	void WakeUp();
+
+	bool CanSleep() const;
+
+	void Sleep();
+
+	void CheckLedgeProximity();
+
+	void UpdateTickInterval();
+
 	float GetMontageStartTime();
 
 	FVector FindWarpTargetLocation_1(const float WarpXOffset, const float WarpZOffset);
@@ -114,9 +335,11 @@ private:
 
 	float FirstClimbHeight();
 
+	float CalculateFirstClimbHeight();
+
 	FRotator GetDesiredRotation();
 
-	FGameplayTag GetDesiredClimbRotation();
+	EParkourDirection GetDesiredClimbRotation();
 
 	void FindDropDownHangLocation();
 
@@ -140,7 +363,9 @@ private:
 
 	bool CapsuleTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const float Radius, const float HalfHeight, EDrawDebugTrace::Type DrawDebugType = EDrawDebugTrace::None);
 
-	bool BoxTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const FVector& HalfSize, EDrawDebugTrace::Type DrawDebugType = EDrawDebugTrace::None);
+	bool BoxTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const FVector& HalfSize, const FQuat& Rotation, EDrawDebugTrace::Type DrawDebugType = EDrawDebugTrace::None);
+
+	bool QueryCollisionScene(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, FHitResult& OutHit, EDrawDebugTrace::Type DrawDebugType, const FColor& TraceColor, const FColor& HitColor);
 
 public:
 
@@ -187,13 +412,13 @@ private:
 
 	FGameplayTag ParkourActionTag;
 
-	FGameplayTag ParkourStateTag;
+	EParkourState ParkourState;
 
-	FGameplayTag ClimbStyleTag;
+	EParkourClimbStyle ClimbStyle;
 
-	FGameplayTag MontageBlendOutState;
+	EParkourState MontageBlendOutState = EParkourState::NotBusy;
 
-	FGameplayTag ClimbDirectionTag;
+	EParkourDirection ClimbDirection;
 
 	bool bCanAutoClimb;
 
@@ -215,6 +440,109 @@ private:
 
 	EDrawDebugTrace::Type DrawWallShapeTraceDebugType;
 
+	/**
+	 * Send the wall scan through the world's async trace queue one stage at a time instead of blocking on it.
+	 * The press then resolves a few frames later, against the pose the character has by then.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Traces, meta = (AllowPrivateAccess = "true"))
+	bool bUseAsyncWallScan = false;
+
+	/** How CheckWallShape looks for the first wall row. Both modes find the same wall. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Traces, meta = (AllowPrivateAccess = "true"))
+	EParkourWallProbeMode WallProbeMode = EParkourWallProbeMode::Hierarchical;
+
+	/** Read walls from the baked ledge database where the level has one, tracing only outside the baked regions. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Traces, meta = (AllowPrivateAccess = "true"))
+	bool bUseBakedLedges = true;
+
+	/** Work the ledge out from the box, capsule or convex collision of the wall instead of tracing its top, where the wall has one. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Traces, meta = (AllowPrivateAccess = "true"))
+	bool bUseSimpleCollisionLedges = true;
+
+	/** Take the ledge from the template baked into the hit static mesh instead of tracing the top, where the mesh has one. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Traces, meta = (AllowPrivateAccess = "true"))
+	bool bUseLedgeTemplates = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Activation, meta = (AllowPrivateAccess = "true"))
+	EParkourActivationMode ActivationMode = EParkourActivationMode::EventDriven;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Activation, meta = (AllowPrivateAccess = "true"))
+	FParkourStateTickIntervals StateTickIntervals;
+
+	/** While asleep, how often to look for baked ledges around the character. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Activation, meta = (AllowPrivateAccess = "true"))
+	float ProximityCheckInterval = 0.25f;
+
+	/** Waking distance to a baked ledge, 0 disables the proximity wake. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Activation, meta = (AllowPrivateAccess = "true"))
+	float ProximityWakeRadius = 250.0f;
+
+	FTimerHandle ProximityTimerHandle;
+
+	/** While falling, sweep the wall scan's volume along the predicted fall first and only run the scan when it hits something. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Traces, meta = (AllowPrivateAccess = "true"))
+	bool bUseAirbornePreCheck = true;
+
+	/** How far ahead along the fall the pre-check sweeps. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Traces, meta = (AllowPrivateAccess = "true"))
+	float AirborneLookAheadTime = 0.1f;
+
+	FCollisionQueryParams TraceQueryParams;
+
+	FTraceDelegate AsyncTraceDelegate;
+
+	TArray<FTraceHandle> AsyncTraceHandles;
+
+	TArray<FHitResult> AsyncTraceResults;
+
+	int AsyncTracesPending = 0;
+
+	EParkourWallScanStage AsyncWallScanStage = EParkourWallScanStage::None;
+
+	bool bAsyncWallScanAutoClimb;
+
+	EParkourState AsyncWallScanState = EParkourState::NotBusy;
+
+	FParkourScanContext AsyncWallScanContext;
+
+	/** Row ranges the hierarchical async scan has left to probe, the next one last. */
+	TArray<FIntPoint> AsyncWallRowRanges;
+
+	FIntPoint AsyncWallRowRange;
+
+	/** Call site the trace helpers attribute their traces to. */
+	EParkourTraceCallSite TraceCallSite = EParkourTraceCallSite::Other;
+
+	/** Context of the scan currently running, null outside of a scan. */
+	FParkourScanContext* ScanContext = nullptr;
+
+	/** Ledge the last climb move settled on, reset whenever the state or the action changes. */
+	FParkourClimbTracker ClimbTracker;
+
+	/** Movement input arrived while climbing and the next tick has not moved for it yet. */
+	bool bClimbInputPending = false;
+
+	int LastScanQueriesIssued = 0;
+
+	int LastScanQueriesSaved = 0;
+
+	/** Scan being replayed, its recorded results answer the trace helpers instead of the world. */
+	const FParkourRecordedScan* ReplayedScan = nullptr;
+
+	/** Set while EvaluateWallScan runs, actions are only noted in EvaluatedAction. */
+	bool bEvaluatingScan = false;
+
+	FGameplayTag EvaluatedAction;
+
+	/** Scene the trace helpers query instead of the world, set for replays and analytic scenes. */
+	const IParkourCollisionScene* CollisionScene = nullptr;
+
+	TUniquePtr<FParkourWorldCollisionScene> WorldCollisionScene;
+
+	FHitResult AsyncWallScanHit;
+
+	FHitResult AsyncTopHits;
+
 	bool bShowHitResults = true;
 
 	FRotator WallRotation;
@@ -242,42 +570,56 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
 	UParkourVariablesDataAsset* ParkourVariablesDataAsset;
 
+	/** Which variables asset each parkour action plays. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
+	UParkourActionRegistryDataAsset* ActionRegistry;
+
+	/** ActionRegistry merged over the per-action assets below, built by PreloadActionMontages. */
+	UPROPERTY(Transient)
+	TMap<FGameplayTag, UParkourVariablesDataAsset*> ActionDataAssets;
+
+	TSharedPtr<FStreamableHandle> ActionMontagesHandle;
+
+	bool bActionsPreloaded = false;
+
+	// Per-action assets from before ActionRegistry, still read so existing characters keep working. ActionRegistry entries override them.
+	// Soft so a character class does not load them, they are resolved with the rest of the actions by PreloadActionMontages.
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* VaultDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> VaultDataAsset;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* ThinVaultDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> ThinVaultDataAsset;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* HighVaultDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> HighVaultDataAsset;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* MantleDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> MantleDataAsset;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* LowMantleDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> LowMantleDataAsset;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* BracedClimbDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> BracedClimbDataAsset;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* FreeHangClimbDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> FreeHangClimbDataAsset;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* FreeHangClimbUpDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> FreeHangClimbUpDataAsset;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* BracedClimbUpDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> BracedClimbUpDataAsset;
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* FallingBracedDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> FallingBracedDataAsset;
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* FallingFreeHangDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> FallingFreeHangDataAsset;
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* FreeHangDropDownDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> FreeHangDropDownDataAsset;
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataAssets, meta = (AllowPrivateAccess = "true"))
-	UParkourVariablesDataAsset* DropDownDataAsset;
+	TSoftObjectPtr<UParkourVariablesDataAsset> DropDownDataAsset;
 };
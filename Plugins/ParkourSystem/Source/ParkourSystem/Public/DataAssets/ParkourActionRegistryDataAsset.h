@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "GameplayTagContainer.h"
+#include "ParkourActionRegistryDataAsset.generated.h"
+
+class UParkourVariablesDataAsset;
+
+/** Maps each Parkour.Action tag to the variables asset that plays it. */
+UCLASS(BlueprintType)
+class PARKOURSYSTEM_API UParkourActionRegistryDataAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	UParkourVariablesDataAsset* FindAction(const FGameplayTag& ActionTag) const;
+
+	const TMap<FGameplayTag, UParkourVariablesDataAsset*>& GetActions() const { return Actions; }
+
+private:
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Actions, meta = (AllowPrivateAccess = "true", Categories = "Parkour.Action"))
+	TMap<FGameplayTag, UParkourVariablesDataAsset*> Actions;
+};
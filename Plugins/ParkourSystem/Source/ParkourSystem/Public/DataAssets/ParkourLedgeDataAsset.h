@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Ledges/ParkourLedgeChunk.h"
+#include "ParkourLedgeDataAsset.generated.h"
+
+/** Ledges baked from the collision inside one AParkourLedgeVolume, packed into one chunk. */
+UCLASS(BlueprintType)
+class PARKOURSYSTEM_API UParkourLedgeDataAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void PostLoad() override;
+
+	UPROPERTY(VisibleAnywhere, Category = Ledges)
+	FParkourLedgeChunk Chunk;
+
+private:
+
+	UPROPERTY()
+	FBox BakedBounds_DEPRECATED = FBox(ForceInit);
+
+	UPROPERTY()
+	TArray<FParkourLedge> Ledges_DEPRECATED;
+};
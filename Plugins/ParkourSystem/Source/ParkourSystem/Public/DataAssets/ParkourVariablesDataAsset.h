@@ -16,8 +16,9 @@ class PARKOURSYSTEM_API UParkourVariablesDataAsset : public UDataAsset
 	
 public:
 
+	/** Loaded ahead of use by the parkour component, see UParkourMovementComponent::PreloadActionMontages. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
-	UAnimMontage* ParkourMontage;
+	TSoftObjectPtr<UAnimMontage> ParkourMontage;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
 	FGameplayTag ParkourInState;
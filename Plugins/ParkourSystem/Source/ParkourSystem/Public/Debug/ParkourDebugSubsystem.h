@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ParkourDebugSubsystem.generated.h"
+
+/** Parkour debug drawing is compiled out of Shipping and Test builds, call sites wrap their recording in #if PARKOUR_DEBUG_DRAW. */
+#define PARKOUR_DEBUG_DRAW (!(UE_BUILD_SHIPPING || UE_BUILD_TEST))
+
+enum class EParkourDebugShape : uint8
+{
+	Line,
+	Sphere,
+	Box,
+	Capsule,
+	Point
+};
+
+struct FParkourDebugShape
+{
+	EParkourDebugShape Type = EParkourDebugShape::Line;
+
+	FVector Start = FVector::ZeroVector;
+
+	FVector End = FVector::ZeroVector;
+
+	/** Box half size, or X = radius and Z = half height for spheres and capsules. */
+	FVector Extent = FVector::ZeroVector;
+
+	FQuat Rotation = FQuat::Identity;
+
+	FColor Color = FColor::White;
+
+	double ExpireTime = 0;
+};
+
+/**
+ * Collects parkour debug shapes and state text into a ring buffer and draws them in one pass per frame
+ * while parkour.Debug is set. Recording is a few stores, nothing is drawn from the gameplay code.
+ */
+UCLASS()
+class PARKOURSYSTEM_API UParkourDebugSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/** Level 1 draws scan results, state and the traces call sites flag, level 2 draws every parkour trace. */
+	static bool IsEnabled(const int Level = 1);
+
+	/** Returns the world's debug subsystem when drawing is enabled at Level, nullptr otherwise. */
+	static UParkourDebugSubsystem* Get(const UWorld* World, const int Level = 1);
+
+	void AddShape(const EParkourDebugShape Type, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, const FColor& Color, const float Duration = 1.0f);
+
+	/** Records a trace the way the engine's trace debug draws it: the swept shape, the hit part of the path and the impact point. */
+	void AddTrace(const EParkourDebugShape Type, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, const bool bHit, const FHitResult& Hit, const FColor& TraceColor, const FColor& HitColor);
+
+	/** Replaces the on-screen state lines shown for Owner this frame. */
+	void SetStateText(const UObject* Owner, TArray<FString>&& Lines);
+
+private:
+
+	void DrawShape(const UWorld* World, const FParkourDebugShape& Shape) const;
+
+	TArray<FParkourDebugShape> Shapes;
+
+	int32 NextShape = 0;
+
+	TMap<TWeakObjectPtr<const UObject>, TArray<FString>> StateText;
+};
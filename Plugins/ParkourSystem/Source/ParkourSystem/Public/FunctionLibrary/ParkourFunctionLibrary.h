@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "Types/ParkourStateTypes.h"
 #include "ParkourFunctionLibrary.generated.h"
 
 struct FGameplayTag;
@@ -23,11 +24,14 @@ public:
 
 	static FVector GetRightVector(FRotator Rotation);
 
-	static float SelectClimbStyleFloat(const float Braced, const float FreeHang, const FGameplayTag ClimbStyle);
+	/** Turns a surface normal with Transform. Normals take the inverse scale, so faces stay faces under non-uniform scale. */
+	static FVector TransformNormal(const FTransform& Transform, const FVector& Normal);
 
-	static float SelectParkourDirectionFloat(const float Forward, const float Backward, const float Left, const float Right, const float ForwardLeft, const float ForwardRight, const float BackwardLeft, const float BackwardRight, const FGameplayTag Direction);
+	static float SelectClimbStyleFloat(const float Braced, const float FreeHang, const EParkourClimbStyle ClimbStyle);
 
-	static float SelectParkoutStateFloat(const float NotBusy, const float Vault, const float Mantle, const float Climb, const FGameplayTag StateTag);
+	static float SelectParkourDirectionFloat(const float Forward, const float Backward, const float Left, const float Right, const float ForwardLeft, const float ForwardRight, const float BackwardLeft, const float BackwardRight, const EParkourDirection Direction);
+
+	static float SelectParkoutStateFloat(const float NotBusy, const float Vault, const float Mantle, const float Climb, const EParkourState State);
 	
-	static FGameplayTag SelectParkourDirectionHopAction(const FGameplayTag Forward, const FGameplayTag Backward, const FGameplayTag Left, const FGameplayTag Right, const FGameplayTag ForwardLeft, const FGameplayTag ForwardRight, const FGameplayTag BackwardLeft, const FGameplayTag BackwardRight, const FGameplayTag Direction);
+	static FGameplayTag SelectParkourDirectionHopAction(const FGameplayTag Forward, const FGameplayTag Backward, const FGameplayTag Left, const FGameplayTag Right, const FGameplayTag ForwardLeft, const FGameplayTag ForwardRight, const FGameplayTag BackwardLeft, const FGameplayTag BackwardRight, const EParkourDirection Direction);
 };
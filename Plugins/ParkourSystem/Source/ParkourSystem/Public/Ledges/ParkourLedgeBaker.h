@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Types/ParkourLedgeTypes.h"
+#include "ParkourLedgeBaker.generated.h"
+
+class UPrimitiveComponent;
+
+USTRUCT(BlueprintType)
+struct PARKOURSYSTEM_API FParkourLedgeBakeSettings
+{
+	GENERATED_BODY()
+
+	/** Spacing of the top surface samples. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bake)
+	float SampleSpacing = 20.0f;
+
+	/** Smallest drop off an edge that makes it a ledge, matches the lowest wall ParkourType acts on. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bake)
+	float MinLedgeDrop = 44.0f;
+
+	/** How far below a ledge the floor is looked for. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bake)
+	float MaxWallProbeHeight = 400.0f;
+
+	/** How far across a top the far edge is looked for. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bake)
+	float MaxDepth = 150.0f;
+
+	/** Stacked walkable surfaces probed per sample column. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bake)
+	int MaxSurfaceLayers = 8;
+
+	/** Surfaces flatter than this count as walkable tops. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bake)
+	float MinTopNormalZ = 0.7f;
+
+	/** Size of the tiles a region is split into and probed on all cores, 0 probes the whole region at once. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bake)
+	float TileSize = 5120.0f;
+
+	/** How far from a ledge its probes touch the collision, so how far a change to the collision can change the ledge. */
+	FVector GetProbeReach() const;
+};
+
+/** What the bakes got through, summed over BakeRegion calls. */
+struct FParkourLedgeBakeStats
+{
+	int NumTiles = 0;
+
+	int NumLedges = 0;
+
+	/** Time spent probing and merging. */
+	double Seconds = 0;
+};
+
+/**
+ * Extracts ledges from a world's collision by probing it with traces. Only reads the world,
+ * so separate regions can be baked from several threads while the collision is left alone.
+ * BakeRegion does that itself for the tiles of a region.
+ */
+class PARKOURSYSTEM_API FParkourLedgeBaker
+{
+public:
+
+	/** Bakes the level geometry of InWorld, leaving out pawns and actors with a UParkourDynamicLedgeComponent. */
+	FParkourLedgeBaker(const UWorld* InWorld, const FParkourLedgeBakeSettings& InSettings);
+
+	/** Bakes InComponent on its own, as if nothing else was in its world. */
+	FParkourLedgeBaker(const UPrimitiveComponent* InComponent, const FParkourLedgeBakeSettings& InSettings);
+
+	/** Appends the ledges whose edge samples fall inside Region. The result does not depend on the thread count. */
+	void BakeRegion(const FBox& Region, TArray<FParkourLedge>& OutLedges, FParkourLedgeBakeStats* OutStats = nullptr) const;
+
+	/**
+	 * Bakes DirtyRegion again and replaces the ledges of InOutLedges that reach into it, leaving the rest of Region alone.
+	 * The columns are probed over the full height of Region.
+	 */
+	void RebakeRegion(const FBox& Region, const FBox& DirtyRegion, TArray<FParkourLedge>& InOutLedges, FParkourLedgeBakeStats* OutStats = nullptr) const;
+
+	/** Joins neighbouring samples of the same edge into segments. The output order only depends on the samples. */
+	static void MergeLedgeSamples(TArray<FParkourLedge>& Samples, const float SampleSpacing, TArray<FParkourLedge>& OutLedges);
+
+	const FParkourLedgeBakeSettings& GetSettings() const { return Settings; }
+
+private:
+
+	/** Probes the sample columns from MinColumn up to but not including MaxColumn of Region's sample grid. */
+	void ProbeColumns(const FBox& Region, const FIntPoint& MinColumn, const FIntPoint& MaxColumn, TArray<FParkourLedge>& OutSamples) const;
+
+	bool ProbeEdge(const FVector& SurfacePoint, const FVector& Direction, FParkourLedge& OutSample) const;
+
+	void MeasureLedge(FParkourLedge& Sample) const;
+
+	bool LineTrace(FHitResult& OutHit, const FVector& Start, const FVector& End) const;
+
+	bool SphereTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const float Radius) const;
+
+	const UWorld* World;
+
+	const UPrimitiveComponent* Component = nullptr;
+
+	FParkourLedgeBakeSettings Settings;
+
+	FCollisionQueryParams QueryParams;
+};
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Types/ParkourLedgeTypes.h"
+#include "ParkourLedgeChunk.generated.h"
+
+/** FParkourLedge in 24 bytes: positions as 16-bit offsets from the chunk origin, the wall normal octahedral encoded. */
+USTRUCT()
+struct PARKOURSYSTEM_API FParkourPackedLedge
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int16 Start[3] = { 0, 0, 0 };
+
+	UPROPERTY()
+	int16 End[3] = { 0, 0, 0 };
+
+	UPROPERTY()
+	int16 WallNormal[2] = { 0, 0 };
+
+	/** Lengths in millimeters. */
+	UPROPERTY()
+	uint16 WallHeight = 0;
+
+	UPROPERTY()
+	uint16 Depth = 0;
+
+	UPROPERTY()
+	uint16 VaultHeight = 0;
+
+	UPROPERTY()
+	EParkourLedgeClimbStyle ClimbStyle = EParkourLedgeClimbStyle::Braced;
+};
+
+/** The baked ledges of one region, packed. A chunk only needs enough range for its own region, so big maps bake many of them. */
+USTRUCT()
+struct PARKOURSYSTEM_API FParkourLedgeChunk
+{
+	GENERATED_BODY()
+
+	/** Region the bake covered. Inside it a wall scan starts from the ledge list, and only traces where it has no ledge. */
+	UPROPERTY(VisibleAnywhere, Category = Ledges)
+	FBox Bounds = FBox(ForceInit);
+
+	/** Parts of Bounds whose collision changed after the bake. The ledges there are not trusted until they are baked again. */
+	UPROPERTY(VisibleAnywhere, Category = Ledges)
+	TArray<FBox> StaleRegions;
+
+	void MarkStale(const FBox& Region);
+
+	bool IsStale(const FVector& Location) const;
+
+	bool IsStale(const FBox& Region) const;
+
+	/** Replaces the ledges with InLedges, baked from all of InBounds, which also makes the chunk current again. */
+	void Pack(const FBox& InBounds, TConstArrayView<FParkourLedge> InLedges);
+
+	FParkourLedge Unpack(const int32 Index) const;
+
+	void UnpackAll(TArray<FParkourLedge>& OutLedges) const;
+
+	int32 Num() const { return Ledges.Num(); }
+
+	SIZE_T GetAllocatedSize() const { return Ledges.GetAllocatedSize(); }
+
+	/** How far, on each axis, an unpacked ledge point can be from the baked one. Grows with the size of the chunk. */
+	float GetPackingError() const { return Step * 0.5f; }
+
+private:
+
+	FVector Decode(const int16 Offset[3]) const;
+
+	UPROPERTY()
+	FVector Origin = FVector::ZeroVector;
+
+	/** World distance of one offset unit, chosen so the farthest point of the chunk just fits. */
+	UPROPERTY()
+	float Step = 1.0f;
+
+	UPROPERTY()
+	TArray<FParkourPackedLedge> Ledges;
+};
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "Types/ParkourLedgeTypes.h"
+#include "ParkourLedgeTemplateUserData.generated.h"
+
+class UStaticMesh;
+
+/**
+ * The ledges of a static mesh on its own, in mesh space, baked once per mesh by -run=ParkourLedgeTemplates and shared
+ * by every placement and instance of it. The wall scan moves them to the hit placement instead of tracing the top.
+ * WallHeight and VaultHeight depend on what is around a placement, so they are not kept.
+ */
+UCLASS()
+class PARKOURSYSTEM_API UParkourLedgeTemplateUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+
+	static const UParkourLedgeTemplateUserData* Get(const UStaticMesh* StaticMesh);
+
+	/** Appends the ledges as they lie with the mesh placed at Transform. */
+	void TransformLedges(const FTransform& Transform, TArray<FParkourLedge>& OutLedges) const;
+
+	/** Appends InLedges moved by Transform, without the heights that depend on what is around them. */
+	static void TransformLedges(const FTransform& Transform, TConstArrayView<FParkourLedge> InLedges, TArray<FParkourLedge>& OutLedges);
+
+	UPROPERTY(VisibleAnywhere, Category = Ledges)
+	TArray<FParkourLedge> Ledges;
+};
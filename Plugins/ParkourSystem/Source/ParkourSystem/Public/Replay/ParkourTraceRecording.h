@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "Stats/ParkourStats.h"
+#include "Types/ParkourStateTypes.h"
+#include "Collision/ParkourCollisionScene.h"
+
+/** Trace recording is compiled out of Shipping builds. */
+#define PARKOUR_TRACE_RECORDING (!UE_BUILD_SHIPPING)
+
+/** One collision query issued by a parkour component and the result it got. */
+struct PARKOURSYSTEM_API FParkourTraceRecord
+{
+	/** Query fields only, Hit set to the no-hit result the world returns for a miss. */
+	static FParkourTraceRecord MakeQuery(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation);
+
+	/** Hash of the quantized query, equal for queries MatchesQuery accepts. */
+	uint32 GetQueryHash() const;
+
+	bool MatchesQuery(const FParkourTraceRecord& Other) const;
+
+	friend FArchive& operator<<(FArchive& Ar, FParkourTraceRecord& Record);
+
+	uint32 Owner = 0;
+
+	EParkourTraceShape Shape = EParkourTraceShape::Line;
+
+	EParkourTraceCallSite CallSite = EParkourTraceCallSite::Other;
+
+	EParkourState State = EParkourState::NotBusy;
+
+	FVector Start = FVector::ZeroVector;
+
+	FVector End = FVector::ZeroVector;
+
+	/** Sphere radius in X, capsule radius and half height in X and Z, box half size. */
+	FVector Extent = FVector::ZeroVector;
+
+	FQuat Rotation = FQuat::Identity;
+
+	bool bHit = false;
+
+	FHitResult Hit;
+};
+
+/** What a wall scan depends on besides collision, taken when the scan starts. */
+struct PARKOURSYSTEM_API FParkourScanSnapshot
+{
+	friend FArchive& operator<<(FArchive& Ar, FParkourScanSnapshot& Snapshot);
+
+	uint32 Owner = 0;
+
+	uint64 Frame = 0;
+
+	FVector ActorLocation = FVector::ZeroVector;
+
+	FQuat ActorRotation = FQuat::Identity;
+
+	FVector Velocity = FVector::ZeroVector;
+
+	/** Z of the mesh root socket, CheckDistance measures the wall from it. */
+	float RootZ = 0;
+
+	/** Z of the higher hand, FirstClimbHeight starts from it while climbing. */
+	float HandZ = 0;
+
+	EParkourState State = EParkourState::NotBusy;
+
+	EParkourClimbStyle ClimbStyle = EParkourClimbStyle::None;
+
+	bool bInGround = true;
+
+	bool bAutoClimb = false;
+
+	/** Answered from baked ledges, so there are no wall queries to replay. */
+	bool bBaked = false;
+
+	/** Ran as an async scan, whose queries only partly match the synchronous scan a replay runs. */
+	bool bAsync = false;
+};
+
+/** A finished wall scan read back from a recording. */
+struct PARKOURSYSTEM_API FParkourRecordedScan
+{
+	/** The recorded result of a query matching Query, nullptr when the scan never issued it. */
+	const FParkourTraceRecord* FindQuery(const FParkourTraceRecord& Query) const;
+
+	void BuildQueryIndex();
+
+	FParkourScanSnapshot Snapshot;
+
+	TArray<FParkourTraceRecord> Queries;
+
+	/** Parkour.Action tag the scan ended with. */
+	FName Action;
+
+private:
+
+	TMultiMap<uint32, int32> QueryIndex;
+};
+
+/** Answers queries from the results recorded for one scan, queries it never issued miss. */
+class PARKOURSYSTEM_API FParkourReplayCollisionScene : public IParkourCollisionScene
+{
+public:
+
+	explicit FParkourReplayCollisionScene(const FParkourRecordedScan& InScan) : Scan(InScan) {}
+
+	virtual bool Sweep(const EParkourTraceShape Shape, const FVector& Start, const FVector& End, const FVector& Extent, const FQuat& Rotation, FHitResult& OutHit) const override;
+
+	int GetNumUnmatchedQueries() const { return NumUnmatchedQueries; }
+
+private:
+
+	const FParkourRecordedScan& Scan;
+
+	mutable int NumUnmatchedQueries = 0;
+};
+
+/** A recording loaded back from disk. */
+struct PARKOURSYSTEM_API FParkourTraceRecording
+{
+	bool LoadFromFile(const FString& Filename);
+
+	TArray<FParkourRecordedScan> Scans;
+
+	/** Queries issued outside wall scans, climb movement and IK among them. */
+	int NumOtherQueries = 0;
+
+	/** Scans that were started but cancelled or still running when the recording stopped. */
+	int NumUnfinishedScans = 0;
+};
+
+/**
+ * Streams every parkour collision query to a binary file together with the scan snapshots and
+ * the actions the scans ended with. Driven by the parkour.Record console commands.
+ */
+class PARKOURSYSTEM_API FParkourTraceRecorder
+{
+public:
+
+	static bool Start(const FString& Filename);
+
+	static void Stop();
+
+	static bool IsRecording() { return Writer.IsValid(); }
+
+	static void RecordQuery(FParkourTraceRecord& Record);
+
+	static void BeginScan(FParkourScanSnapshot& Snapshot);
+
+	static void EndScan(const uint32 Owner, const FName Action);
+
+	static const uint32 FileMagic = 0x52544b50; // "PKTR"
+
+	static const uint32 FileVersion = 1;
+
+private:
+
+	static TUniquePtr<FArchive> Writer;
+};
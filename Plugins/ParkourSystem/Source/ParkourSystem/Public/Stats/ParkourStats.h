@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("Parkour"), STATGROUP_Parkour, STATCAT_Advanced);
+
+/** Per call site trace counting and the cycle counter totals are compiled out of Shipping builds. */
+#define PARKOUR_TRACE_STATS (!UE_BUILD_SHIPPING)
+
+/** Which part of the parkour component issued a trace. */
+enum class EParkourTraceCallSite : uint8
+{
+	Other,
+	CheckWallShape,
+	FirstClimbHeight,
+	SurfaceCheck,
+	ClimbMovement,
+	LimbsClimbIK,
+	FindDropDownHangLocation,
+	AutoClimb,
+	Count
+};
+
+/**
+ * Trace counts per call site, summed over every parkour component. Shown by `stat Parkour`
+ * and dumped by the `parkour.stats` console command.
+ */
+class PARKOURSYSTEM_API FParkourTraceStats
+{
+public:
+
+	static void AddTrace(EParkourTraceCallSite CallSite);
+
+	static void Reset();
+
+	static void Dump(FOutputDevice& Ar);
+
+	static const TCHAR* GetCallSiteName(EParkourTraceCallSite CallSite);
+
+	static uint64 GetTotalTraces(EParkourTraceCallSite CallSite);
+
+private:
+
+	struct FCallSiteCounts
+	{
+		uint32 CurrentFrame = 0;
+		uint32 LastFrame = 0;
+		uint32 PeakFrame = 0;
+		uint64 Total = 0;
+	};
+
+	static void AdvanceFrame();
+
+	static FCallSiteCounts Counts[(uint8)EParkourTraceCallSite::Count];
+
+	static uint64 CountedFrame;
+
+	static uint64 FramesWithTraces;
+};
+
+/** The cycle counters of STATGROUP_Parkour, each STAT_Parkour<Name>. */
+enum class EParkourCycleStat : uint8
+{
+	CheckWallShape,
+	ParkourType,
+	ClimbMovement,
+	LimbsClimbIK,
+	FindDropDownHangLocation,
+	AutoClimb,
+	LedgeLookup,
+	MontageSelection,
+	LineTrace,
+	SphereTrace,
+	CapsuleTrace,
+	BoxTrace,
+	Count
+};
+
+/**
+ * Totals of the STATGROUP_Parkour cycle counters, summed over every parkour component, so commandlets can
+ * read them without a stats capture. Fed by PARKOUR_SCOPE_CYCLE_COUNTER.
+ */
+class PARKOURSYSTEM_API FParkourCycleStats
+{
+public:
+
+	static void AddCycles(EParkourCycleStat Stat, uint64 Cycles);
+
+	static void Reset();
+
+	static void Dump(FOutputDevice& Ar);
+
+	static const TCHAR* GetStatName(EParkourCycleStat Stat);
+
+	static uint64 GetTotalCycles(EParkourCycleStat Stat);
+
+	static uint64 GetTotalCalls(EParkourCycleStat Stat);
+
+private:
+
+	struct FStatCounts
+	{
+		uint64 Cycles = 0;
+		uint64 Calls = 0;
+	};
+
+	static FStatCounts Counts[(uint8)EParkourCycleStat::Count];
+};
+
+/** Adds the cycles spent in its scope to FParkourCycleStats. */
+class FParkourCycleScope
+{
+public:
+
+	explicit FParkourCycleScope(const EParkourCycleStat InStat)
+		: Stat(InStat)
+		, StartCycles(FPlatformTime::Cycles64())
+	{
+	}
+
+	~FParkourCycleScope()
+	{
+		FParkourCycleStats::AddCycles(Stat, FPlatformTime::Cycles64() - StartCycles);
+	}
+
+private:
+
+	EParkourCycleStat Stat;
+
+	uint64 StartCycles;
+};
+
+/** SCOPE_CYCLE_COUNTER(STAT_Parkour<Stat>), also counted into FParkourCycleStats outside of Shipping builds. */
+#if PARKOUR_TRACE_STATS
+#define PARKOUR_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(STAT_Parkour##Stat); \
+	FParkourCycleScope ParkourCycleScope_##Stat(EParkourCycleStat::Stat)
+#else
+#define PARKOUR_SCOPE_CYCLE_COUNTER(Stat) SCOPE_CYCLE_COUNTER(STAT_Parkour##Stat)
+#endif
@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "WorldPartition/WorldPartitionStreamingSource.h"
+#include "Ledges/ParkourLedgeBaker.h"
+#include "Types/ParkourStateTypes.h"
+#include "ParkourLedgeSubsystem.generated.h"
+
+class UParkourLedgeDataAsset;
+class UPrimitiveComponent;
+class USceneComponent;
+struct FParkourLedgeChunk;
+
+/**
+ * Spatial index over the baked ledge chunks loaded in a world. Chunks come and go with the data assets and streamed cells
+ * that hold them. In World Partition worlds the cells ahead of the registered prefetch actors are streamed in early.
+ * The ledges of moving primitives are kept in component space and follow the primitives as they move.
+ * Each chunk also gets a hop graph, linking a ledge to the ledges a climbing character can hop to from it. It is filled
+ * in ledge by ledge, as they are held.
+ */
+UCLASS()
+class PARKOURSYSTEM_API UParkourLedgeSubsystem : public UWorldSubsystem, public IWorldPartitionStreamingSourceProvider
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Deinitialize() override;
+
+	void RegisterLedgeData(UParkourLedgeDataAsset* LedgeData);
+
+	void UnregisterLedgeData(UParkourLedgeDataAsset* LedgeData);
+
+	/** Chunk has to stay where it is until it is unregistered. */
+	void RegisterLedgeChunk(const FParkourLedgeChunk& Chunk);
+
+	void UnregisterLedgeChunk(const FParkourLedgeChunk& Chunk);
+
+	/** Indexes a registered chunk again after its ledges were repacked in place. */
+	void ReindexLedgeChunk(const FParkourLedgeChunk& Chunk);
+
+	/**
+	 * Keeps the ledges of Primitive in component space and moves them with it until it is unregistered. A primitive
+	 * without a ledge template is baked on a later frame, until then the scans trace it.
+	 */
+	void RegisterDynamicPrimitive(UPrimitiveComponent* Primitive, const FParkourLedgeBakeSettings& BakeSettings);
+
+	void UnregisterDynamicPrimitive(UPrimitiveComponent* Primitive);
+
+	/** Bakes the ledges of Primitive again on a later frame, the scans trace it in the meantime. */
+	void InvalidateDynamicPrimitive(const UPrimitiveComponent* Primitive);
+
+	/** True when Bounds touches a registered dynamic primitive. Baked ledges there may be covered by it. */
+	bool HasDynamicGeometry(const FBox& Bounds) const;
+
+	/** Streams in the ledge cells along the velocity of Actor until it is removed. */
+	void AddPrefetchActor(const AActor* Actor);
+
+	void RemovePrefetchActor(const AActor* Actor);
+
+	/** True when Location is inside a baked region, where the database replaces the wall traces. */
+	bool IsCovered(const FVector& Location) const;
+
+	/** True when all of Bounds is inside loaded baked regions and the dynamic primitives in it have their ledges. */
+	bool IsCovered(const FBox& Bounds) const;
+
+	/** Finds the ledge a wall scan from the query would land on. OutEdgePoint is the point on its edge in front of the character. */
+	bool FindLedge(const FParkourLedgeQuery& Query, FParkourLedge& OutLedge, FVector& OutEdgePoint) const;
+
+	/**
+	 * Finds the ledge a hop towards Direction lands on, from the baked ledge held at HeldPoint. Reads the hop graph, so
+	 * nothing is traced. Moving geometry and stale or unloaded regions are not in the graph, there it returns false.
+	 */
+	bool FindHop(const FVector& HeldPoint, const FVector& WallNormal, const EParkourDirection Direction, FParkourLedge& OutLedge, FVector& OutLandingPoint) const;
+
+	/** True when any ledge passes within Radius of Location. */
+	bool HasLedgeNear(const FVector& Location, const float Radius) const;
+
+	int GetNumLedges() const { return NumLedges; }
+
+	//~ Begin IWorldPartitionStreamingSourceProvider
+	virtual bool GetStreamingSources(TArray<FWorldPartitionStreamingSource>& OutStreamingSources) const override;
+	virtual const UObject* GetStreamingSourceOwner() const override { return this; }
+	//~ End IWorldPartitionStreamingSourceProvider
+
+private:
+
+	/** A hop from one ledge of a chunk to another. */
+	struct FHopEdge
+	{
+		int32 TargetLedge = INDEX_NONE;
+
+		/** A bit per EParkourDirection the hop can take, depending on where the first ledge is held. */
+		uint16 DirectionMask = 0;
+	};
+
+	struct FChunkIndex
+	{
+		const FParkourLedgeChunk* Chunk = nullptr;
+
+		int32 NumLedges = 0;
+
+		mutable SIZE_T AllocatedSize = 0;
+
+		TMap<FIntVector, TArray<int32>> Cells;
+
+		/** Per held ledge, the ledges a hop from it can land on. Filled in by the first FindHop holding the ledge. */
+		mutable TMap<int32, TArray<FHopEdge>> Hops;
+	};
+
+	/** The ledges of a dynamic primitive, placed by the first query that needs them after it moved. */
+	struct FDynamicLedges
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Primitive;
+
+		FParkourLedgeBakeSettings BakeSettings;
+
+		/** In component space. */
+		TArray<FParkourLedge> LocalLedges;
+
+		/** LocalLedges at the current transform of the primitive. */
+		TArray<FParkourLedge> WorldLedges;
+
+		bool bBaked = false;
+
+		bool bPlaced = false;
+	};
+
+	void IndexChunk(FChunkIndex& ChunkIndex) const;
+
+	/** The hops from one ledge of ChunkIndex, found the first time they are asked for. */
+	const TArray<FHopEdge>& GetHops(const FChunkIndex& ChunkIndex, const int32 LedgeIndex) const;
+
+	/** Calls Function with the index of every ledge of ChunkIndex in a cell overlapping Bounds, once or more per ledge. */
+	void ForEachCellLedge(const FChunkIndex& ChunkIndex, const FBox& Bounds, TFunctionRef<void(int32 LedgeIndex)> Function) const;
+
+	/** Takes the ledges from the template of the mesh when there is one, otherwise queues a bake. */
+	void PrepareDynamicLedges(FDynamicLedges& DynamicLedges);
+
+	/** Bakes the first dynamic primitive still waiting for its ledges, one per frame so no frame takes them all. */
+	void BakeNextDynamicPrimitive();
+
+	void OnDynamicTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	/** The world space ledges of DynamicLedges, nullptr when its primitive is gone, not baked yet or tilted off the level. */
+	const TArray<FParkourLedge>* UpdateDynamicLedges(FDynamicLedges& DynamicLedges) const;
+
+	FIntVector GetCell(const FVector& Location) const;
+
+	UPROPERTY()
+	TArray<UParkourLedgeDataAsset*> LedgeDataAssets;
+
+	TArray<FChunkIndex> Chunks;
+
+	/** Updated lazily by the queries. */
+	mutable TArray<FDynamicLedges> DynamicPrimitives;
+
+	TArray<TWeakObjectPtr<const AActor>> PrefetchActors;
+
+	FTimerHandle DynamicBakeTimerHandle;
+
+	int NumLedges = 0;
+
+	float CellSize = 200.0f;
+};
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * The ledge the last climb move settled on. Ledges barely change between two frames of shimmying,
+ * so the next move only confirms this guess a few cm further along instead of searching again.
+ * Between confirmations the hands slide along the straight segment from SegmentStart to LedgePoint.
+ */
+struct PARKOURSYSTEM_API FParkourClimbTracker
+{
+	void Reset() { *this = FParkourClimbTracker(); }
+
+	bool IsValid() const { return bValid; }
+
+	float GetSegmentLength() const { return FVector::Dist(SegmentStart, LedgePoint); }
+
+	/** Ledge point the hands are at. */
+	FVector GetHandPoint() const
+	{
+		const float SegmentLength = GetSegmentLength();
+		return SegmentLength > UE_KINDA_SMALL_NUMBER ? FMath::Lerp(SegmentStart, LedgePoint, FMath::Min(Offset / SegmentLength, 1.f)) : LedgePoint;
+	}
+
+	bool bValid = false;
+
+	/** Forward sweep row of the full search that found the wall. */
+	int WallRow = 0;
+
+	/** Lowest side line row that was clear. */
+	int ClearRow = 0;
+
+	/** Last confirmed wall point ahead of the hands, with the top of the ledge as its Z. */
+	FVector LedgePoint = FVector::ZeroVector;
+
+	/** Where the hands were when LedgePoint was confirmed. */
+	FVector SegmentStart = FVector::ZeroVector;
+
+	/** Distance the hands travelled from SegmentStart towards LedgePoint. */
+	float Offset = 0;
+
+	/** Sign of the horizontal climb input LedgePoint was confirmed for. */
+	float Direction = 0;
+
+	FVector WallNormal = FVector::ZeroVector;
+
+	/** Where and for which direction CheckClimbMovementSurface last passed. */
+	FVector SurfaceCheckLocation = FVector::ZeroVector;
+
+	float SurfaceCheckDirection = 0;
+};
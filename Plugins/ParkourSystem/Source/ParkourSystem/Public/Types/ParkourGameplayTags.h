@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NativeGameplayTags.h"
+#include "Types/ParkourStateTypes.h"
+
+/** The parkour tags, registered once at module load instead of being looked up by name. */
+namespace ParkourTags
+{
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_NoAction);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_ThinVault);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_HighVault);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_Vault);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_Mantle);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_LowMantle);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_Climb);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_FreeHangClimb);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_ClimbingUp);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_FreeHangClimbUp);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_FallingBraced);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_FallingFreeHang);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_DropDown);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_FreeHangDropDown);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_CornerMove);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_ClimbHopDown);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_ClimbHopLeft);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_ClimbHopLeftUp);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_ClimbHopRight);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_ClimbHopRightUp);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_ClimbHopUp);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_FreeClimbHopDown);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_FreeClimbHopLeft);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Action_FreeClimbHopRight);
+
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(State_NotBusy);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(State_ReachLedge);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(State_Climb);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(State_Mantle);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(State_Vault);
+
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(ClimbStyle);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(ClimbStyle_Braced);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(ClimbStyle_FreeHang);
+
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Direction_NoDirection);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Direction_Forward);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Direction_Backward);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Direction_Left);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Direction_Right);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Direction_ForwardLeft);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Direction_ForwardRight);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Direction_BackwardLeft);
+	PARKOURSYSTEM_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Direction_BackwardRight);
+
+	PARKOURSYSTEM_API FGameplayTag FromState(const EParkourState State);
+
+	/** Returns EParkourState::Count for tags outside Parkour.State. */
+	PARKOURSYSTEM_API EParkourState ToState(const FGameplayTag& Tag);
+
+	PARKOURSYSTEM_API FGameplayTag FromClimbStyle(const EParkourClimbStyle Style);
+
+	PARKOURSYSTEM_API FGameplayTag FromDirection(const EParkourDirection Direction);
+
+	/** Returns EParkourDirection::Count for tags outside Parkour.Direction. */
+	PARKOURSYSTEM_API EParkourDirection ToDirection(const FGameplayTag& Tag);
+
+	/** The hop action towards Direction while hanging in Style, an empty tag where there is none. */
+	PARKOURSYSTEM_API FGameplayTag HopAction(const EParkourDirection Direction, const EParkourClimbStyle Style);
+}
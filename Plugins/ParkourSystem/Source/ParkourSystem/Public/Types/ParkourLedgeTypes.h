@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ParkourLedgeTypes.generated.h"
+
+UENUM(BlueprintType)
+enum class EParkourLedgeClimbStyle : uint8
+{
+	Braced,
+	FreeHang
+};
+
+/** A climbable top edge extracted from level collision. */
+USTRUCT(BlueprintType)
+struct PARKOURSYSTEM_API FParkourLedge
+{
+	GENERATED_BODY()
+
+	/** Top edge segment, on the top surface right at the wall face. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ledge)
+	FVector Start = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ledge)
+	FVector End = FVector::ZeroVector;
+
+	/** Horizontal normal of the wall face, pointing away from the wall. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ledge)
+	FVector WallNormal = FVector::ForwardVector;
+
+	/** Height of the top above the floor in front of the wall. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ledge)
+	float WallHeight = 0;
+
+	/** Distance across the top to the far edge, 0 when no far edge was found. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ledge)
+	float Depth = 0;
+
+	/** Drop from the top to the landing behind the far edge, 0 when there is nothing to land on. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ledge)
+	float VaultHeight = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ledge)
+	EParkourLedgeClimbStyle ClimbStyle = EParkourLedgeClimbStyle::Braced;
+
+	FVector GetClosestPoint(const FVector& Point) const
+	{
+		return FMath::ClosestPointOnSegment(Point, Start, End);
+	}
+
+	FBox GetBounds() const
+	{
+		return FBox(Start.ComponentMin(End), Start.ComponentMax(End));
+	}
+};
+
+/** What a character in front of a wall can reach, mirroring the extent of the trace based scan. */
+struct PARKOURSYSTEM_API FParkourLedgeQuery
+{
+	FVector Location = FVector::ZeroVector;
+
+	/** Horizontal facing of the character. */
+	FVector Forward = FVector::ForwardVector;
+
+	/** Furthest forward distance from Location to the wall face. */
+	float MaxReach = 130;
+
+	/** Furthest sideways distance of the edge point from the forward line. */
+	float MaxSideOffset = 40;
+
+	float MinTopZ = 0;
+
+	float MaxTopZ = 0;
+
+	/** Everything a matching edge point can lie in. */
+	FBox GetBounds() const;
+
+	/** Where the forward line crosses Ledge, when that point is within the query. */
+	bool Match(const FParkourLedge& Ledge, FVector& OutEdgePoint, float& OutForwardDistance) const;
+
+	/** The scan climbs from the bottom row up, so the lowest top wins and the nearest breaks ties. */
+	static bool IsBetterMatch(const FVector& EdgePoint, const float ForwardDistance, const FVector& BestEdgePoint, const float BestForwardDistance);
+
+	/** The best match among Ledges, nullptr when none of them matches. */
+	const FParkourLedge* FindBest(TConstArrayView<FParkourLedge> Ledges, FVector& OutEdgePoint) const;
+};
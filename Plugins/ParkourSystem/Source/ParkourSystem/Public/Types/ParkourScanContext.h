@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Engine/HitResult.h"
+#include "Types/ParkourStateTypes.h"
+
+/**
+ * Lives for one wall scan. The world and the character do not change while a scan runs,
+ * so anything derived from them is worked out once here and reused by every trace of the scan.
+ */
+struct PARKOURSYSTEM_API FParkourScanContext
+{
+	FParkourScanContext() = default;
+
+	explicit FParkourScanContext(const FTransform& InActorTransform)
+		: ActorTransform(InActorTransform)
+		, ActorLocation(InActorTransform.GetLocation())
+		, ActorForwardVector(InActorTransform.GetUnitAxis(EAxis::X))
+	{
+	}
+
+	FTransform ActorTransform;
+
+	FVector ActorLocation = FVector::ZeroVector;
+
+	FVector ActorForwardVector = FVector::ForwardVector;
+
+	/** FirstClimbHeight() result, set the first time the scan asks for it. */
+	TOptional<float> ClimbHeight;
+
+	/** Traces the first FirstClimbHeight() evaluation took, saved again on every reuse. */
+	int ClimbHeightQueries = 0;
+
+	int QueriesIssued = 0;
+
+	int QueriesSaved = 0;
+};
+
+/** What a wall scan decided and how long it took, see UParkourMovementComponent::EvaluateWallScan. */
+struct PARKOURSYSTEM_API FParkourScanEvaluation
+{
+	FGameplayTag Action;
+
+	/** Climb style the surface checks settled on, only set when the scan found a climbable wall. */
+	EParkourClimbStyle ClimbStyle = EParkourClimbStyle::None;
+
+	/** The wall came from the baked ledge database instead of traces. */
+	bool bBaked = false;
+
+	/** Time spent in CheckWallShape, the traces included. */
+	double WallShapeSeconds = 0;
+
+	/** Time spent measuring the wall and picking the action in ParkourType, surface checks included. */
+	double DecisionSeconds = 0;
+
+	/** Queries of the wall shape search, the sweeps confirming a baked ledge included. */
+	int QueriesIssued = 0;
+
+	float WallHeight = 0;
+
+	float WallDepth = 0;
+
+	float VaultHeight = 0;
+
+	/** The warp targets of the actions are placed from these along WallRotation. */
+	FRotator WallRotation = FRotator::ZeroRotator;
+
+	FHitResult WallTopResult;
+
+	FHitResult WallDepthResult;
+
+	FHitResult WallVaultResult;
+
+	FHitResult ClimbedLedgeResult;
+};
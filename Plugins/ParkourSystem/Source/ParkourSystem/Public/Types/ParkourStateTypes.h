@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Internal mirror of the Parkour.State tags. The tags are only built when talking to the anim instance or to Blueprint. */
+enum class EParkourState : uint8
+{
+	NotBusy,
+	ReachLedge,
+	Climb,
+	Mantle,
+	Vault,
+	Count
+};
+
+/** Internal mirror of the Parkour.ClimbStyle tags. None is the bare Parkour.ClimbStyle parent the component starts with. */
+enum class EParkourClimbStyle : uint8
+{
+	None,
+	Braced,
+	FreeHang,
+	Count
+};
+
+/** Internal mirror of the Parkour.Direction tags. */
+enum class EParkourDirection : uint8
+{
+	NoDirection,
+	Forward,
+	Backward,
+	Left,
+	Right,
+	ForwardLeft,
+	ForwardRight,
+	BackwardLeft,
+	BackwardRight,
+	Count
+};
@@ -0,0 +1,32 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class ParkourSystemEditor : ModuleRules
+{
+	public ParkourSystemEditor(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"AssetRegistry",
+				"CoreUObject",
+				"EditorSubsystem",
+				"Engine",
+				"GameplayTags",
+				"Json",
+				"ParkourSystem",
+				"UnrealEd",
+			}
+			);
+	}
+}
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/ParkourBakeLedgesCommandlet.h"
+#include "Actors/ParkourLedgeVolume.h"
+#include "Ledges/ParkourLedgeBaker.h"
+#include "ParkourSystemEditor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "FileHelpers.h"
+#include "Misc/PackageName.h"
+
+UParkourBakeLedgesCommandlet::UParkourBakeLedgesCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UParkourBakeLedgesCommandlet::Main(const FString& Params)
+{
+	FString MapName;
+	FString VolumeName;
+	FParse::Value(*Params, TEXT("Map="), MapName);
+	FParse::Value(*Params, TEXT("Volume="), VolumeName);
+	const bool bDryRun = FParse::Param(*Params, TEXT("DryRun"));
+
+	FString MapFilename;
+	if (MapName.IsEmpty() || FPackageName::TryConvertLongPackageNameToFilename(MapName, MapFilename, FPackageName::GetMapPackageExtension()) == false)
+	{
+		UE_LOG(LogParkourEditor, Error, TEXT("-Map=<long package name> is required, got '%s'."), *MapName);
+		return 1;
+	}
+
+	UWorld* World = UEditorLoadingAndSavingUtils::LoadMap(MapFilename);
+	if (World == nullptr)
+	{
+		UE_LOG(LogParkourEditor, Error, TEXT("Could not load the map %s."), *MapName);
+		return 1;
+	}
+
+	TArray<AParkourLedgeVolume*> Volumes;
+	for (TActorIterator<AParkourLedgeVolume> It(World); It; ++It)
+	{
+		if (VolumeName.IsEmpty() || It->GetName() == VolumeName || It->GetActorLabel() == VolumeName)
+		{
+			Volumes.Add(*It);
+		}
+	}
+	Volumes.Sort([](const AParkourLedgeVolume& A, const AParkourLedgeVolume& B) { return A.GetName() < B.GetName(); });
+
+	if (Volumes.Num() == 0)
+	{
+		UE_LOG(LogParkourEditor, Warning, TEXT("%s has no ledge volumes to bake."), *MapName);
+		return 0;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	FParkourLedgeBakeStats Stats;
+	for (AParkourLedgeVolume* Volume : Volumes)
+	{
+		Volume->BakeLedges(Stats);
+	}
+	const double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// Probing time only, the rest is loading regions and storing the results.
+	const double ProbeSeconds = FMath::Max(Stats.Seconds, UE_SMALL_NUMBER);
+	UE_LOG(LogParkourEditor, Display, TEXT("%d volumes, %d tiles, %d ledges in %.2f s (%.2f s probing on %d worker threads): %.1f tiles/s, %.0f ledges/s."),
+		Volumes.Num(), Stats.NumTiles, Stats.NumLedges, TotalSeconds, Stats.Seconds, FTaskGraphInterface::Get().GetNumWorkerThreads(),
+		Stats.NumTiles / ProbeSeconds, Stats.NumLedges / ProbeSeconds);
+
+	if (bDryRun)
+	{
+		return 0;
+	}
+
+	if (UEditorLoadingAndSavingUtils::SaveDirtyPackages(true, true) == false)
+	{
+		UE_LOG(LogParkourEditor, Error, TEXT("Could not save the baked ledges of %s."), *MapName);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/ParkourBenchmarkCommandlet.h"
+#include "Commandlets/ParkourHeadlessWorld.h"
+#include "Commandlets/ParkourObstacleCourse.h"
+#include "Commandlets/ParkourCourseRunner.h"
+#include "Collision/ParkourAnalyticScene.h"
+#include "GameFramework/Character.h"
+#include "ParkourSystemEditor.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// Fixed frame time the course is ticked at.
+static constexpr float ParkourBenchmarkDeltaSeconds = 1.f / 60;
+
+UParkourBenchmarkCommandlet::UParkourBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UParkourBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 NumCharacters = 4;
+	int32 Repeat = 3;
+	float Step = 20;
+	float RunSpeed = 350;
+	float WalkSpeed = 150;
+	FString CharacterClassPath = TEXT("/Game/Blueprints/Characters/BP_PlayerCharacter.BP_PlayerCharacter_C");
+	FString OutputFile = FPaths::ProjectSavedDir() / TEXT("Parkour") / TEXT("Benchmark.json");
+	FParse::Value(*Params, TEXT("Characters="), NumCharacters);
+	FParse::Value(*Params, TEXT("Repeat="), Repeat);
+	FParse::Value(*Params, TEXT("Step="), Step);
+	FParse::Value(*Params, TEXT("RunSpeed="), RunSpeed);
+	FParse::Value(*Params, TEXT("WalkSpeed="), WalkSpeed);
+	FParse::Value(*Params, TEXT("CharacterClass="), CharacterClassPath);
+	FParse::Value(*Params, TEXT("Output="), OutputFile);
+	const bool bAnalytic = FParse::Param(*Params, TEXT("Analytic"));
+	NumCharacters = FMath::Max(NumCharacters, 1);
+	Repeat = FMath::Max(Repeat, 1);
+
+	UClass* CharacterClass = LoadClass<ACharacter>(nullptr, *CharacterClassPath);
+	if (CharacterClass == nullptr)
+	{
+		UE_LOG(LogParkourEditor, Error, TEXT("Could not load the character class %s."), *CharacterClassPath);
+		return 1;
+	}
+
+	TArray<FParkourObstacle> Obstacles;
+	FParkourObstacleCourse::GenerateBenchmarkCourse(Obstacles);
+
+	// The characters always move against the world course, -Analytic only answers their parkour queries.
+	FParkourHeadlessWorld HeadlessWorld;
+	FParkourAnalyticScene AnalyticScene;
+	TArray<AActor*> CourseActors;
+	FParkourObstacleCourse::SpawnFloor(HeadlessWorld.GetWorld(), CourseActors);
+	for (const FParkourObstacle& Obstacle : Obstacles)
+	{
+		FParkourObstacleCourse::SpawnInWorld(Obstacle, HeadlessWorld.GetWorld(), CourseActors);
+	}
+	if (bAnalytic)
+	{
+		AnalyticScene.AddSlab(0);
+		for (const FParkourObstacle& Obstacle : Obstacles)
+		{
+			FParkourObstacleCourse::AddToScene(Obstacle, AnalyticScene);
+		}
+	}
+	HeadlessWorld.Tick();
+
+	TArray<FParkourCourseRunner> Runners;
+	Runners.Reserve(NumCharacters);
+	for (int Index = 0; Index < NumCharacters; Index++)
+	{
+		Runners.Emplace(HeadlessWorld, CharacterClass, bAnalytic ? &AnalyticScene : nullptr);
+	}
+
+	const FParkourTraceCounts TracesAtStart = FParkourTraceCounts::Capture();
+	const FParkourCycleCounts CyclesAtStart = FParkourCycleCounts::Capture();
+
+	int TotalFrames = 0;
+	double TotalTickSeconds = 0;
+	double MaxTickSeconds = 0;
+	TArray<TSharedPtr<FJsonValue>> ObstacleValues;
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (const FParkourObstacle& Obstacle : Obstacles)
+	{
+		const FParkourTraceCounts TracesBefore = FParkourTraceCounts::Capture();
+		const FParkourCycleCounts CyclesBefore = FParkourCycleCounts::Capture();
+
+		int ObstacleFrames = 0;
+		double ObstacleTickSeconds = 0;
+		double ObstacleMaxTickSeconds = 0;
+		TArray<TSharedPtr<FJsonValue>> RunValues;
+
+		for (int Pass = 0; Pass < Repeat; Pass++)
+		{
+			// Even characters run at the obstacle, odd ones walk up to it, across the width of the face.
+			const float LaneWidth = (Obstacle.HalfWidth * 2 - 100) / Runners.Num();
+			for (int Index = 0; Index < Runners.Num(); Index++)
+			{
+				const float LateralOffset = (Index + 0.5f) * LaneWidth - (Obstacle.HalfWidth - 50);
+				if (Runners[Index].Start(Obstacle, LateralOffset, (Index % 2 == 0) ? RunSpeed : WalkSpeed, Step) == false)
+				{
+					UE_LOG(LogParkourEditor, Error, TEXT("Could not spawn %s, it needs a parkour movement component."), *CharacterClass->GetName());
+					return 1;
+				}
+			}
+
+			bool bRunning = true;
+			while (bRunning)
+			{
+				for (FParkourCourseRunner& Runner : Runners)
+				{
+					Runner.AddInput();
+				}
+
+				const double TickStartTime = FPlatformTime::Seconds();
+				HeadlessWorld.Tick(ParkourBenchmarkDeltaSeconds);
+				const double TickSeconds = FPlatformTime::Seconds() - TickStartTime;
+				ObstacleFrames++;
+				ObstacleTickSeconds += TickSeconds;
+				ObstacleMaxTickSeconds = FMath::Max(ObstacleMaxTickSeconds, TickSeconds);
+
+				bRunning = false;
+				for (FParkourCourseRunner& Runner : Runners)
+				{
+					bRunning |= Runner.Update();
+				}
+			}
+
+			for (int Index = 0; Index < Runners.Num(); Index++)
+			{
+				const FParkourCourseLeg& Leg = Runners[Index].GetLeg();
+				TSharedPtr<FJsonObject> RunObject = MakeShared<FJsonObject>();
+				RunObject->SetNumberField(TEXT("character"), Index);
+				RunObject->SetNumberField(TEXT("pass"), Pass);
+				RunObject->SetNumberField(TEXT("lateralOffset"), (Index + 0.5f) * LaneWidth - (Obstacle.HalfWidth - 50));
+				RunObject->SetNumberField(TEXT("speed"), (Index % 2 == 0) ? RunSpeed : WalkSpeed);
+				RunObject->SetStringField(TEXT("action"), FParkourObstacleCourse::GetTagName(Leg.Action));
+				RunObject->SetNumberField(TEXT("distance"), Leg.Distance);
+				RunObject->SetNumberField(TEXT("presses"), Leg.Presses);
+				RunObject->SetNumberField(TEXT("frames"), Leg.Frames);
+				RunObject->SetBoolField(TEXT("completed"), Leg.bCompleted);
+				RunValues.Add(MakeShared<FJsonValueObject>(RunObject));
+			}
+		}
+
+		TSharedPtr<FJsonObject> ObstacleObject = MakeShared<FJsonObject>();
+		ObstacleObject->SetStringField(TEXT("name"), Obstacle.Name);
+		ObstacleObject->SetStringField(TEXT("kind"), Obstacle.Kind);
+		ObstacleObject->SetNumberField(TEXT("wallHeight"), Obstacle.WallHeight);
+		ObstacleObject->SetNumberField(TEXT("depth"), Obstacle.Depth);
+		ObstacleObject->SetNumberField(TEXT("drop"), Obstacle.Drop);
+		ObstacleObject->SetNumberField(TEXT("frames"), ObstacleFrames);
+		ObstacleObject->SetNumberField(TEXT("tickUs"), ObstacleFrames > 0 ? ObstacleTickSeconds / ObstacleFrames * 1.e6 : 0);
+		ObstacleObject->SetNumberField(TEXT("maxTickUs"), ObstacleMaxTickSeconds * 1.e6);
+		ObstacleObject->SetObjectField(TEXT("cycles"), (FParkourCycleCounts::Capture() - CyclesBefore).ToJson(ObstacleFrames));
+		ObstacleObject->SetObjectField(TEXT("traces"), (FParkourTraceCounts::Capture() - TracesBefore).ToJson());
+		ObstacleObject->SetArrayField(TEXT("runs"), RunValues);
+		ObstacleValues.Add(MakeShared<FJsonValueObject>(ObstacleObject));
+
+		TotalFrames += ObstacleFrames;
+		TotalTickSeconds += ObstacleTickSeconds;
+		MaxTickSeconds = FMath::Max(MaxTickSeconds, ObstacleMaxTickSeconds);
+	}
+
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	const FParkourCycleCounts Cycles = FParkourCycleCounts::Capture() - CyclesAtStart;
+
+	UE_LOG(LogParkourEditor, Display, TEXT("%d obstacles, %d characters, %d frames in %.3f s on the %s scene, %.2f us per tick, max %.2f."),
+		Obstacles.Num(), Runners.Num(), TotalFrames, ElapsedSeconds, bAnalytic ? TEXT("analytic") : TEXT("world"),
+		TotalFrames > 0 ? TotalTickSeconds / TotalFrames * 1.e6 : 0, MaxTickSeconds * 1.e6);
+	for (uint8 Index = 0; Index < (uint8)EParkourCycleStat::Count; Index++)
+	{
+		const double Microseconds = FPlatformTime::ToMilliseconds64(Cycles.Cycles[Index]) * 1000;
+		UE_LOG(LogParkourEditor, Display, TEXT("%-26s %10llu calls, %.2f us per frame."),
+			FParkourCycleStats::GetStatName((EParkourCycleStat)Index), Cycles.Calls[Index], TotalFrames > 0 ? Microseconds / TotalFrames : 0);
+	}
+
+	TSharedPtr<FJsonObject> BuildObject = MakeShared<FJsonObject>();
+	BuildObject->SetStringField(TEXT("engine"), FEngineVersion::Current().ToString());
+	BuildObject->SetStringField(TEXT("buildVersion"), FApp::GetBuildVersion());
+	BuildObject->SetStringField(TEXT("configuration"), LexToString(FApp::GetBuildConfiguration()));
+
+	TSharedPtr<FJsonObject> ReportObject = MakeShared<FJsonObject>();
+	ReportObject->SetObjectField(TEXT("build"), BuildObject);
+	ReportObject->SetStringField(TEXT("scene"), bAnalytic ? TEXT("analytic") : TEXT("world"));
+	ReportObject->SetStringField(TEXT("characterClass"), CharacterClass->GetPathName());
+	ReportObject->SetNumberField(TEXT("characters"), Runners.Num());
+	ReportObject->SetNumberField(TEXT("repeat"), Repeat);
+	ReportObject->SetNumberField(TEXT("step"), Step);
+	ReportObject->SetNumberField(TEXT("frames"), TotalFrames);
+	ReportObject->SetNumberField(TEXT("elapsedSeconds"), ElapsedSeconds);
+	ReportObject->SetNumberField(TEXT("tickUs"), TotalFrames > 0 ? TotalTickSeconds / TotalFrames * 1.e6 : 0);
+	ReportObject->SetNumberField(TEXT("maxTickUs"), MaxTickSeconds * 1.e6);
+	ReportObject->SetObjectField(TEXT("cycles"), Cycles.ToJson(TotalFrames));
+	ReportObject->SetObjectField(TEXT("traces"), (FParkourTraceCounts::Capture() - TracesAtStart).ToJson());
+	ReportObject->SetArrayField(TEXT("obstacles"), ObstacleValues);
+
+	FString ReportString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ReportString);
+	FJsonSerializer::Serialize(ReportObject.ToSharedRef(), Writer);
+	if (FFileHelper::SaveStringToFile(ReportString, *OutputFile) == false)
+	{
+		UE_LOG(LogParkourEditor, Error, TEXT("Could not write %s."), *OutputFile);
+		return 1;
+	}
+
+	UE_LOG(LogParkourEditor, Display, TEXT("Wrote %s."), *OutputFile);
+	return 0;
+}
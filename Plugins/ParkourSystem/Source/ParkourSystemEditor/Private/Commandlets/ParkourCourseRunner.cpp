@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/ParkourCourseRunner.h"
+#include "Commandlets/ParkourHeadlessWorld.h"
+#include "Components/ParkourMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Types/ParkourGameplayTags.h"
+
+// Distance from the face a runner starts at, out of reach of the wall scan.
+static constexpr float ParkourRunnerStartDistance = 250;
+
+// Frames of sideways input a climbing runner gives before it drops.
+static constexpr int ParkourRunnerClimbFrames = 60;
+
+// A runner not back on its feet after this many frames gives up on the obstacle.
+static constexpr int ParkourRunnerMaxLegFrames = 600;
+
+FParkourCourseRunner::FParkourCourseRunner(FParkourHeadlessWorld& InHeadlessWorld, TSubclassOf<ACharacter> InCharacterClass, const IParkourCollisionScene* InCollisionScene)
+	: HeadlessWorld(InHeadlessWorld)
+	, CharacterClass(InCharacterClass)
+	, CollisionScene(InCollisionScene)
+{
+}
+
+bool FParkourCourseRunner::Start(const FParkourObstacle& InObstacle, const float LateralOffset, const float Speed, const float InStep)
+{
+	// A runner stuck in an action would ignore the parkour button from here on.
+	if (ParkourMovement == nullptr || Leg.bCompleted == false)
+	{
+		if (ParkourMovement)
+		{
+			ParkourMovement->GetOwner()->Destroy();
+		}
+
+		ParkourMovement = HeadlessWorld.SpawnRunner(CharacterClass, FVector(0, 0, 200), FRotator::ZeroRotator);
+		if (ParkourMovement == nullptr)
+		{
+			return false;
+		}
+		ParkourMovement->SetCollisionScene(CollisionScene);
+	}
+
+	Obstacle = InObstacle;
+	Step = FMath::Max(InStep, 1.f);
+	Phase = EPhase::Approach;
+	ClimbFrames = 0;
+	Leg = FParkourCourseLeg();
+
+	FParkourObstacleCourse::PlaceProbe(ParkourMovement, Obstacle, ParkourRunnerStartDistance, LateralOffset, 0);
+	ACharacter* Character = CastChecked<ACharacter>(ParkourMovement->GetOwner());
+	Character->GetCharacterMovement()->MaxWalkSpeed = Speed;
+	LastPressLocation = Character->GetActorLocation();
+	return true;
+}
+
+void FParkourCourseRunner::AddInput()
+{
+	if (Phase == EPhase::Approach)
+	{
+		// Without a controller the control rotation is zero, so the input is turned towards the obstacle here.
+		const float YawRadians = FMath::DegreesToRadians(Obstacle.Yaw);
+		ParkourMovement->AddMovementInput(FVector2D(FMath::Sin(YawRadians), FMath::Cos(YawRadians)));
+
+		const FVector Location = ParkourMovement->GetOwner()->GetActorLocation();
+		if (FVector::Dist2D(Location, LastPressLocation) >= Step)
+		{
+			ParkourMovement->ParkourAction(false);
+			LastPressLocation = Location;
+			Leg.Presses++;
+		}
+	}
+	else if (Phase == EPhase::Climb)
+	{
+		if (ClimbFrames < ParkourRunnerClimbFrames)
+		{
+			ParkourMovement->AddMovementInput(FVector2D(1, 0));
+			ClimbFrames++;
+		}
+		else
+		{
+			ParkourMovement->ParkourDrop();
+		}
+	}
+}
+
+bool FParkourCourseRunner::Update()
+{
+	if (Phase == EPhase::Done)
+	{
+		return false;
+	}
+
+	Leg.Frames++;
+	const FGameplayTag Action = ParkourMovement->GetParkourAction();
+	const EParkourState State = ParkourMovement->GetParkourState();
+	switch (Phase)
+	{
+	case EPhase::Approach:
+		if (Action != ParkourTags::Action_NoAction)
+		{
+			Leg.Action = Action;
+			Leg.Distance = GetDistanceToFace();
+			Phase = EPhase::Action;
+		}
+		else if (GetDistanceToFace() <= 1)
+		{
+			Leg.Action = ParkourTags::Action_NoAction;
+			Leg.Distance = GetDistanceToFace();
+			Finish(true);
+		}
+		break;
+	case EPhase::Action:
+		if (Action == ParkourTags::Action_NoAction)
+		{
+			if (State == EParkourState::Climb)
+			{
+				Phase = EPhase::Climb;
+			}
+			else if (State == EParkourState::NotBusy && CastChecked<ACharacter>(ParkourMovement->GetOwner())->GetCharacterMovement()->IsMovingOnGround())
+			{
+				Finish(true);
+			}
+		}
+		break;
+	case EPhase::Climb:
+		// A hop or the drop, either way the action phase waits for it to end.
+		if (Action != ParkourTags::Action_NoAction || State != EParkourState::Climb)
+		{
+			Phase = EPhase::Action;
+		}
+		break;
+	default:
+		break;
+	}
+
+	if (Phase != EPhase::Done && Leg.Frames >= ParkourRunnerMaxLegFrames)
+	{
+		Finish(false);
+	}
+	return Phase != EPhase::Done;
+}
+
+float FParkourCourseRunner::GetDistanceToFace() const
+{
+	const ACharacter* Character = CastChecked<ACharacter>(ParkourMovement->GetOwner());
+	const FVector LocalLocation = Obstacle.GetTransform().InverseTransformPosition(Character->GetActorLocation());
+	return -LocalLocation.X - Character->GetCapsuleComponent()->GetScaledCapsuleRadius();
+}
+
+void FParkourCourseRunner::Finish(const bool bCompleted)
+{
+	Leg.bCompleted = bCompleted;
+	Phase = EPhase::Done;
+}
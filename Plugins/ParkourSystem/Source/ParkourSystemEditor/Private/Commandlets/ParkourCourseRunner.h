@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Templates/SubclassOf.h"
+#include "Commandlets/ParkourObstacleCourse.h"
+
+class ACharacter;
+class FParkourHeadlessWorld;
+class IParkourCollisionScene;
+class UParkourMovementComponent;
+
+/** How one runner got on at one obstacle. */
+struct FParkourCourseLeg
+{
+	/** First action the runner started, NoAction when it reached the face without one. */
+	FGameplayTag Action;
+
+	/** Gap between the capsule and the wall face when the action started. */
+	float Distance = 0;
+
+	int Presses = 0;
+
+	int Frames = 0;
+
+	/** The action played out and the runner was back on its feet before the time ran out. */
+	bool bCompleted = false;
+};
+
+/**
+ * Drives one character at an obstacle the way a player does: movement input towards the face, the parkour button
+ * every Step cm, sideways input for a while when it ends up climbing and then a drop. The world ticks between
+ * AddInput and Update. A runner that did not finish its last obstacle is replaced by a fresh character.
+ */
+class FParkourCourseRunner
+{
+public:
+
+	FParkourCourseRunner(FParkourHeadlessWorld& InHeadlessWorld, TSubclassOf<ACharacter> InCharacterClass, const IParkourCollisionScene* InCollisionScene);
+
+	/** Stands the character in front of the obstacle, LateralOffset along the face, to approach it at Speed. */
+	bool Start(const FParkourObstacle& InObstacle, const float LateralOffset, const float Speed, const float InStep);
+
+	/** Input for the coming frame. */
+	void AddInput();
+
+	/** Follows up on the frame that was just ticked, false once the runner is done with the obstacle. */
+	bool Update();
+
+	const FParkourCourseLeg& GetLeg() const { return Leg; }
+
+private:
+
+	enum class EPhase : uint8
+	{
+		Approach,
+		Action,
+		Climb,
+		Done
+	};
+
+	/** Gap between the capsule and the face, negative once the runner got past it. */
+	float GetDistanceToFace() const;
+
+	void Finish(const bool bCompleted);
+
+	FParkourHeadlessWorld& HeadlessWorld;
+
+	TSubclassOf<ACharacter> CharacterClass;
+
+	const IParkourCollisionScene* CollisionScene = nullptr;
+
+	UParkourMovementComponent* ParkourMovement = nullptr;
+
+	FParkourObstacle Obstacle;
+
+	float Step = 20;
+
+	FVector LastPressLocation = FVector::ZeroVector;
+
+	EPhase Phase = EPhase::Done;
+
+	int ClimbFrames = 0;
+
+	FParkourCourseLeg Leg;
+};
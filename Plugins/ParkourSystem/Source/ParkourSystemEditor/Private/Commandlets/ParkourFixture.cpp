@@ -0,0 +1,325 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/ParkourFixture.h"
+#include "Types/ParkourGameplayTags.h"
+#include "ParkourSystemEditor.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+
+static TSharedPtr<FJsonValue> MakeVectorValue(const FVector& Vector)
+{
+	TArray<TSharedPtr<FJsonValue>> Values;
+	Values.Add(MakeShared<FJsonValueNumber>(FMath::RoundToDouble(Vector.X * 100) / 100));
+	Values.Add(MakeShared<FJsonValueNumber>(FMath::RoundToDouble(Vector.Y * 100) / 100));
+	Values.Add(MakeShared<FJsonValueNumber>(FMath::RoundToDouble(Vector.Z * 100) / 100));
+	return MakeShared<FJsonValueArray>(Values);
+}
+
+static bool ReadVector(const TSharedPtr<FJsonObject>& Object, const TCHAR* Field, FVector& OutVector)
+{
+	const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+	if (Object.IsValid() && Object->TryGetArrayField(Field, Values) && Values->Num() == 3)
+	{
+		OutVector = FVector((*Values)[0]->AsNumber(), (*Values)[1]->AsNumber(), (*Values)[2]->AsNumber());
+		return true;
+	}
+	return false;
+}
+
+static TOptional<FVector> GetAnchor(const FParkourFixture& Fixture, const FHitResult& Hit)
+{
+	if (Hit.bBlockingHit)
+	{
+		return Fixture.Obstacle.GetTransform().InverseTransformPosition(Hit.ImpactPoint);
+	}
+	return TOptional<FVector>();
+}
+
+static void CompareAnchor(const TCHAR* AnchorName, const TOptional<FVector>& Expected, const TOptional<FVector>& Actual, const float Tolerance, TArray<FString>& OutDifferences)
+{
+	if (Expected.IsSet() != Actual.IsSet())
+	{
+		OutDifferences.Add(FString::Printf(TEXT("%s %s"), AnchorName, Expected.IsSet() ? TEXT("missing") : TEXT("unexpected")));
+	}
+	else if (Expected.IsSet() && FVector::Dist(Expected.GetValue(), Actual.GetValue()) > Tolerance)
+	{
+		OutDifferences.Add(FString::Printf(TEXT("%s at %s, expected %s"), AnchorName, *Actual.GetValue().ToCompactString(), *Expected.GetValue().ToCompactString()));
+	}
+}
+
+void FParkourFixture::Bless(const FParkourScanEvaluation& Evaluation)
+{
+	ExpectedAction = FParkourObstacleCourse::GetTagName(Evaluation.Action);
+	ExpectedClimbStyle = FParkourObstacleCourse::GetTagName(ParkourTags::FromClimbStyle(Evaluation.ClimbStyle));
+	WallTop = GetAnchor(*this, Evaluation.WallTopResult);
+	WallDepth = GetAnchor(*this, Evaluation.WallDepthResult);
+	WallVault = GetAnchor(*this, Evaluation.WallVaultResult);
+	Ledge = GetAnchor(*this, Evaluation.ClimbedLedgeResult);
+	bBlessed = true;
+}
+
+void FParkourFixture::Compare(const FParkourScanEvaluation& Evaluation, const float Tolerance, TArray<FString>& OutDifferences) const
+{
+	const FString Action = FParkourObstacleCourse::GetTagName(Evaluation.Action);
+	if (ExpectedAction.IsEmpty() == false && Action != ExpectedAction)
+	{
+		OutDifferences.Add(FString::Printf(TEXT("action %s, expected %s"), *Action, *ExpectedAction));
+	}
+
+	const FString ClimbStyle = FParkourObstacleCourse::GetTagName(ParkourTags::FromClimbStyle(Evaluation.ClimbStyle));
+	if (ExpectedClimbStyle.IsEmpty() == false && ClimbStyle != ExpectedClimbStyle)
+	{
+		OutDifferences.Add(FString::Printf(TEXT("climb style %s, expected %s"), *ClimbStyle, *ExpectedClimbStyle));
+	}
+
+	if (bBlessed)
+	{
+		CompareAnchor(TEXT("wall top"), WallTop, GetAnchor(*this, Evaluation.WallTopResult), Tolerance, OutDifferences);
+		CompareAnchor(TEXT("wall depth"), WallDepth, GetAnchor(*this, Evaluation.WallDepthResult), Tolerance, OutDifferences);
+		CompareAnchor(TEXT("wall vault"), WallVault, GetAnchor(*this, Evaluation.WallVaultResult), Tolerance, OutDifferences);
+		CompareAnchor(TEXT("ledge"), Ledge, GetAnchor(*this, Evaluation.ClimbedLedgeResult), Tolerance, OutDifferences);
+	}
+}
+
+static bool ReadObstacle(const TSharedPtr<FJsonObject>& ObstacleObject, FParkourObstacle& OutObstacle)
+{
+	if (ObstacleObject.IsValid() == false)
+	{
+		return false;
+	}
+
+	const FString Kind = ObstacleObject->GetStringField(TEXT("kind"));
+	const float Height = ObstacleObject->GetNumberField(TEXT("height"));
+	double HalfWidth = 200;
+	ObstacleObject->TryGetNumberField(TEXT("halfWidth"), HalfWidth);
+
+	if (Kind == TEXT("Wall"))
+	{
+		double Drop = Height;
+		ObstacleObject->TryGetNumberField(TEXT("drop"), Drop);
+		OutObstacle = FParkourObstacleCourse::MakeWall(Height, ObstacleObject->GetNumberField(TEXT("depth")), Drop, HalfWidth);
+	}
+	else if (Kind == TEXT("BracedLedge"))
+	{
+		OutObstacle = FParkourObstacleCourse::MakeBracedLedge(Height, HalfWidth);
+	}
+	else if (Kind == TEXT("FreeHangLedge"))
+	{
+		OutObstacle = FParkourObstacleCourse::MakeFreeHangLedge(Height, HalfWidth);
+	}
+	else
+	{
+		// Anything else is spelled out box by box.
+		OutObstacle = FParkourObstacle();
+		OutObstacle.Kind = Kind;
+		OutObstacle.WallHeight = Height;
+		OutObstacle.HalfWidth = HalfWidth;
+		const TArray<TSharedPtr<FJsonValue>>* BoxValues = nullptr;
+		if (ObstacleObject->TryGetArrayField(TEXT("boxes"), BoxValues) == false)
+		{
+			return false;
+		}
+		for (const TSharedPtr<FJsonValue>& BoxValue : *BoxValues)
+		{
+			const TSharedPtr<FJsonObject> BoxObject = BoxValue->AsObject();
+			FParkourObstacleBox& Box = OutObstacle.Boxes.AddDefaulted_GetRef();
+			if (ReadVector(BoxObject, TEXT("center"), Box.Center) == false || ReadVector(BoxObject, TEXT("halfSize"), Box.HalfSize) == false)
+			{
+				return false;
+			}
+			double Yaw = 0;
+			double Pitch = 0;
+			BoxObject->TryGetNumberField(TEXT("yaw"), Yaw);
+			BoxObject->TryGetNumberField(TEXT("pitch"), Pitch);
+			Box.Yaw = Yaw;
+			Box.Pitch = Pitch;
+		}
+	}
+	return true;
+}
+
+static TSharedPtr<FJsonObject> WriteObstacle(const FParkourObstacle& Obstacle)
+{
+	TSharedPtr<FJsonObject> ObstacleObject = MakeShared<FJsonObject>();
+	ObstacleObject->SetStringField(TEXT("kind"), Obstacle.Kind);
+	ObstacleObject->SetNumberField(TEXT("height"), Obstacle.WallHeight);
+	ObstacleObject->SetNumberField(TEXT("halfWidth"), Obstacle.HalfWidth);
+
+	if (Obstacle.Kind == TEXT("Wall"))
+	{
+		ObstacleObject->SetNumberField(TEXT("depth"), Obstacle.Depth);
+		ObstacleObject->SetNumberField(TEXT("drop"), Obstacle.Drop);
+	}
+	else if (Obstacle.Kind != TEXT("BracedLedge") && Obstacle.Kind != TEXT("FreeHangLedge"))
+	{
+		TArray<TSharedPtr<FJsonValue>> BoxValues;
+		for (const FParkourObstacleBox& Box : Obstacle.Boxes)
+		{
+			TSharedPtr<FJsonObject> BoxObject = MakeShared<FJsonObject>();
+			BoxObject->SetField(TEXT("center"), MakeVectorValue(Box.Center));
+			BoxObject->SetField(TEXT("halfSize"), MakeVectorValue(Box.HalfSize));
+			BoxObject->SetNumberField(TEXT("yaw"), Box.Yaw);
+			if (Box.Pitch != 0)
+			{
+				BoxObject->SetNumberField(TEXT("pitch"), Box.Pitch);
+			}
+			BoxValues.Add(MakeShared<FJsonValueObject>(BoxObject));
+		}
+		ObstacleObject->SetArrayField(TEXT("boxes"), BoxValues);
+	}
+	return ObstacleObject;
+}
+
+bool FParkourFixtureCatalogue::LoadFromFile(const FString& Filename)
+{
+	FString FileString;
+	TSharedPtr<FJsonObject> CatalogueObject;
+	if (FFileHelper::LoadFileToString(FileString, *Filename) == false || FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(FileString), CatalogueObject) == false || CatalogueObject.IsValid() == false)
+	{
+		UE_LOG(LogParkourEditor, Error, TEXT("Could not read the parkour fixtures in %s."), *Filename);
+		return false;
+	}
+
+	double CatalogueTolerance = Tolerance;
+	CatalogueObject->TryGetNumberField(TEXT("tolerance"), CatalogueTolerance);
+	Tolerance = CatalogueTolerance;
+	CatalogueTolerance = BakedTolerance;
+	CatalogueObject->TryGetNumberField(TEXT("bakedTolerance"), CatalogueTolerance);
+	BakedTolerance = CatalogueTolerance;
+	Fixtures.Reset();
+
+	const TArray<TSharedPtr<FJsonValue>>* FixtureValues = nullptr;
+	if (CatalogueObject->TryGetArrayField(TEXT("fixtures"), FixtureValues) == false)
+	{
+		return true;
+	}
+
+	for (const TSharedPtr<FJsonValue>& FixtureValue : *FixtureValues)
+	{
+		const TSharedPtr<FJsonObject> FixtureObject = FixtureValue->AsObject();
+		if (FixtureObject.IsValid() == false)
+		{
+			continue;
+		}
+
+		FParkourFixture& Fixture = Fixtures.AddDefaulted_GetRef();
+		Fixture.Name = FixtureObject->GetStringField(TEXT("name"));
+		if (ReadObstacle(FixtureObject->GetObjectField(TEXT("obstacle")), Fixture.Obstacle) == false)
+		{
+			UE_LOG(LogParkourEditor, Error, TEXT("Fixture %s in %s has no usable obstacle."), *Fixture.Name, *Filename);
+			Fixtures.Pop();
+			continue;
+		}
+		Fixture.Obstacle.Name = Fixture.Name;
+
+		double Number = Fixture.Distance;
+		FixtureObject->TryGetNumberField(TEXT("distance"), Number);
+		Fixture.Distance = Number;
+		Number = Fixture.LateralOffset;
+		FixtureObject->TryGetNumberField(TEXT("lateralOffset"), Number);
+		Fixture.LateralOffset = Number;
+		Number = Fixture.Speed;
+		FixtureObject->TryGetNumberField(TEXT("speed"), Number);
+		Fixture.Speed = Number;
+
+		const TSharedPtr<FJsonObject>* ExpectedObject = nullptr;
+		if (FixtureObject->TryGetObjectField(TEXT("expected"), ExpectedObject))
+		{
+			(*ExpectedObject)->TryGetStringField(TEXT("action"), Fixture.ExpectedAction);
+			(*ExpectedObject)->TryGetStringField(TEXT("climbStyle"), Fixture.ExpectedClimbStyle);
+
+			const TSharedPtr<FJsonObject>* AnchorsObject = nullptr;
+			if ((*ExpectedObject)->TryGetObjectField(TEXT("anchors"), AnchorsObject))
+			{
+				Fixture.bBlessed = true;
+				FVector Anchor;
+				if (ReadVector(*AnchorsObject, TEXT("wallTop"), Anchor))
+				{
+					Fixture.WallTop = Anchor;
+				}
+				if (ReadVector(*AnchorsObject, TEXT("wallDepth"), Anchor))
+				{
+					Fixture.WallDepth = Anchor;
+				}
+				if (ReadVector(*AnchorsObject, TEXT("wallVault"), Anchor))
+				{
+					Fixture.WallVault = Anchor;
+				}
+				if (ReadVector(*AnchorsObject, TEXT("ledge"), Anchor))
+				{
+					Fixture.Ledge = Anchor;
+				}
+			}
+		}
+
+		const TSharedPtr<FJsonObject>* NotesObject = nullptr;
+		if (FixtureObject->TryGetObjectField(TEXT("notes"), NotesObject))
+		{
+			Fixture.Notes = *NotesObject;
+		}
+	}
+	return true;
+}
+
+bool FParkourFixtureCatalogue::SaveToFile(const FString& Filename) const
+{
+	TArray<TSharedPtr<FJsonValue>> FixtureValues;
+	for (const FParkourFixture& Fixture : Fixtures)
+	{
+		TSharedPtr<FJsonObject> FixtureObject = MakeShared<FJsonObject>();
+		FixtureObject->SetStringField(TEXT("name"), Fixture.Name);
+		FixtureObject->SetObjectField(TEXT("obstacle"), WriteObstacle(Fixture.Obstacle));
+		FixtureObject->SetNumberField(TEXT("distance"), Fixture.Distance);
+		FixtureObject->SetNumberField(TEXT("lateralOffset"), Fixture.LateralOffset);
+		FixtureObject->SetNumberField(TEXT("speed"), Fixture.Speed);
+
+		TSharedPtr<FJsonObject> ExpectedObject = MakeShared<FJsonObject>();
+		ExpectedObject->SetStringField(TEXT("action"), Fixture.ExpectedAction);
+		ExpectedObject->SetStringField(TEXT("climbStyle"), Fixture.ExpectedClimbStyle);
+		if (Fixture.bBlessed)
+		{
+			TSharedPtr<FJsonObject> AnchorsObject = MakeShared<FJsonObject>();
+			if (Fixture.WallTop.IsSet())
+			{
+				AnchorsObject->SetField(TEXT("wallTop"), MakeVectorValue(Fixture.WallTop.GetValue()));
+			}
+			if (Fixture.WallDepth.IsSet())
+			{
+				AnchorsObject->SetField(TEXT("wallDepth"), MakeVectorValue(Fixture.WallDepth.GetValue()));
+			}
+			if (Fixture.WallVault.IsSet())
+			{
+				AnchorsObject->SetField(TEXT("wallVault"), MakeVectorValue(Fixture.WallVault.GetValue()));
+			}
+			if (Fixture.Ledge.IsSet())
+			{
+				AnchorsObject->SetField(TEXT("ledge"), MakeVectorValue(Fixture.Ledge.GetValue()));
+			}
+			ExpectedObject->SetObjectField(TEXT("anchors"), AnchorsObject);
+		}
+		FixtureObject->SetObjectField(TEXT("expected"), ExpectedObject);
+
+		if (Fixture.Notes.IsValid())
+		{
+			FixtureObject->SetObjectField(TEXT("notes"), Fixture.Notes);
+		}
+		FixtureValues.Add(MakeShared<FJsonValueObject>(FixtureObject));
+	}
+
+	TSharedPtr<FJsonObject> CatalogueObject = MakeShared<FJsonObject>();
+	CatalogueObject->SetNumberField(TEXT("tolerance"), Tolerance);
+	CatalogueObject->SetNumberField(TEXT("bakedTolerance"), BakedTolerance);
+	CatalogueObject->SetArrayField(TEXT("fixtures"), FixtureValues);
+
+	FString FileString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&FileString);
+	FJsonSerializer::Serialize(CatalogueObject.ToSharedRef(), Writer);
+	if (FFileHelper::SaveStringToFile(FileString, *Filename) == false)
+	{
+		UE_LOG(LogParkourEditor, Error, TEXT("Could not write %s."), *Filename);
+		return false;
+	}
+	return true;
+}
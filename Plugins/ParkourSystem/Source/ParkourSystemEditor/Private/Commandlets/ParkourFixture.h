@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/ParkourObstacleCourse.h"
+
+class FJsonObject;
+
+/** An obstacle and a probe pose in front of it, with the scan result the pose is expected to give. */
+struct FParkourFixture
+{
+	FString Name;
+
+	FParkourObstacle Obstacle;
+
+	/** Gap between the probe capsule and the obstacle face. */
+	float Distance = 30;
+
+	float LateralOffset = 0;
+
+	float Speed = 0;
+
+	/** Parkour.Action tag name the scan must pick. */
+	FString ExpectedAction;
+
+	/** Parkour.ClimbStyle tag name the scan must leave. */
+	FString ExpectedClimbStyle;
+
+	/** Set once the fixture has been blessed with -Update, the anchors below are only checked then. */
+	bool bBlessed = false;
+
+	/**
+	 * Warp anchors in the obstacle frame: wall top, depth and vault impact points and the climbed ledge.
+	 * Unset when the scan must not find them.
+	 */
+	TOptional<FVector> WallTop;
+
+	TOptional<FVector> WallDepth;
+
+	TOptional<FVector> WallVault;
+
+	TOptional<FVector> Ledge;
+
+	/** Anything else the writer of the fixture wants to keep, the fuzzer stores the cost that made it keep a layout. */
+	TSharedPtr<FJsonObject> Notes;
+
+	/** Takes the expected results, anchors included, from an evaluation of this fixture. */
+	void Bless(const FParkourScanEvaluation& Evaluation);
+
+	/** Describes every way Evaluation differs from the expected results, empty when it matches. */
+	void Compare(const FParkourScanEvaluation& Evaluation, const float Tolerance, TArray<FString>& OutDifferences) const;
+};
+
+/** A fixture file, see Plugins/ParkourSystem/Fixtures. */
+struct FParkourFixtureCatalogue
+{
+	bool LoadFromFile(const FString& Filename);
+
+	bool SaveToFile(const FString& Filename) const;
+
+	/** Largest distance in cm an anchor may move before it counts as a difference. */
+	float Tolerance = 2;
+
+	/** Tolerance for scans answered from baked ledges or simple collision, which place the anchors from the edge instead of trace hits. */
+	float BakedTolerance = 10;
+
+	TArray<FParkourFixture> Fixtures;
+};
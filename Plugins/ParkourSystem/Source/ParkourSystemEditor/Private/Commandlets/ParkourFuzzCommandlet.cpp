@@ -0,0 +1,404 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/ParkourFuzzCommandlet.h"
+#include "Commandlets/ParkourHeadlessWorld.h"
+#include "Commandlets/ParkourFixture.h"
+#include "Collision/ParkourAnalyticScene.h"
+#include "Components/ParkourMovementComponent.h"
+#include "GameFramework/Actor.h"
+#include "Types/ParkourGameplayTags.h"
+#include "ParkourSystemEditor.h"
+#include "Dom/JsonObject.h"
+#include "Math/RandomStream.h"
+#include "Misc/Paths.h"
+
+/** Layouts spawned at a time, few enough that a batch fits on the headless world floor. */
+static constexpr int ParkourFuzzBatchSize = 64;
+
+/** A random obstacle, and the lateral offset to approach it along where the generator needs the probe in one spot. */
+struct FParkourFuzzLayout
+{
+	FParkourObstacle Obstacle;
+
+	TOptional<float> LateralOffset;
+};
+
+/** One layout and the probe poses tried on it, with what the approach and the drop down cost apart. */
+struct FParkourFuzzSample
+{
+	FParkourObstacle Obstacle;
+
+	int32 Seed = 0;
+
+	FString Generator;
+
+	float LateralOffset = 0;
+
+	float Speed = 0;
+
+	/** How far behind the face the probe stands for the drop down. */
+	float DropInset = 30;
+
+	FParkourObstacleRun Run;
+
+	FParkourTraceCounts RunTraces;
+
+	FParkourScanEvaluation Drop;
+
+	FParkourTraceCounts DropTraces;
+
+	uint64 GetTraces() const { return RunTraces.GetTotal() + DropTraces.GetTotal(); }
+
+	double GetSeconds() const { return Run.WallShapeSeconds + Run.DecisionSeconds + Drop.WallShapeSeconds; }
+};
+
+static FParkourObstacleBox& AddFuzzBox(FParkourObstacle& Obstacle, const FVector& Min, const FVector& Max)
+{
+	FParkourObstacleBox& Box = Obstacle.Boxes.AddDefaulted_GetRef();
+	Box.Center = (Min + Max) * 0.5f;
+	Box.HalfSize = (Max - Min) * 0.5f;
+	return Box;
+}
+
+/** A block with a tilted slab on top, so the top the scan steps along is never level. */
+static FParkourFuzzLayout MakeSlantedTop(FRandomStream& Stream)
+{
+	FParkourFuzzLayout Layout;
+	FParkourObstacle& Obstacle = Layout.Obstacle;
+	const float Height = Stream.FRandRange(60, 240);
+	const float Depth = Stream.FRandRange(40, 200);
+	const float Pitch = Stream.FRandRange(-35, 35);
+	const float SlabThickness = 10;
+	Obstacle.HalfWidth = Stream.FRandRange(100, 250);
+	Obstacle.Depth = Depth;
+
+	AddFuzzBox(Obstacle, FVector(0, -Obstacle.HalfWidth, 0), FVector(Depth, Obstacle.HalfWidth, Height));
+	FParkourObstacleBox& Slab = Obstacle.Boxes.AddDefaulted_GetRef();
+	Slab.Center = FVector(Depth * 0.5f, 0, Height);
+	Slab.HalfSize = FVector(Depth * 0.5f / FMath::Cos(FMath::DegreesToRadians(Pitch)), Obstacle.HalfWidth, SlabThickness * 0.5f);
+	Slab.Pitch = Pitch;
+	if (Stream.FRand() < 0.5f)
+	{
+		Slab.Yaw = Stream.FRandRange(-15, 15);
+	}
+
+	Obstacle.WallHeight = Height + (SlabThickness * 0.5f) - (Depth * 0.5f * FMath::Tan(FMath::DegreesToRadians(Pitch)));
+	return Layout;
+}
+
+/** A row of narrow blocks of uneven height with gaps between them, each one a candidate top for the depth scan. */
+static FParkourFuzzLayout MakeGaps(FRandomStream& Stream)
+{
+	FParkourFuzzLayout Layout;
+	FParkourObstacle& Obstacle = Layout.Obstacle;
+	const float BaseHeight = Stream.FRandRange(60, 220);
+	const int NumBlocks = Stream.RandRange(2, 4);
+	Obstacle.HalfWidth = Stream.FRandRange(100, 250);
+
+	float X = 0;
+	for (int Index = 0; Index < NumBlocks; Index++)
+	{
+		const float Depth = Stream.FRandRange(10, 80);
+		const float Height = FMath::Max(BaseHeight + Stream.FRandRange(-25, 25), 20.f);
+		AddFuzzBox(Obstacle, FVector(X, -Obstacle.HalfWidth, 0), FVector(X + Depth, Obstacle.HalfWidth, Height));
+		if (Index == 0)
+		{
+			Obstacle.WallHeight = Height;
+		}
+		X += Depth + Stream.FRandRange(8, 60);
+	}
+	Obstacle.Depth = X;
+	return Layout;
+}
+
+/** A rail a few cm thick on two posts, sometimes with a low wall set back under it. */
+static FParkourFuzzLayout MakeThinRail(FRandomStream& Stream)
+{
+	FParkourFuzzLayout Layout;
+	FParkourObstacle& Obstacle = Layout.Obstacle;
+	const float Height = Stream.FRandRange(60, 180);
+	const float Thickness = Stream.FRandRange(2, 10);
+	const float PostWidth = 5;
+	Obstacle.HalfWidth = Stream.FRandRange(100, 250);
+	Obstacle.WallHeight = Height;
+	Obstacle.Depth = Thickness;
+
+	AddFuzzBox(Obstacle, FVector(0, -Obstacle.HalfWidth, Height - Thickness), FVector(Thickness, Obstacle.HalfWidth, Height));
+	AddFuzzBox(Obstacle, FVector(0, -Obstacle.HalfWidth, 0), FVector(Thickness, -Obstacle.HalfWidth + PostWidth, Height - Thickness));
+	AddFuzzBox(Obstacle, FVector(0, Obstacle.HalfWidth - PostWidth, 0), FVector(Thickness, Obstacle.HalfWidth, Height - Thickness));
+
+	if (Stream.FRand() < 0.5f)
+	{
+		const float SetBack = Stream.FRandRange(0, 60);
+		const float WallHeight = Stream.FRandRange(20, FMath::Max(Height - 30, 21.f));
+		AddFuzzBox(Obstacle, FVector(SetBack, -Obstacle.HalfWidth, 0), FVector(SetBack + 20, Obstacle.HalfWidth, WallHeight));
+	}
+	return Layout;
+}
+
+/** Tiers stepping up and back, some with a thin lip sticking out, so the hand finds a ledge at several heights. */
+static FParkourFuzzLayout MakeStackedLedges(FRandomStream& Stream)
+{
+	FParkourFuzzLayout Layout;
+	FParkourObstacle& Obstacle = Layout.Obstacle;
+	const int NumTiers = Stream.RandRange(2, 4);
+	Obstacle.HalfWidth = Stream.FRandRange(100, 250);
+
+	float X = 0;
+	float Top = 0;
+	for (int Index = 0; Index < NumTiers; Index++)
+	{
+		const float TierDepth = Stream.FRandRange(40, 150);
+		Top += Stream.FRandRange(25, 90);
+		AddFuzzBox(Obstacle, FVector(X, -Obstacle.HalfWidth, 0), FVector(X + TierDepth, Obstacle.HalfWidth, Top));
+		if (Index == 0)
+		{
+			Obstacle.WallHeight = Top;
+		}
+		else if (Stream.FRand() < 0.3f)
+		{
+			const float Overhang = Stream.FRandRange(5, 30);
+			AddFuzzBox(Obstacle, FVector(X - Overhang, -Obstacle.HalfWidth, Top - 10), FVector(X, Obstacle.HalfWidth, Top));
+		}
+		X += Stream.FRandRange(0, 60);
+	}
+	Obstacle.Depth = X + 150;
+	return Layout;
+}
+
+/** A block with a side wall running back towards the runner, approached from inside the corner. */
+static FParkourFuzzLayout MakeConcaveCorner(FRandomStream& Stream)
+{
+	FParkourFuzzLayout Layout;
+	FParkourObstacle& Obstacle = Layout.Obstacle;
+	const float Height = Stream.FRandRange(60, 240);
+	const float Depth = Stream.FRandRange(40, 200);
+	Obstacle.HalfWidth = Stream.FRandRange(80, 200);
+	Obstacle.WallHeight = Height;
+	Obstacle.Depth = Depth;
+	AddFuzzBox(Obstacle, FVector(0, -Obstacle.HalfWidth, 0), FVector(Depth, Obstacle.HalfWidth, Height));
+
+	const float SideY = Stream.FRandRange(-Obstacle.HalfWidth + 60, Obstacle.HalfWidth - 20);
+	const float SideLength = Stream.FRandRange(100, 300);
+	const float SideThickness = Stream.FRandRange(20, 60);
+	FParkourObstacleBox& Side = AddFuzzBox(Obstacle, FVector(-SideLength, SideY, 0), FVector(Depth, SideY + SideThickness, Stream.FRandRange(40, 300)));
+	if (Stream.FRand() < 0.4f)
+	{
+		Side.Yaw = Stream.FRandRange(-30, 30);
+	}
+
+	Layout.LateralOffset = SideY - Stream.FRandRange(30, 80);
+	return Layout;
+}
+
+struct FParkourFuzzGenerator
+{
+	const TCHAR* Name;
+
+	FParkourFuzzLayout (*Make)(FRandomStream& Stream);
+};
+
+static const FParkourFuzzGenerator ParkourFuzzGenerators[] =
+{
+	{ TEXT("SlantedTop"), &MakeSlantedTop },
+	{ TEXT("Gaps"), &MakeGaps },
+	{ TEXT("ThinRail"), &MakeThinRail },
+	{ TEXT("StackedLedges"), &MakeStackedLedges },
+	{ TEXT("ConcaveCorner"), &MakeConcaveCorner },
+};
+
+static FParkourFuzzSample MakeFuzzSample(const int32 Seed, const float RunSpeed)
+{
+	FRandomStream Stream(Seed);
+	const FParkourFuzzGenerator& Generator = ParkourFuzzGenerators[Stream.RandHelper(UE_ARRAY_COUNT(ParkourFuzzGenerators))];
+
+	FParkourFuzzSample Sample;
+	Sample.Seed = Seed;
+	Sample.Generator = Generator.Name;
+	Sample.Speed = Stream.FRand() < 0.5f ? RunSpeed : 0;
+	Sample.DropInset = Stream.FRandRange(10, 60);
+
+	const FParkourFuzzLayout Layout = Generator.Make(Stream);
+	const float MaxLateralOffset = FMath::Max(Layout.Obstacle.HalfWidth - 40, 0.f);
+	Sample.LateralOffset = FMath::Clamp(Layout.LateralOffset.Get(Stream.FRandRange(-100, 100)), -MaxLateralOffset, MaxLateralOffset);
+
+	FParkourObstacle& Obstacle = Sample.Obstacle;
+	Obstacle = Layout.Obstacle;
+	Obstacle.Kind = TEXT("Fuzz");
+	Obstacle.Name = FString::Printf(TEXT("Fuzz_%s_%d"), Generator.Name, Seed);
+	Obstacle.Drop = Obstacle.WallHeight;
+	return Sample;
+}
+
+static FParkourFixture MakeFuzzFixture(const FParkourFuzzSample& Sample)
+{
+	FParkourFixture Fixture;
+	Fixture.Name = Sample.Obstacle.Name;
+	Fixture.Obstacle = Sample.Obstacle;
+	Fixture.Distance = Sample.Run.Distance;
+	Fixture.LateralOffset = Sample.LateralOffset;
+	Fixture.Speed = Sample.Speed;
+
+	// Left unblessed, -run=ParkourGolden -Update takes the anchors once someone has looked at the layout.
+	Fixture.ExpectedAction = FParkourObstacleCourse::GetTagName(Sample.Run.Evaluation.Action);
+	Fixture.ExpectedClimbStyle = FParkourObstacleCourse::GetTagName(ParkourTags::FromClimbStyle(Sample.Run.Evaluation.ClimbStyle));
+
+	Fixture.Notes = MakeShared<FJsonObject>();
+	Fixture.Notes->SetNumberField(TEXT("seed"), Sample.Seed);
+	Fixture.Notes->SetStringField(TEXT("generator"), Sample.Generator);
+	Fixture.Notes->SetNumberField(TEXT("traces"), (double)Sample.GetTraces());
+	Fixture.Notes->SetNumberField(TEXT("us"), Sample.GetSeconds() * 1.e6);
+	Fixture.Notes->SetNumberField(TEXT("scans"), Sample.Run.Scans);
+	Fixture.Notes->SetObjectField(TEXT("scanTraces"), Sample.RunTraces.ToJson());
+	Fixture.Notes->SetNumberField(TEXT("maxScanUs"), Sample.Run.MaxScanSeconds * 1.e6);
+	Fixture.Notes->SetNumberField(TEXT("dropInset"), Sample.DropInset);
+	Fixture.Notes->SetStringField(TEXT("dropAction"), FParkourObstacleCourse::GetTagName(Sample.Drop.Action));
+	Fixture.Notes->SetObjectField(TEXT("dropTraces"), Sample.DropTraces.ToJson());
+	Fixture.Notes->SetNumberField(TEXT("dropUs"), Sample.Drop.WallShapeSeconds * 1.e6);
+	return Fixture;
+}
+
+UParkourFuzzCommandlet::UParkourFuzzCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UParkourFuzzCommandlet::Main(const FString& Params)
+{
+	int32 Seed = 1;
+	int32 NumLayouts = 256;
+	int32 Keep = 16;
+	float Step = 10;
+	float RunSpeed = 350;
+	FString Rank = TEXT("Traces");
+	FString OutputFile = FPaths::ProjectSavedDir() / TEXT("Parkour") / TEXT("FuzzWorst.json");
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Layouts="), NumLayouts);
+	FParse::Value(*Params, TEXT("Keep="), Keep);
+	FParse::Value(*Params, TEXT("Step="), Step);
+	FParse::Value(*Params, TEXT("RunSpeed="), RunSpeed);
+	FParse::Value(*Params, TEXT("Rank="), Rank);
+	FParse::Value(*Params, TEXT("Output="), OutputFile);
+	const bool bAnalytic = FParse::Param(*Params, TEXT("Analytic"));
+	const bool bRankByTime = Rank == TEXT("Time");
+	Keep = FMath::Max(Keep, 1);
+
+	FParkourHeadlessWorld HeadlessWorld;
+	UWorld* World = HeadlessWorld.GetWorld();
+	FParkourAnalyticScene AnalyticScene;
+	TArray<AActor*> FloorActors;
+	if (bAnalytic == false)
+	{
+		FParkourObstacleCourse::SpawnFloor(World, FloorActors);
+	}
+
+	UParkourMovementComponent* Probe = HeadlessWorld.SpawnProbe(FVector(0, 0, 200), FRotator::ZeroRotator);
+	if (Probe == nullptr)
+	{
+		UE_LOG(LogParkourEditor, Error, TEXT("Could not spawn the parkour probe character."));
+		return 1;
+	}
+	Probe->SetCollisionScene(bAnalytic ? &AnalyticScene : nullptr);
+
+	auto GetCost = [bRankByTime](const FParkourFuzzSample& Sample)
+	{
+		return bRankByTime ? Sample.GetSeconds() : (double)Sample.GetTraces();
+	};
+
+	TArray<FParkourFuzzSample> Worst;
+	TMap<FString, uint64> WorstTracesByGenerator;
+	uint64 TotalTraces = 0;
+	double TotalSeconds = 0;
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 BatchStart = 0; BatchStart < NumLayouts; BatchStart += ParkourFuzzBatchSize)
+	{
+		TArray<FParkourFuzzSample> Samples;
+		TArray<FParkourObstacle> Obstacles;
+		for (int32 Index = BatchStart; Index < FMath::Min(BatchStart + ParkourFuzzBatchSize, NumLayouts); Index++)
+		{
+			Samples.Add(MakeFuzzSample(Seed + Index, RunSpeed));
+			Obstacles.Add(Samples.Last().Obstacle);
+		}
+		FParkourObstacleCourse::LayOut(Obstacles);
+
+		TArray<AActor*> BatchActors;
+		if (bAnalytic)
+		{
+			AnalyticScene.Reset();
+			AnalyticScene.AddSlab(0);
+		}
+		for (int Index = 0; Index < Samples.Num(); Index++)
+		{
+			Samples[Index].Obstacle.Origin = Obstacles[Index].Origin;
+			if (bAnalytic)
+			{
+				FParkourObstacleCourse::AddToScene(Obstacles[Index], AnalyticScene);
+			}
+			else
+			{
+				FParkourObstacleCourse::SpawnInWorld(Obstacles[Index], World, BatchActors);
+			}
+		}
+		HeadlessWorld.Tick();
+
+		for (FParkourFuzzSample& Sample : Samples)
+		{
+			const FParkourObstacle& Obstacle = Sample.Obstacle;
+			const FParkourTraceCounts TracesBeforeRun = FParkourTraceCounts::Capture();
+			Sample.Run = FParkourObstacleCourse::Run(Probe, Obstacle, Sample.LateralOffset, Sample.Speed, Step);
+			Sample.RunTraces = FParkourTraceCounts::Capture() - TracesBeforeRun;
+
+			const FParkourTraceCounts TracesBeforeDrop = FParkourTraceCounts::Capture();
+			FParkourObstacleCourse::PlaceProbeOnTop(Probe, Obstacle, Sample.DropInset, Sample.LateralOffset);
+			Sample.Drop = Probe->EvaluateDropDown();
+			Sample.DropTraces = FParkourTraceCounts::Capture() - TracesBeforeDrop;
+
+			TotalTraces += Sample.GetTraces();
+			TotalSeconds += Sample.GetSeconds();
+			uint64& GeneratorWorst = WorstTracesByGenerator.FindOrAdd(Sample.Generator);
+			GeneratorWorst = FMath::Max(GeneratorWorst, Sample.GetTraces());
+
+			if (Worst.Num() < Keep || GetCost(Sample) > GetCost(Worst.Last()))
+			{
+				Worst.Add(Sample);
+				Worst.Sort([&GetCost](const FParkourFuzzSample& A, const FParkourFuzzSample& B) { return GetCost(A) > GetCost(B); });
+				Worst.SetNum(FMath::Min(Worst.Num(), Keep));
+			}
+		}
+
+		for (AActor* Actor : BatchActors)
+		{
+			Actor->Destroy();
+		}
+	}
+
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogParkourEditor, Display, TEXT("%d layouts from seed %d in %.3f s on the %s scene, %.1f traces and %.2f us per layout."),
+		NumLayouts, Seed, ElapsedSeconds, bAnalytic ? TEXT("analytic") : TEXT("world"),
+		NumLayouts > 0 ? (double)TotalTraces / NumLayouts : 0, NumLayouts > 0 ? TotalSeconds / NumLayouts * 1.e6 : 0);
+	for (const TPair<FString, uint64>& Pair : WorstTracesByGenerator)
+	{
+		UE_LOG(LogParkourEditor, Display, TEXT("%s: at most %llu traces."), *Pair.Key, Pair.Value);
+	}
+
+	FParkourFixtureCatalogue Catalogue;
+	for (const FParkourFuzzSample& Sample : Worst)
+	{
+		UE_LOG(LogParkourEditor, Display, TEXT("%s: %llu traces, %.2f us, %s then %s."), *Sample.Obstacle.Name, Sample.GetTraces(), Sample.GetSeconds() * 1.e6,
+			*FParkourObstacleCourse::GetTagName(Sample.Run.Evaluation.Action), *FParkourObstacleCourse::GetTagName(Sample.Drop.Action));
+		Catalogue.Fixtures.Add(MakeFuzzFixture(Sample));
+	}
+
+	if (Catalogue.SaveToFile(OutputFile) == false)
+	{
+		return 1;
+	}
+
+	UE_LOG(LogParkourEditor, Display, TEXT("Wrote the %d worst layouts to %s."), Catalogue.Fixtures.Num(), *OutputFile);
+	return 0;
+}
@@ -0,0 +1,185 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/ParkourGoldenCommandlet.h"
+#include "Commandlets/ParkourHeadlessWorld.h"
+#include "Commandlets/ParkourFixture.h"
+#include "Collision/ParkourAnalyticScene.h"
+#include "Components/ParkourMovementComponent.h"
+#include "DataAssets/ParkourLedgeDataAsset.h"
+#include "Ledges/ParkourLedgeBaker.h"
+#include "Subsystems/ParkourLedgeSubsystem.h"
+#include "ParkourSystemEditor.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+struct FParkourGoldenScanMode
+{
+	const TCHAR* Name;
+
+	EParkourWallProbeMode WallProbeMode;
+
+	bool bBaked;
+
+	bool bAnalytic;
+
+	bool bSimpleCollision;
+};
+
+/** The first mode is the reference the catalogue is blessed with. */
+static const FParkourGoldenScanMode ParkourGoldenScanModes[] =
+{
+	{ TEXT("World/Grid"), EParkourWallProbeMode::Grid, false, false, false },
+	{ TEXT("World/Hierarchical"), EParkourWallProbeMode::Hierarchical, false, false, false },
+	{ TEXT("World/Baked"), EParkourWallProbeMode::Hierarchical, true, false, false },
+	{ TEXT("World/SimpleCollision"), EParkourWallProbeMode::Hierarchical, false, false, true },
+	{ TEXT("Analytic/Grid"), EParkourWallProbeMode::Grid, false, true, false },
+	{ TEXT("Analytic/Hierarchical"), EParkourWallProbeMode::Hierarchical, false, true, false },
+	{ TEXT("Analytic/SimpleCollision"), EParkourWallProbeMode::Hierarchical, false, true, true },
+};
+
+UParkourGoldenCommandlet::UParkourGoldenCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UParkourGoldenCommandlet::Main(const FString& Params)
+{
+	FString FixturesFile = FPaths::ProjectPluginsDir() / TEXT("ParkourSystem") / TEXT("Fixtures") / TEXT("ParkourGolden.json");
+	FString OutputFile;
+	FParse::Value(*Params, TEXT("Fixtures="), FixturesFile);
+	FParse::Value(*Params, TEXT("Output="), OutputFile);
+	const bool bUpdate = FParse::Param(*Params, TEXT("Update"));
+	const bool bAnalytic = FParse::Param(*Params, TEXT("Analytic"));
+	const bool bNoWorld = FParse::Param(*Params, TEXT("NoWorld")) && bUpdate == false;
+
+	FParkourFixtureCatalogue Catalogue;
+	if (Catalogue.LoadFromFile(FixturesFile) == false)
+	{
+		return 1;
+	}
+
+	TArray<FParkourObstacle> Obstacles;
+	for (const FParkourFixture& Fixture : Catalogue.Fixtures)
+	{
+		Obstacles.Add(Fixture.Obstacle);
+	}
+	FParkourObstacleCourse::LayOut(Obstacles);
+	for (int Index = 0; Index < Obstacles.Num(); Index++)
+	{
+		Catalogue.Fixtures[Index].Obstacle.Origin = Obstacles[Index].Origin;
+	}
+
+	FParkourHeadlessWorld HeadlessWorld;
+	UWorld* World = HeadlessWorld.GetWorld();
+	TArray<AActor*> CourseActors;
+	FParkourAnalyticScene AnalyticScene;
+	AnalyticScene.AddSlab(0);
+	FParkourObstacleCourse::SpawnFloor(World, CourseActors);
+	FBox CourseBounds(ForceInit);
+	for (const FParkourObstacle& Obstacle : Obstacles)
+	{
+		FParkourObstacleCourse::SpawnInWorld(Obstacle, World, CourseActors);
+		FParkourObstacleCourse::AddToScene(Obstacle, AnalyticScene);
+		CourseBounds += Obstacle.GetBounds();
+	}
+	HeadlessWorld.Tick();
+
+	// Bake the whole course with the probe standing room in front of it, so the baked mode covers every pose.
+	const FBox BakedBounds = CourseBounds.ExpandBy(FVector(400, 400, 100));
+	TArray<FParkourLedge> BakedLedges;
+	FParkourLedgeBaker(World, FParkourLedgeBakeSettings()).BakeRegion(BakedBounds, BakedLedges);
+	UParkourLedgeDataAsset* LedgeData = NewObject<UParkourLedgeDataAsset>(GetTransientPackage());
+	LedgeData->Chunk.Pack(BakedBounds, BakedLedges);
+	if (UParkourLedgeSubsystem* LedgeSubsystem = World->GetSubsystem<UParkourLedgeSubsystem>())
+	{
+		LedgeSubsystem->RegisterLedgeData(LedgeData);
+	}
+
+	UParkourMovementComponent* Probe = HeadlessWorld.SpawnProbe(FVector(0, 0, 200), FRotator::ZeroRotator);
+	if (Probe == nullptr)
+	{
+		UE_LOG(LogParkourEditor, Error, TEXT("Could not spawn the parkour probe character."));
+		return 1;
+	}
+
+	int NumDifferences = 0;
+	TArray<TSharedPtr<FJsonValue>> ResultValues;
+	for (const FParkourGoldenScanMode& ScanMode : ParkourGoldenScanModes)
+	{
+		if ((ScanMode.bAnalytic && bAnalytic == false) || (ScanMode.bAnalytic == false && bNoWorld))
+		{
+			continue;
+		}
+
+		Probe->SetCollisionScene(ScanMode.bAnalytic ? &AnalyticScene : nullptr);
+		Probe->SetWallProbeMode(ScanMode.WallProbeMode);
+		Probe->SetUseBakedLedges(ScanMode.bBaked);
+		Probe->SetUseSimpleCollisionLedges(ScanMode.bSimpleCollision);
+		const bool bReference = &ScanMode == &ParkourGoldenScanModes[0];
+
+		int NumPassed = 0;
+		for (FParkourFixture& Fixture : Catalogue.Fixtures)
+		{
+			FParkourObstacleCourse::PlaceProbe(Probe, Fixture.Obstacle, Fixture.Distance, Fixture.LateralOffset, Fixture.Speed);
+			const FParkourScanEvaluation Evaluation = Probe->EvaluateWallScan(false);
+			if (bReference && bUpdate)
+			{
+				Fixture.Bless(Evaluation);
+			}
+
+			TArray<FString> Differences;
+			Fixture.Compare(Evaluation, (ScanMode.bBaked || ScanMode.bSimpleCollision) ? Catalogue.BakedTolerance : Catalogue.Tolerance, Differences);
+			if (Differences.Num() > 0)
+			{
+				NumDifferences += Differences.Num();
+				UE_LOG(LogParkourEditor, Warning, TEXT("%s [%s]: %s"), *Fixture.Name, ScanMode.Name, *FString::Join(Differences, TEXT(", ")));
+			}
+			else
+			{
+				NumPassed++;
+			}
+
+			TSharedPtr<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+			ResultObject->SetStringField(TEXT("fixture"), Fixture.Name);
+			ResultObject->SetStringField(TEXT("mode"), ScanMode.Name);
+			ResultObject->SetStringField(TEXT("action"), FParkourObstacleCourse::GetTagName(Evaluation.Action));
+			ResultObject->SetBoolField(TEXT("baked"), Evaluation.bBaked);
+			ResultObject->SetNumberField(TEXT("queries"), Evaluation.QueriesIssued);
+			TArray<TSharedPtr<FJsonValue>> DifferenceValues;
+			for (const FString& Difference : Differences)
+			{
+				DifferenceValues.Add(MakeShared<FJsonValueString>(Difference));
+			}
+			ResultObject->SetArrayField(TEXT("differences"), DifferenceValues);
+			ResultValues.Add(MakeShared<FJsonValueObject>(ResultObject));
+		}
+
+		UE_LOG(LogParkourEditor, Display, TEXT("%s: %d of %d fixtures match."), ScanMode.Name, NumPassed, Catalogue.Fixtures.Num());
+	}
+
+	if (bUpdate && Catalogue.SaveToFile(FixturesFile))
+	{
+		UE_LOG(LogParkourEditor, Display, TEXT("Blessed %d fixtures in %s."), Catalogue.Fixtures.Num(), *FixturesFile);
+	}
+
+	if (OutputFile.IsEmpty() == false)
+	{
+		TSharedPtr<FJsonObject> ReportObject = MakeShared<FJsonObject>();
+		ReportObject->SetStringField(TEXT("fixtures"), FixturesFile);
+		ReportObject->SetNumberField(TEXT("differences"), NumDifferences);
+		ReportObject->SetArrayField(TEXT("results"), ResultValues);
+
+		FString ReportString;
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ReportString);
+		FJsonSerializer::Serialize(ReportObject.ToSharedRef(), Writer);
+		FFileHelper::SaveStringToFile(ReportString, *OutputFile);
+	}
+
+	return NumDifferences > 0 ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/ParkourHeadlessWorld.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/ParkourMovementComponent.h"
+
+FParkourHeadlessWorld::FParkourHeadlessWorld()
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ParkourHeadlessWorld"));
+	World->AddToRoot();
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+}
+
+FParkourHeadlessWorld::~FParkourHeadlessWorld()
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+}
+
+void FParkourHeadlessWorld::Tick(const float DeltaSeconds)
+{
+	World->Tick(LEVELTICK_All, DeltaSeconds);
+}
+
+UParkourMovementComponent* FParkourHeadlessWorld::SpawnProbe(const FVector& Location, const FRotator& Rotation)
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	ACharacter* Probe = World->SpawnActor<ACharacter>(Location, Rotation, SpawnParameters);
+	if (Probe == nullptr)
+	{
+		return nullptr;
+	}
+	Probe->SetActorEnableCollision(false);
+
+	// Put the mesh root at the feet like a character blueprint does, CheckDistance measures walls from it.
+	Probe->GetMesh()->SetRelativeLocation(FVector(0, 0, -Probe->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()));
+
+	UParkourMovementComponent* ParkourMovement = NewObject<UParkourMovementComponent>(Probe);
+	ParkourMovement->RegisterComponent();
+
+	// Without a camera or arrow actor this reports failure, the references the scans use are set by then.
+	ParkourMovement->SetInitializeReference(Probe, nullptr, nullptr, nullptr);
+	return ParkourMovement;
+}
+
+UParkourMovementComponent* FParkourHeadlessWorld::SpawnRunner(TSubclassOf<ACharacter> CharacterClass, const FVector& Location, const FRotator& Rotation)
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	ACharacter* Runner = World->SpawnActor<ACharacter>(CharacterClass, Location, Rotation, SpawnParameters);
+	if (Runner == nullptr)
+	{
+		return nullptr;
+	}
+
+	// The character blueprint initializes its parkour component in BeginPlay, which ran during the spawn.
+	UParkourMovementComponent* ParkourMovement = Runner->FindComponentByClass<UParkourMovementComponent>();
+	if (ParkourMovement == nullptr)
+	{
+		Runner->Destroy();
+		return nullptr;
+	}
+
+	Runner->GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_Pawn, ECR_Ignore);
+	Runner->GetCharacterMovement()->bRunPhysicsWithNoController = true;
+
+	// Nothing is rendered, the montages still have to move the character.
+	Runner->GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	return ParkourMovement;
+}
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SubclassOf.h"
+
+class UWorld;
+class ACharacter;
+class UParkourMovementComponent;
+
+/** An empty game world for commandlets, torn down again when this goes out of scope. */
+class FParkourHeadlessWorld
+{
+public:
+
+	FParkourHeadlessWorld();
+
+	~FParkourHeadlessWorld();
+
+	UWorld* GetWorld() const { return World; }
+
+	/** Ticks the world once, which also makes newly spawned collision visible to queries. */
+	void Tick(const float DeltaSeconds = 1.f / 60.f);
+
+	/**
+	 * Spawns a bare character carrying a parkour component set up the way the player character sets up its own.
+	 * The probe has no collision of its own, so any number of them can stand in the same spot.
+	 */
+	UParkourMovementComponent* SpawnProbe(const FVector& Location, const FRotator& Rotation);
+
+	/**
+	 * Spawns a character of CharacterClass that moves, collides and animates like a player character without
+	 * a controller. Other pawns do not block it, so runners can share a lane. Null when the class has no
+	 * parkour component.
+	 */
+	UParkourMovementComponent* SpawnRunner(TSubclassOf<ACharacter> CharacterClass, const FVector& Location, const FRotator& Rotation);
+
+private:
+
+	UWorld* World = nullptr;
+};
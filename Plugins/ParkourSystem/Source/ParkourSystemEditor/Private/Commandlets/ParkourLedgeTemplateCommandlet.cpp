@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/ParkourLedgeTemplateCommandlet.h"
+#include "Commandlets/ParkourHeadlessWorld.h"
+#include "Ledges/ParkourLedgeBaker.h"
+#include "Ledges/ParkourLedgeTemplateUserData.h"
+#include "ParkourSystemEditor.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "UObject/SavePackage.h"
+
+// The top probes of the wall scan look this far across a top for its far edge.
+static constexpr float ParkourTemplateMaxDepth = 240.0f;
+
+static void BakeMeshLedges(FParkourHeadlessWorld& HeadlessWorld, UStaticMesh* Mesh, const FParkourLedgeBakeSettings& Settings, TArray<FParkourLedge>& OutLedges)
+{
+	UWorld* World = HeadlessWorld.GetWorld();
+	AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(FVector::ZeroVector, FRotator::ZeroRotator);
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	UStaticMeshComponent* MeshComponent = Actor->GetStaticMeshComponent();
+	MeshComponent->SetMobility(EComponentMobility::Movable);
+	MeshComponent->SetStaticMesh(Mesh);
+	MeshComponent->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	HeadlessWorld.Tick();
+
+	// Alone in the world every top edge of the mesh drops into nothing, so each one is baked as a ledge.
+	FParkourLedgeBaker(World, Settings).BakeRegion(Mesh->GetBoundingBox().ExpandBy(Settings.SampleSpacing), OutLedges);
+
+	Actor->Destroy();
+	HeadlessWorld.Tick();
+
+	// What is under and behind a ledge depends on the placement, the wall scan measures it there.
+	for (FParkourLedge& Ledge : OutLedges)
+	{
+		Ledge.WallHeight = 0;
+		Ledge.VaultHeight = 0;
+		Ledge.ClimbStyle = EParkourLedgeClimbStyle::Braced;
+	}
+}
+
+static bool AreLedgesEqual(const TArray<FParkourLedge>& A, const TArray<FParkourLedge>& B)
+{
+	if (A.Num() != B.Num())
+	{
+		return false;
+	}
+
+	for (int32 Index = 0; Index < A.Num(); Index++)
+	{
+		if (A[Index].Start.Equals(B[Index].Start, 0.01) == false
+			|| A[Index].End.Equals(B[Index].End, 0.01) == false
+			|| A[Index].WallNormal.Equals(B[Index].WallNormal, 0.001) == false
+			|| FMath::IsNearlyEqual(A[Index].Depth, B[Index].Depth, 0.01f) == false)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Stores Ledges as the template of Mesh. Returns true when that changed the mesh. */
+static bool UpdateLedgeTemplate(UStaticMesh* Mesh, TArray<FParkourLedge>& Ledges)
+{
+	UParkourLedgeTemplateUserData* Template = Mesh->GetAssetUserData<UParkourLedgeTemplateUserData>();
+	if (Ledges.Num() == 0)
+	{
+		if (Template == nullptr)
+		{
+			return false;
+		}
+
+		Mesh->Modify();
+		Mesh->RemoveUserDataOfClass(UParkourLedgeTemplateUserData::StaticClass());
+		return true;
+	}
+
+	if (Template && AreLedgesEqual(Template->Ledges, Ledges))
+	{
+		return false;
+	}
+
+	Mesh->Modify();
+	if (Template == nullptr)
+	{
+		Template = NewObject<UParkourLedgeTemplateUserData>(Mesh, NAME_None, RF_Public | RF_Transactional);
+		Mesh->AddAssetUserData(Template);
+	}
+	Template->Ledges = MoveTemp(Ledges);
+	return true;
+}
+
+UParkourLedgeTemplateCommandlet::UParkourLedgeTemplateCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UParkourLedgeTemplateCommandlet::Main(const FString& Params)
+{
+	FString ContentPath = TEXT("/Game");
+	FString MeshPath;
+	FParse::Value(*Params, TEXT("Path="), ContentPath);
+	FParse::Value(*Params, TEXT("Mesh="), MeshPath);
+	const bool bDryRun = FParse::Param(*Params, TEXT("DryRun"));
+
+	FParkourLedgeBakeSettings Settings;
+	Settings.MaxDepth = ParkourTemplateMaxDepth;
+	FParse::Value(*Params, TEXT("Spacing="), Settings.SampleSpacing);
+
+	TArray<FSoftObjectPath> MeshPaths;
+	if (MeshPath.IsEmpty() == false)
+	{
+		MeshPaths.Add(FSoftObjectPath(MeshPath));
+	}
+	else
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		AssetRegistry.SearchAllAssets(true);
+
+		FARFilter Filter;
+		Filter.ClassPaths.Add(UStaticMesh::StaticClass()->GetClassPathName());
+		Filter.PackagePaths.Add(FName(*ContentPath));
+		Filter.bRecursivePaths = true;
+
+		TArray<FAssetData> Assets;
+		AssetRegistry.GetAssets(Filter, Assets);
+		for (const FAssetData& Asset : Assets)
+		{
+			MeshPaths.Add(Asset.GetSoftObjectPath());
+		}
+		MeshPaths.Sort([](const FSoftObjectPath& A, const FSoftObjectPath& B) { return A.ToString() < B.ToString(); });
+	}
+
+	FParkourHeadlessWorld HeadlessWorld;
+	const double StartTime = FPlatformTime::Seconds();
+	int NumTemplates = 0;
+	int NumLedges = 0;
+	TArray<UPackage*> ChangedPackages;
+	for (const FSoftObjectPath& Path : MeshPaths)
+	{
+		UStaticMesh* Mesh = Cast<UStaticMesh>(Path.TryLoad());
+		if (Mesh == nullptr)
+		{
+			UE_LOG(LogParkourEditor, Warning, TEXT("Could not load the static mesh %s."), *Path.ToString());
+			continue;
+		}
+
+		TArray<FParkourLedge> Ledges;
+		BakeMeshLedges(HeadlessWorld, Mesh, Settings, Ledges);
+		NumTemplates += (Ledges.Num() > 0) ? 1 : 0;
+		NumLedges += Ledges.Num();
+		UE_LOG(LogParkourEditor, Verbose, TEXT("%s: %d ledges."), *Mesh->GetPathName(), Ledges.Num());
+
+		if (UpdateLedgeTemplate(Mesh, Ledges))
+		{
+			ChangedPackages.AddUnique(Mesh->GetPackage());
+		}
+	}
+
+	UE_LOG(LogParkourEditor, Display, TEXT("%d meshes, %d with ledges, %d ledges in %.3f s. %d packages changed."),
+		MeshPaths.Num(), NumTemplates, NumLedges, FPlatformTime::Seconds() - StartTime, ChangedPackages.Num());
+
+	if (bDryRun)
+	{
+		return 0;
+	}
+
+	int NumFailed = 0;
+	for (UPackage* Package : ChangedPackages)
+	{
+		const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		if (UPackage::SavePackage(Package, nullptr, *Filename, SaveArgs) == false)
+		{
+			UE_LOG(LogParkourEditor, Error, TEXT("Could not save %s."), *Filename);
+			NumFailed++;
+		}
+	}
+	return (NumFailed > 0) ? 1 : 0;
+}
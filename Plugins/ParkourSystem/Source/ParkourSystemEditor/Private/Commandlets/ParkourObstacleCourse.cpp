@@ -0,0 +1,308 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/ParkourObstacleCourse.h"
+#include "Collision/ParkourAnalyticScene.h"
+#include "Components/ParkourMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "Engine/CollisionProfile.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Types/ParkourGameplayTags.h"
+#include "Dom/JsonObject.h"
+
+static constexpr float ParkourFloorHalfExtent = 100000;
+
+static constexpr float ParkourFloorThickness = 20;
+
+FParkourTraceCounts FParkourTraceCounts::Capture()
+{
+	FParkourTraceCounts Counts;
+	for (uint8 Index = 0; Index < (uint8)EParkourTraceCallSite::Count; Index++)
+	{
+		Counts.Traces[Index] = FParkourTraceStats::GetTotalTraces((EParkourTraceCallSite)Index);
+	}
+	return Counts;
+}
+
+FParkourTraceCounts FParkourTraceCounts::operator-(const FParkourTraceCounts& Other) const
+{
+	FParkourTraceCounts Counts;
+	for (uint8 Index = 0; Index < (uint8)EParkourTraceCallSite::Count; Index++)
+	{
+		Counts.Traces[Index] = Traces[Index] - Other.Traces[Index];
+	}
+	return Counts;
+}
+
+uint64 FParkourTraceCounts::GetTotal() const
+{
+	uint64 Total = 0;
+	for (uint8 Index = 0; Index < (uint8)EParkourTraceCallSite::Count; Index++)
+	{
+		Total += Traces[Index];
+	}
+	return Total;
+}
+
+TSharedPtr<FJsonObject> FParkourTraceCounts::ToJson() const
+{
+	TSharedPtr<FJsonObject> TracesObject = MakeShared<FJsonObject>();
+	for (uint8 Index = 0; Index < (uint8)EParkourTraceCallSite::Count; Index++)
+	{
+		TracesObject->SetNumberField(FParkourTraceStats::GetCallSiteName((EParkourTraceCallSite)Index), (double)Traces[Index]);
+	}
+	return TracesObject;
+}
+
+FParkourCycleCounts FParkourCycleCounts::Capture()
+{
+	FParkourCycleCounts Counts;
+	for (uint8 Index = 0; Index < (uint8)EParkourCycleStat::Count; Index++)
+	{
+		Counts.Cycles[Index] = FParkourCycleStats::GetTotalCycles((EParkourCycleStat)Index);
+		Counts.Calls[Index] = FParkourCycleStats::GetTotalCalls((EParkourCycleStat)Index);
+	}
+	return Counts;
+}
+
+FParkourCycleCounts FParkourCycleCounts::operator-(const FParkourCycleCounts& Other) const
+{
+	FParkourCycleCounts Counts;
+	for (uint8 Index = 0; Index < (uint8)EParkourCycleStat::Count; Index++)
+	{
+		Counts.Cycles[Index] = Cycles[Index] - Other.Cycles[Index];
+		Counts.Calls[Index] = Calls[Index] - Other.Calls[Index];
+	}
+	return Counts;
+}
+
+TSharedPtr<FJsonObject> FParkourCycleCounts::ToJson(const int Frames) const
+{
+	TSharedPtr<FJsonObject> CyclesObject = MakeShared<FJsonObject>();
+	for (uint8 Index = 0; Index < (uint8)EParkourCycleStat::Count; Index++)
+	{
+		const double Microseconds = FPlatformTime::ToMilliseconds64(Cycles[Index]) * 1000;
+		TSharedPtr<FJsonObject> CounterObject = MakeShared<FJsonObject>();
+		CounterObject->SetNumberField(TEXT("calls"), (double)Calls[Index]);
+		CounterObject->SetNumberField(TEXT("totalUs"), Microseconds);
+		CounterObject->SetNumberField(TEXT("perCallUs"), Calls[Index] > 0 ? Microseconds / Calls[Index] : 0);
+		CounterObject->SetNumberField(TEXT("perFrameUs"), Frames > 0 ? Microseconds / Frames : 0);
+		CyclesObject->SetObjectField(FParkourCycleStats::GetStatName((EParkourCycleStat)Index), CounterObject);
+	}
+	return CyclesObject;
+}
+
+FBox FParkourObstacle::GetBounds() const
+{
+	FBox Bounds(ForceInit);
+	const FTransform Transform = GetTransform();
+	for (const FParkourObstacleBox& Box : Boxes)
+	{
+		const FTransform BoxTransform(FRotator(Box.Pitch, Box.Yaw, 0), Box.Center);
+		Bounds += FBox(-Box.HalfSize, Box.HalfSize).TransformBy(BoxTransform * Transform);
+	}
+	return Bounds;
+}
+
+FParkourObstacle FParkourObstacleCourse::MakeWall(const float Height, const float Depth, const float Drop, const float HalfWidth)
+{
+	FParkourObstacle Obstacle;
+	Obstacle.Kind = TEXT("Wall");
+	Obstacle.Name = FString::Printf(TEXT("Wall_H%d_D%d_V%d"), FMath::RoundToInt(Height), FMath::RoundToInt(Depth), FMath::RoundToInt(Drop));
+	Obstacle.WallHeight = Height;
+	Obstacle.Depth = Depth;
+	Obstacle.Drop = FMath::Min(Drop, Height);
+	Obstacle.HalfWidth = HalfWidth;
+
+	FParkourObstacleBox& Block = Obstacle.Boxes.AddDefaulted_GetRef();
+	Block.Center = FVector(Depth * 0.5f, 0, Height * 0.5f);
+	Block.HalfSize = FVector(Depth * 0.5f, HalfWidth, Height * 0.5f);
+
+	if (Obstacle.Drop < Height)
+	{
+		const float LandingHeight = Height - Obstacle.Drop;
+		FParkourObstacleBox& Landing = Obstacle.Boxes.AddDefaulted_GetRef();
+		Landing.Center = FVector(Depth + 150, 0, LandingHeight * 0.5f);
+		Landing.HalfSize = FVector(150, HalfWidth, LandingHeight * 0.5f);
+	}
+	return Obstacle;
+}
+
+FParkourObstacle FParkourObstacleCourse::MakeBracedLedge(const float Height, const float HalfWidth)
+{
+	FParkourObstacle Obstacle = MakeWall(Height, 150, Height, HalfWidth);
+	Obstacle.Kind = TEXT("BracedLedge");
+	Obstacle.Name = FString::Printf(TEXT("BracedLedge_H%d"), FMath::RoundToInt(Height));
+	return Obstacle;
+}
+
+FParkourObstacle FParkourObstacleCourse::MakeFreeHangLedge(const float Height, const float HalfWidth)
+{
+	FParkourObstacle Obstacle;
+	Obstacle.Kind = TEXT("FreeHangLedge");
+	Obstacle.Name = FString::Printf(TEXT("FreeHangLedge_H%d"), FMath::RoundToInt(Height));
+	Obstacle.WallHeight = Height;
+	Obstacle.Depth = 150;
+	Obstacle.Drop = Height;
+	Obstacle.HalfWidth = HalfWidth;
+
+	// CheckClimbStyle looks for the wall 125 cm under the lip, the recess keeps it out of reach.
+	const float LipThickness = 30;
+	FParkourObstacleBox& Lip = Obstacle.Boxes.AddDefaulted_GetRef();
+	Lip.Center = FVector(75, 0, Height - (LipThickness * 0.5f));
+	Lip.HalfSize = FVector(75, HalfWidth, LipThickness * 0.5f);
+
+	const float RecessDepth = 80;
+	FParkourObstacleBox& Recess = Obstacle.Boxes.AddDefaulted_GetRef();
+	Recess.Center = FVector(RecessDepth + 35, 0, (Height - LipThickness) * 0.5f);
+	Recess.HalfSize = FVector(35, HalfWidth, (Height - LipThickness) * 0.5f);
+	return Obstacle;
+}
+
+void FParkourObstacleCourse::GenerateBenchmarkCourse(TArray<FParkourObstacle>& OutObstacles)
+{
+	// One height inside each band of ParkourType: none, low mantle, vault, high vault, climb, none.
+	const float Heights[] = { 30, 70, 105, 140, 200, 300 };
+	const float Depths[] = { 20, 80, 200 };
+
+	for (const float Height : Heights)
+	{
+		for (const float Depth : Depths)
+		{
+			OutObstacles.Add(MakeWall(Height, Depth, Height));
+			OutObstacles.Add(MakeWall(Height, Depth, 40));
+		}
+	}
+
+	for (const float Height : { 180.f, 240.f })
+	{
+		OutObstacles.Add(MakeBracedLedge(Height));
+		OutObstacles.Add(MakeFreeHangLedge(Height));
+	}
+
+	LayOut(OutObstacles);
+}
+
+void FParkourObstacleCourse::LayOut(TArray<FParkourObstacle>& Obstacles, const float Spacing)
+{
+	for (int Index = 0; Index < Obstacles.Num(); Index++)
+	{
+		Obstacles[Index].Origin = FVector(0, Index * Spacing, 0);
+	}
+}
+
+void FParkourObstacleCourse::AddToScene(const FParkourObstacle& Obstacle, FParkourAnalyticScene& Scene)
+{
+	const FTransform Transform = Obstacle.GetTransform();
+	for (const FParkourObstacleBox& Box : Obstacle.Boxes)
+	{
+		Scene.AddBox(Transform.TransformPosition(Box.Center), Box.HalfSize, Obstacle.GetBoxRotation(Box));
+	}
+}
+
+static AActor* SpawnParkourBox(UWorld* World, const FVector& Center, const FVector& HalfSize, const FRotator& Rotation)
+{
+	static UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+
+	AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(Center, Rotation);
+	if (Actor && CubeMesh)
+	{
+		UStaticMeshComponent* MeshComponent = Actor->GetStaticMeshComponent();
+		MeshComponent->SetMobility(EComponentMobility::Movable);
+		MeshComponent->SetStaticMesh(CubeMesh);
+		MeshComponent->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+
+		// The engine cube is 100 cm across and centred on its pivot.
+		Actor->SetActorScale3D(HalfSize / 50);
+	}
+	return Actor;
+}
+
+void FParkourObstacleCourse::SpawnInWorld(const FParkourObstacle& Obstacle, UWorld* World, TArray<AActor*>& OutActors)
+{
+	const FTransform Transform = Obstacle.GetTransform();
+	for (const FParkourObstacleBox& Box : Obstacle.Boxes)
+	{
+		if (AActor* Actor = SpawnParkourBox(World, Transform.TransformPosition(Box.Center), Box.HalfSize, Obstacle.GetBoxRotation(Box)))
+		{
+			OutActors.Add(Actor);
+		}
+	}
+}
+
+void FParkourObstacleCourse::SpawnFloor(UWorld* World, TArray<AActor*>& OutActors)
+{
+	const FVector HalfSize(ParkourFloorHalfExtent, ParkourFloorHalfExtent, ParkourFloorThickness * 0.5f);
+	if (AActor* Actor = SpawnParkourBox(World, FVector(0, 0, -HalfSize.Z), HalfSize, FRotator::ZeroRotator))
+	{
+		OutActors.Add(Actor);
+	}
+}
+
+void FParkourObstacleCourse::PlaceProbe(UParkourMovementComponent* Probe, const FParkourObstacle& Obstacle, const float Distance, const float LateralOffset, const float Speed)
+{
+	ACharacter* Character = Cast<ACharacter>(Probe->GetOwner());
+	UCapsuleComponent* Capsule = Character ? Character->GetCapsuleComponent() : nullptr;
+	UCharacterMovementComponent* CharacterMovement = Character ? Character->GetCharacterMovement() : nullptr;
+	if (Capsule == nullptr || CharacterMovement == nullptr)
+	{
+		return;
+	}
+
+	const FTransform Transform = Obstacle.GetTransform();
+	const FVector Forward = Transform.GetUnitAxis(EAxis::X);
+	const FVector Location = Transform.TransformPosition(FVector(-(Distance + Capsule->GetScaledCapsuleRadius()), LateralOffset, Capsule->GetScaledCapsuleHalfHeight() + 2));
+	Character->SetActorLocationAndRotation(Location, Forward.Rotation());
+	CharacterMovement->Velocity = Forward * Speed;
+}
+
+void FParkourObstacleCourse::PlaceProbeOnTop(UParkourMovementComponent* Probe, const FParkourObstacle& Obstacle, const float Inset, const float LateralOffset)
+{
+	ACharacter* Character = Cast<ACharacter>(Probe->GetOwner());
+	UCapsuleComponent* Capsule = Character ? Character->GetCapsuleComponent() : nullptr;
+	UCharacterMovementComponent* CharacterMovement = Character ? Character->GetCharacterMovement() : nullptr;
+	if (Capsule == nullptr || CharacterMovement == nullptr)
+	{
+		return;
+	}
+
+	const FTransform Transform = Obstacle.GetTransform();
+	const FVector Outward = -Transform.GetUnitAxis(EAxis::X);
+	const FVector Location = Transform.TransformPosition(FVector(Inset, LateralOffset, Obstacle.WallHeight + Capsule->GetScaledCapsuleHalfHeight() + 2));
+	Character->SetActorLocationAndRotation(Location, Outward.Rotation());
+	CharacterMovement->Velocity = FVector::ZeroVector;
+}
+
+FParkourObstacleRun FParkourObstacleCourse::Run(UParkourMovementComponent* Probe, const FParkourObstacle& Obstacle, const float LateralOffset, const float Speed, const float Step, const int Repeat)
+{
+	FParkourObstacleRun ObstacleRun;
+	for (float Distance = 250; Distance >= 1; Distance -= FMath::Max(Step, 1.f))
+	{
+		PlaceProbe(Probe, Obstacle, Distance, LateralOffset, Speed);
+		for (int Iteration = 0; Iteration < FMath::Max(Repeat, 1); Iteration++)
+		{
+			ObstacleRun.Evaluation = Probe->EvaluateWallScan(false);
+			ObstacleRun.Scans++;
+			ObstacleRun.WallShapeSeconds += ObstacleRun.Evaluation.WallShapeSeconds;
+			ObstacleRun.DecisionSeconds += ObstacleRun.Evaluation.DecisionSeconds;
+			ObstacleRun.MaxScanSeconds = FMath::Max(ObstacleRun.MaxScanSeconds, ObstacleRun.Evaluation.WallShapeSeconds + ObstacleRun.Evaluation.DecisionSeconds);
+		}
+		ObstacleRun.Distance = Distance;
+
+		if (ObstacleRun.Evaluation.Action.IsValid() && ObstacleRun.Evaluation.Action != ParkourTags::Action_NoAction)
+		{
+			break;
+		}
+	}
+	return ObstacleRun;
+}
+
+FString FParkourObstacleCourse::GetTagName(const FGameplayTag& Tag)
+{
+	return Tag.IsValid() ? Tag.GetTagName().ToString() : TEXT("None");
+}
@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Types/ParkourScanContext.h"
+#include "Stats/ParkourStats.h"
+
+class UWorld;
+class FJsonObject;
+class AActor;
+class UParkourMovementComponent;
+class FParkourAnalyticScene;
+
+/** A box of an obstacle, relative to the obstacle origin, tilted by Pitch and then turned about Z by Yaw. */
+struct FParkourObstacleBox
+{
+	FVector Center = FVector::ZeroVector;
+
+	FVector HalfSize = FVector::ZeroVector;
+
+	float Yaw = 0;
+
+	/** Slants the top of the box, positive raises its +X end. */
+	float Pitch = 0;
+};
+
+/**
+ * One obstacle of a course. Its wall face sits at the origin, runners come from -X of the obstacle
+ * frame and the floor is at the origin height.
+ */
+struct FParkourObstacle
+{
+	FString Name;
+
+	FString Kind;
+
+	FVector Origin = FVector::ZeroVector;
+
+	float Yaw = 0;
+
+	float WallHeight = 0;
+
+	float Depth = 0;
+
+	/** Drop from the top of the obstacle to the ground behind it. */
+	float Drop = 0;
+
+	/** Half of the face width runners can approach along. */
+	float HalfWidth = 0;
+
+	TArray<FParkourObstacleBox> Boxes;
+
+	FTransform GetTransform() const { return FTransform(FRotator(0, Yaw, 0), Origin); }
+
+	/** World rotation of one of the boxes. */
+	FRotator GetBoxRotation(const FParkourObstacleBox& Box) const { return FRotator(Box.Pitch, Yaw + Box.Yaw, 0); }
+
+	/** World bounds of the boxes. */
+	FBox GetBounds() const;
+};
+
+/** How one runner got on at one obstacle. */
+struct FParkourObstacleRun
+{
+	/** Action of the first scan that found one, or the last scan's when none did. */
+	FParkourScanEvaluation Evaluation;
+
+	/** Gap between the capsule and the wall face at that scan. */
+	float Distance = 0;
+
+	int Scans = 0;
+
+	double WallShapeSeconds = 0;
+
+	double DecisionSeconds = 0;
+
+	double MaxScanSeconds = 0;
+};
+
+/** Traces per call site, summed over every parkour component. */
+struct FParkourTraceCounts
+{
+	/** The totals counted so far, subtract an earlier capture for the traces in between. */
+	static FParkourTraceCounts Capture();
+
+	FParkourTraceCounts operator-(const FParkourTraceCounts& Other) const;
+
+	uint64 GetTotal() const;
+
+	/** One field per call site, named like the parkour.stats output. */
+	TSharedPtr<FJsonObject> ToJson() const;
+
+	uint64 Traces[(uint8)EParkourTraceCallSite::Count] = {};
+};
+
+/** Calls and cycles per STATGROUP_Parkour cycle counter, summed over every parkour component. */
+struct FParkourCycleCounts
+{
+	/** The totals counted so far, subtract an earlier capture for the time in between. */
+	static FParkourCycleCounts Capture();
+
+	FParkourCycleCounts operator-(const FParkourCycleCounts& Other) const;
+
+	/** One object per counter with its calls, total time, time per call and time per frame over Frames. */
+	TSharedPtr<FJsonObject> ToJson(const int Frames) const;
+
+	uint64 Cycles[(uint8)EParkourCycleStat::Count] = {};
+
+	uint64 Calls[(uint8)EParkourCycleStat::Count] = {};
+};
+
+/** Procedural obstacle layouts shared by the parkour commandlets. */
+class FParkourObstacleCourse
+{
+public:
+
+	/** A solid block, with a landing platform behind it when Drop is less than Height. */
+	static FParkourObstacle MakeWall(const float Height, const float Depth, const float Drop, const float HalfWidth = 200);
+
+	/** A tall wall with a solid face under the lip, climbed braced. */
+	static FParkourObstacle MakeBracedLedge(const float Height, const float HalfWidth = 200);
+
+	/** A lip overhanging a recessed wall, leaving nothing for the feet, climbed free hanging. */
+	static FParkourObstacle MakeFreeHangLedge(const float Height, const float HalfWidth = 200);
+
+	/** Walls in every height band ParkourType tells apart, at several depths and drops, and both climb styles. */
+	static void GenerateBenchmarkCourse(TArray<FParkourObstacle>& OutObstacles);
+
+	/** Places the obstacles side by side along Y, far enough apart that no scan reaches the next one. */
+	static void LayOut(TArray<FParkourObstacle>& Obstacles, const float Spacing = 1000);
+
+	static void AddToScene(const FParkourObstacle& Obstacle, FParkourAnalyticScene& Scene);
+
+	static void SpawnInWorld(const FParkourObstacle& Obstacle, UWorld* World, TArray<AActor*>& OutActors);
+
+	/** A floor under every obstacle, top at Z 0. */
+	static void SpawnFloor(UWorld* World, TArray<AActor*>& OutActors);
+
+	/** Stands the probe on the floor Distance cm in front of the obstacle face, facing it and moving at Speed. */
+	static void PlaceProbe(UParkourMovementComponent* Probe, const FParkourObstacle& Obstacle, const float Distance, const float LateralOffset, const float Speed);
+
+	/** Stands the probe on top of the obstacle Inset cm behind the face, at rest and facing out over the edge. */
+	static void PlaceProbeOnTop(UParkourMovementComponent* Probe, const FParkourObstacle& Obstacle, const float Inset, const float LateralOffset);
+
+	/**
+	 * Walks a probe up to the obstacle face along LateralOffset, pressing parkour every Step cm until a scan
+	 * picks an action. Each scan position is evaluated Repeat times for the timings.
+	 */
+	static FParkourObstacleRun Run(UParkourMovementComponent* Probe, const FParkourObstacle& Obstacle, const float LateralOffset, const float Speed, const float Step = 20, const int Repeat = 1);
+
+	static FString GetTagName(const FGameplayTag& Tag);
+};
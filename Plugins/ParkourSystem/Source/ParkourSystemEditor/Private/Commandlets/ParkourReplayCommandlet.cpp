@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/ParkourReplayCommandlet.h"
+#include "Commandlets/ParkourHeadlessWorld.h"
+#include "Components/ParkourMovementComponent.h"
+#include "Replay/ParkourTraceRecording.h"
+#include "ParkourSystemEditor.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+
+UParkourReplayCommandlet::UParkourReplayCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UParkourReplayCommandlet::Main(const FString& Params)
+{
+	FString RecordingFile;
+	if (FParse::Value(*Params, TEXT("Recording="), RecordingFile) == false)
+	{
+		UE_LOG(LogParkourEditor, Error, TEXT("Usage: -run=ParkourReplay -Recording=<file> [-Iterations=10] [-Output=<json file>]"));
+		return 1;
+	}
+
+	int32 Iterations = 10;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	Iterations = FMath::Max(Iterations, 1);
+
+	FString OutputFile;
+	FParse::Value(*Params, TEXT("Output="), OutputFile);
+
+	FParkourTraceRecording Recording;
+	if (Recording.LoadFromFile(RecordingFile) == false)
+	{
+		return 1;
+	}
+
+	// Recorded results answer every query, the world only has to host the probe character.
+	FParkourHeadlessWorld HeadlessWorld;
+	UParkourMovementComponent* Probe = HeadlessWorld.SpawnProbe(FVector::ZeroVector, FRotator::ZeroRotator);
+	if (Probe == nullptr)
+	{
+		UE_LOG(LogParkourEditor, Error, TEXT("Could not spawn the parkour probe character."));
+		return 1;
+	}
+
+	int NumReplayed = 0;
+	int NumBaked = 0;
+	int NumAsync = 0;
+	int NumMismatches = 0;
+	int NumUnmatchedQueries = 0;
+	int64 NumQueries = 0;
+	TArray<double> ScanTimes;
+	TArray<TSharedPtr<FJsonValue>> MismatchValues;
+
+	for (const FParkourRecordedScan& Scan : Recording.Scans)
+	{
+		if (Scan.Snapshot.bBaked)
+		{
+			NumBaked++;
+			continue;
+		}
+
+		int UnmatchedQueries = 0;
+		FGameplayTag Action;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			Action = Probe->ReplayRecordedScan(Scan, UnmatchedQueries);
+		}
+		ScanTimes.Add((FPlatformTime::Seconds() - StartTime) / Iterations);
+
+		int QueriesIssued = 0;
+		int QueriesSaved = 0;
+		Probe->GetLastScanQueryCounts(QueriesIssued, QueriesSaved);
+
+		NumReplayed++;
+		NumQueries += QueriesIssued;
+		NumUnmatchedQueries += UnmatchedQueries;
+		if (Scan.Snapshot.bAsync)
+		{
+			NumAsync++;
+		}
+
+		if (Action.GetTagName() != Scan.Action)
+		{
+			NumMismatches++;
+			UE_LOG(LogParkourEditor, Warning, TEXT("Frame %llu at %s: recorded %s, replayed %s (%d unmatched queries)."),
+				Scan.Snapshot.Frame, *Scan.Snapshot.ActorLocation.ToString(), *Scan.Action.ToString(), *Action.GetTagName().ToString(), UnmatchedQueries);
+
+			TSharedPtr<FJsonObject> MismatchObject = MakeShared<FJsonObject>();
+			MismatchObject->SetNumberField(TEXT("frame"), (double)Scan.Snapshot.Frame);
+			MismatchObject->SetStringField(TEXT("location"), Scan.Snapshot.ActorLocation.ToString());
+			MismatchObject->SetStringField(TEXT("recorded"), Scan.Action.ToString());
+			MismatchObject->SetStringField(TEXT("replayed"), Action.GetTagName().ToString());
+			MismatchObject->SetNumberField(TEXT("unmatchedQueries"), UnmatchedQueries);
+			MismatchValues.Add(MakeShared<FJsonValueObject>(MismatchObject));
+		}
+	}
+
+	ScanTimes.Sort();
+	double TotalTime = 0;
+	for (const double ScanTime : ScanTimes)
+	{
+		TotalTime += ScanTime;
+	}
+	const double MeanMicroseconds = ScanTimes.Num() > 0 ? TotalTime / ScanTimes.Num() * 1.e6 : 0;
+	const double MedianMicroseconds = ScanTimes.Num() > 0 ? ScanTimes[ScanTimes.Num() / 2] * 1.e6 : 0;
+	const double P95Microseconds = ScanTimes.Num() > 0 ? ScanTimes[FMath::Min(ScanTimes.Num() * 95 / 100, ScanTimes.Num() - 1)] * 1.e6 : 0;
+	const double MaxMicroseconds = ScanTimes.Num() > 0 ? ScanTimes.Last() * 1.e6 : 0;
+
+	UE_LOG(LogParkourEditor, Display, TEXT("Replayed %d scans x %d iterations (%d baked skipped, %d recorded async, %d unfinished, %d queries outside scans)."),
+		NumReplayed, Iterations, NumBaked, NumAsync, Recording.NumUnfinishedScans, Recording.NumOtherQueries);
+	UE_LOG(LogParkourEditor, Display, TEXT("Scan time us: mean %.2f, median %.2f, p95 %.2f, max %.2f. Queries per scan: %.1f."),
+		MeanMicroseconds, MedianMicroseconds, P95Microseconds, MaxMicroseconds, NumReplayed > 0 ? (double)NumQueries / NumReplayed : 0.0);
+	UE_LOG(LogParkourEditor, Display, TEXT("%d action mismatches, %d queries without a recorded result."), NumMismatches, NumUnmatchedQueries);
+
+	if (OutputFile.IsEmpty() == false)
+	{
+		TSharedPtr<FJsonObject> ReportObject = MakeShared<FJsonObject>();
+		ReportObject->SetStringField(TEXT("recording"), RecordingFile);
+		ReportObject->SetNumberField(TEXT("iterations"), Iterations);
+		ReportObject->SetNumberField(TEXT("scans"), NumReplayed);
+		ReportObject->SetNumberField(TEXT("bakedScans"), NumBaked);
+		ReportObject->SetNumberField(TEXT("asyncScans"), NumAsync);
+		ReportObject->SetNumberField(TEXT("unfinishedScans"), Recording.NumUnfinishedScans);
+		ReportObject->SetNumberField(TEXT("otherQueries"), Recording.NumOtherQueries);
+		ReportObject->SetNumberField(TEXT("queries"), (double)NumQueries);
+		ReportObject->SetNumberField(TEXT("unmatchedQueries"), NumUnmatchedQueries);
+		ReportObject->SetNumberField(TEXT("meanUs"), MeanMicroseconds);
+		ReportObject->SetNumberField(TEXT("medianUs"), MedianMicroseconds);
+		ReportObject->SetNumberField(TEXT("p95Us"), P95Microseconds);
+		ReportObject->SetNumberField(TEXT("maxUs"), MaxMicroseconds);
+		ReportObject->SetArrayField(TEXT("mismatches"), MismatchValues);
+
+		FString ReportString;
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ReportString);
+		FJsonSerializer::Serialize(ReportObject.ToSharedRef(), Writer);
+		if (FFileHelper::SaveStringToFile(ReportString, *OutputFile) == false)
+		{
+			UE_LOG(LogParkourEditor, Error, TEXT("Could not write %s."), *OutputFile);
+			return 1;
+		}
+	}
+
+	return NumMismatches > 0 ? 1 : 0;
+}
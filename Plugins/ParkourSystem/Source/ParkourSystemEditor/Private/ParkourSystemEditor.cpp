@@ -0,0 +1,7 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ParkourSystemEditor.h"
+
+DEFINE_LOG_CATEGORY(LogParkourEditor);
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, ParkourSystemEditor)
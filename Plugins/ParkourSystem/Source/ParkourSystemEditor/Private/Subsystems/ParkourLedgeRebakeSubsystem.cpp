@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/ParkourLedgeRebakeSubsystem.h"
+#include "Actors/ParkourLedgeCell.h"
+#include "Actors/ParkourLedgeVolume.h"
+#include "Components/ParkourDynamicLedgeComponent.h"
+#include "ParkourSystemEditor.h"
+#include "Components/PrimitiveComponent.h"
+#include "DrawDebugHelpers.h"
+#include "Editor.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+
+static TAutoConsoleVariable<int32> CVarParkourLedgeAutoRebake(
+	TEXT("parkour.LedgeAutoRebake"),
+	1,
+	TEXT("Bake stale ledge regions again after the level is edited. 0: off, they stay stale and are traced at runtime, 1: on."));
+
+static TAutoConsoleVariable<int32> CVarParkourShowStaleLedges(
+	TEXT("parkour.ShowStaleLedges"),
+	0,
+	TEXT("Draw the baked ledge regions in the editor world that are waiting for a rebake."));
+
+// Seconds without another change before the stale regions are baked, so a burst of edits is baked once.
+static constexpr double ParkourLedgeRebakeDelay = 0.5;
+
+/** The actor whose collision changes when Object does, or nullptr when that cannot affect a bake. */
+static AActor* GetBakedActor(UObject* Object)
+{
+	AActor* Actor = Cast<AActor>(Object);
+	if (Actor == nullptr)
+	{
+		if (const UActorComponent* Component = Cast<UActorComponent>(Object))
+		{
+			Actor = Component->GetOwner();
+		}
+	}
+
+	if (Actor == nullptr || Actor->IsTemplate())
+	{
+		return nullptr;
+	}
+
+	// Only static level geometry is baked, never what a bake produces, the characters that climb it or moving geometry.
+	if (Actor->IsA<AParkourLedgeCell>() || Actor->IsA<AParkourLedgeVolume>() || Actor->IsA<APawn>() || Actor->FindComponentByClass<UParkourDynamicLedgeComponent>())
+	{
+		return nullptr;
+	}
+
+	const UWorld* World = Actor->GetWorld();
+	if (World == nullptr || World->WorldType != EWorldType::Editor)
+	{
+		return nullptr;
+	}
+	return Actor;
+}
+
+/** Bounds of the components the bake traces can hit. */
+static FBox GetCollisionBounds(const AActor* Actor)
+{
+	FBox Bounds(ForceInit);
+	Actor->ForEachComponent<UPrimitiveComponent>(false, [&Bounds](const UPrimitiveComponent* Primitive)
+	{
+		if (Primitive->IsRegistered() && Primitive->IsCollisionEnabled() && Primitive->GetCollisionResponseToChannel(ECC_Visibility) == ECR_Block)
+		{
+			Bounds += Primitive->Bounds.GetBox();
+		}
+	});
+	return Bounds;
+}
+
+void UParkourLedgeRebakeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FCoreUObjectDelegates::OnObjectModified.AddUObject(this, &UParkourLedgeRebakeSubsystem::OnObjectModified);
+	FCoreUObjectDelegates::OnPreObjectPropertyChanged.AddUObject(this, &UParkourLedgeRebakeSubsystem::OnPreObjectPropertyChanged);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &UParkourLedgeRebakeSubsystem::OnObjectPropertyChanged);
+	if (GEngine)
+	{
+		GEngine->OnActorMoved().AddUObject(this, &UParkourLedgeRebakeSubsystem::OnActorMoved);
+		GEngine->OnLevelActorAdded().AddUObject(this, &UParkourLedgeRebakeSubsystem::OnActorAddedOrDeleted);
+		GEngine->OnLevelActorDeleted().AddUObject(this, &UParkourLedgeRebakeSubsystem::OnActorAddedOrDeleted);
+	}
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UParkourLedgeRebakeSubsystem::Tick));
+}
+
+void UParkourLedgeRebakeSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	FCoreUObjectDelegates::OnObjectModified.RemoveAll(this);
+	FCoreUObjectDelegates::OnPreObjectPropertyChanged.RemoveAll(this);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+	if (GEngine)
+	{
+		GEngine->OnActorMoved().RemoveAll(this);
+		GEngine->OnLevelActorAdded().RemoveAll(this);
+		GEngine->OnLevelActorDeleted().RemoveAll(this);
+	}
+
+	Super::Deinitialize();
+}
+
+void UParkourLedgeRebakeSubsystem::OnObjectModified(UObject* Object)
+{
+	CaptureBounds(Object);
+}
+
+void UParkourLedgeRebakeSubsystem::OnPreObjectPropertyChanged(UObject* Object, const FEditPropertyChain& PropertyChain)
+{
+	CaptureBounds(Object);
+}
+
+void UParkourLedgeRebakeSubsystem::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// Dragging a slider or a gizmo reports every step, the final value follows with another change.
+	if (PropertyChangedEvent.ChangeType != EPropertyChangeType::Interactive)
+	{
+		MarkChanged(Object);
+	}
+}
+
+void UParkourLedgeRebakeSubsystem::OnActorMoved(AActor* Actor)
+{
+	MarkChanged(Actor);
+}
+
+void UParkourLedgeRebakeSubsystem::OnActorAddedOrDeleted(AActor* Actor)
+{
+	if (GetBakedActor(Actor))
+	{
+		MarkDirty(Actor->GetWorld(), GetCollisionBounds(Actor));
+	}
+}
+
+void UParkourLedgeRebakeSubsystem::CaptureBounds(UObject* Object)
+{
+	if (AActor* Actor = GetBakedActor(Object))
+	{
+		if (KnownBounds.Contains(Actor) == false)
+		{
+			KnownBounds.Add(Actor, GetCollisionBounds(Actor));
+		}
+	}
+}
+
+void UParkourLedgeRebakeSubsystem::MarkChanged(UObject* Object)
+{
+	AActor* Actor = GetBakedActor(Object);
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	const FBox Bounds = GetCollisionBounds(Actor);
+	FBox& KnownActorBounds = KnownBounds.FindOrAdd(Actor, FBox(ForceInit));
+	const FBox ChangedBounds = KnownActorBounds + Bounds;
+	KnownActorBounds = Bounds;
+
+	// Where the collision was, ledges may be gone, where it is now, new ones may be.
+	MarkDirty(Actor->GetWorld(), ChangedBounds);
+}
+
+void UParkourLedgeRebakeSubsystem::MarkDirty(UWorld* World, const FBox& Bounds)
+{
+	if (Bounds.IsValid == false)
+	{
+		return;
+	}
+
+	for (TActorIterator<AParkourLedgeVolume> It(World); It; ++It)
+	{
+		if (It->MarkLedgesStale(Bounds))
+		{
+			bHasStaleLedges = true;
+			LastChangeTime = FPlatformTime::Seconds();
+		}
+	}
+}
+
+bool UParkourLedgeRebakeSubsystem::Tick(float DeltaTime)
+{
+	UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+	if (World == nullptr)
+	{
+		return true;
+	}
+
+	if (CVarParkourShowStaleLedges.GetValueOnGameThread() > 0)
+	{
+		TArray<FBox> StaleRegions;
+		for (TActorIterator<AParkourLedgeVolume> It(World); It; ++It)
+		{
+			It->GetStaleRegions(StaleRegions);
+		}
+		for (const FBox& StaleRegion : StaleRegions)
+		{
+			DrawDebugBox(World, StaleRegion.GetCenter(), StaleRegion.GetExtent(), FColor::Red, false, -1.0f, SDPG_World, 2.0f);
+		}
+	}
+
+	// The play world is a copy of the editor world, a rebake there would only stall the session.
+	if (bHasStaleLedges == false || CVarParkourLedgeAutoRebake.GetValueOnGameThread() == 0 || GEditor->PlayWorld
+		|| FPlatformTime::Seconds() - LastChangeTime < ParkourLedgeRebakeDelay)
+	{
+		return true;
+	}
+
+	bHasStaleLedges = false;
+	FParkourLedgeBakeStats Stats;
+	for (TActorIterator<AParkourLedgeVolume> It(World); It; ++It)
+	{
+		It->RebakeStaleLedges(Stats);
+	}
+	UE_LOG(LogParkourEditor, Log, TEXT("Rebaked %d stale ledge tiles into %d ledges in %.3f s."), Stats.NumTiles, Stats.NumLedges, Stats.Seconds);
+
+	for (auto It = KnownBounds.CreateIterator(); It; ++It)
+	{
+		if (It->Key.IsValid() == false)
+		{
+			It.RemoveCurrent();
+		}
+	}
+	return true;
+}
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Collision/ParkourAnalyticScene.h"
+#include "Commandlets/ParkourHeadlessWorld.h"
+#include "Commandlets/ParkourObstacleCourse.h"
+#include "Components/ParkourMovementComponent.h"
+#include "Types/ParkourGameplayTags.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourAnalyticSceneSweepTest, "ParkourSystem.AnalyticScene.Sweep", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FParkourAnalyticSceneSweepTest::RunTest(const FString& Parameters)
+{
+	// A wall 105 cm high and 80 cm deep, its face on X = 0.
+	FParkourAnalyticScene Scene;
+	Scene.AddSlab(0);
+	FParkourObstacleCourse::AddToScene(FParkourObstacleCourse::MakeWall(105, 80, 105), Scene);
+
+	FHitResult Hit;
+	TestTrue(TEXT("Sphere towards the wall hits"), Scene.Sweep(EParkourTraceShape::Sphere, FVector(-100, 0, 50), FVector(100, 0, 50), FVector(10), FQuat::Identity, Hit));
+	TestFalse(TEXT("Sphere towards the wall starts clear"), Hit.bStartPenetrating);
+	TestEqual(TEXT("Sphere stops a radius short of the face"), Hit.Location, FVector(-10, 0, 50));
+	TestEqual(TEXT("Sphere touches the face"), Hit.ImpactPoint, FVector(0, 0, 50));
+	TestEqual(TEXT("Face normal"), Hit.ImpactNormal, FVector(-1, 0, 0));
+
+	TestFalse(TEXT("Line over the wall misses"), Scene.Sweep(EParkourTraceShape::Line, FVector(-100, 0, 120), FVector(100, 0, 120), FVector::ZeroVector, FQuat::Identity, Hit));
+
+	TestTrue(TEXT("Sphere down onto the wall top hits"), Scene.Sweep(EParkourTraceShape::Sphere, FVector(40, 0, 120), FVector(40, 0, 90), FVector(2.5), FQuat::Identity, Hit));
+	TestEqual(TEXT("Sphere lands on the wall top"), Hit.ImpactPoint, FVector(40, 0, 105));
+
+	TestTrue(TEXT("Sphere inside the wall hits"), Scene.Sweep(EParkourTraceShape::Sphere, FVector(40, 0, 50), FVector(40, 0, 60), FVector(10), FQuat::Identity, Hit));
+	TestTrue(TEXT("Sphere inside the wall starts penetrating"), Hit.bStartPenetrating);
+
+	TestTrue(TEXT("Line down lands on the floor slab"), Scene.Sweep(EParkourTraceShape::Line, FVector(-100, 0, 50), FVector(-100, 0, -50), FVector::ZeroVector, FQuat::Identity, Hit));
+	TestEqual(TEXT("Floor slab top"), Hit.ImpactPoint.Z, 0.0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourAnalyticSceneScanTest, "ParkourSystem.AnalyticScene.Scan", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FParkourAnalyticSceneScanTest::RunTest(const FString& Parameters)
+{
+	struct FScanCase
+	{
+		FParkourObstacle Obstacle;
+
+		float Speed;
+
+		FGameplayTag Action;
+	};
+
+	const FScanCase ScanCases[] =
+	{
+		{ FParkourObstacleCourse::MakeWall(30, 80, 30), 0, ParkourTags::Action_NoAction },
+		{ FParkourObstacleCourse::MakeWall(70, 80, 70), 0, ParkourTags::Action_LowMantle },
+		{ FParkourObstacleCourse::MakeWall(105, 20, 105), 0, ParkourTags::Action_ThinVault },
+		{ FParkourObstacleCourse::MakeWall(105, 80, 105), 0, ParkourTags::Action_Mantle },
+		{ FParkourObstacleCourse::MakeWall(105, 80, 105), 350, ParkourTags::Action_Vault },
+		{ FParkourObstacleCourse::MakeBracedLedge(200), 0, ParkourTags::Action_Climb },
+	};
+
+	// The world only hosts the probe, every trace goes to the analytic scene.
+	FParkourHeadlessWorld HeadlessWorld;
+	UParkourMovementComponent* Probe = HeadlessWorld.SpawnProbe(FVector(0, 0, 200), FRotator::ZeroRotator);
+	if (TestNotNull(TEXT("Probe"), Probe) == false)
+	{
+		return false;
+	}
+	Probe->SetWallProbeMode(EParkourWallProbeMode::Grid);
+
+	for (const FScanCase& ScanCase : ScanCases)
+	{
+		FParkourAnalyticScene Scene;
+		Scene.AddSlab(0);
+		FParkourObstacleCourse::AddToScene(ScanCase.Obstacle, Scene);
+		Probe->SetCollisionScene(&Scene);
+
+		FParkourObstacleCourse::PlaceProbe(Probe, ScanCase.Obstacle, 30, 0, ScanCase.Speed);
+		const FParkourScanEvaluation Evaluation = Probe->EvaluateWallScan(false);
+		TestEqual(*FString::Printf(TEXT("%s at %.0f cm/s"), *ScanCase.Obstacle.Name, ScanCase.Speed), FParkourObstacleCourse::GetTagName(Evaluation.Action), FParkourObstacleCourse::GetTagName(ScanCase.Action));
+		if (Evaluation.Action != ParkourTags::Action_NoAction)
+		{
+			TestEqual(*FString::Printf(TEXT("%s wall top height"), *ScanCase.Obstacle.Name), Evaluation.WallTopResult.ImpactPoint.Z, (double)ScanCase.Obstacle.WallHeight, 1.0);
+		}
+	}
+
+	Probe->SetCollisionScene(nullptr);
+	return true;
+}
+
+#endif
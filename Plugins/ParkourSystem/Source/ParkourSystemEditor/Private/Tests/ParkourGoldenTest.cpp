@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/ParkourGoldenCommandlet.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// The commandlet logs every fixture that drifts, the tests only fail on its result.
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourGoldenWorldTest, "ParkourSystem.Golden.World", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FParkourGoldenWorldTest::RunTest(const FString& Parameters)
+{
+	UParkourGoldenCommandlet* Commandlet = NewObject<UParkourGoldenCommandlet>();
+	TestEqual(TEXT("Golden fixtures that drifted against world collision"), Commandlet->Main(TEXT("")), 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourGoldenAnalyticTest, "ParkourSystem.Golden.Analytic", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FParkourGoldenAnalyticTest::RunTest(const FString& Parameters)
+{
+	UParkourGoldenCommandlet* Commandlet = NewObject<UParkourGoldenCommandlet>();
+	TestEqual(TEXT("Golden fixtures that drifted against the analytic scene"), Commandlet->Main(TEXT("-Analytic -NoWorld")), 0);
+	return true;
+}
+
+#endif
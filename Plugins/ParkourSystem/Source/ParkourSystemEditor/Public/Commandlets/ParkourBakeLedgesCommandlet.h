@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourBakeLedgesCommandlet.generated.h"
+
+/**
+ * Loads a map and bakes every AParkourLedgeVolume in it, each region split into tiles that are probed on all cores.
+ * Saves the baked ledge data and cells and reports the throughput. Runs headless with -nullrhi, add -onethread for a
+ * single threaded baseline.
+ *
+ * -run=ParkourBakeLedges -Map=<long package name> [-Volume=<actor name>] [-DryRun]
+ */
+UCLASS()
+class UParkourBakeLedgesCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UParkourBakeLedgesCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourBenchmarkCommandlet.generated.h"
+
+/**
+ * Builds a procedural obstacle course in an empty world and ticks it while characters run at every obstacle through
+ * movement input and the parkour button, climbing along and dropping off ledges they grab. Writes the totals of every
+ * STATGROUP_Parkour cycle counter, the trace counts and the actions taken as JSON. Runs headless with -nullrhi.
+ *
+ * -run=ParkourBenchmark [-Characters=4] [-Repeat=3] [-Step=20] [-RunSpeed=350] [-WalkSpeed=150]
+ *     [-CharacterClass=<character blueprint class>] [-Analytic] [-Output=<json file>]
+ */
+UCLASS()
+class UParkourBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UParkourBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
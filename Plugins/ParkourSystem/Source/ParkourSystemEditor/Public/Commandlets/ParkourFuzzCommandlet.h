@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourFuzzCommandlet.generated.h"
+
+/**
+ * Hunts for obstacle geometry that makes the parkour scans expensive. Generates random layouts of slanted tops,
+ * gaps, thin rails, stacked ledges and concave corners, walks a probe up to each one pressing parkour and tries to
+ * drop down from its top, and keeps the layouts that cost the most traces, or the most time with -Rank=Time.
+ * The worst layouts are written as a fixture catalogue -run=ParkourGolden can load. Layout N of a run uses the
+ * random seed Seed + N, so -Seed=<seed> -Layouts=1 generates it again.
+ *
+ * -run=ParkourFuzz [-Seed=1] [-Layouts=256] [-Keep=16] [-Step=10] [-RunSpeed=350] [-Rank=Traces|Time] [-Analytic] [-Output=<json file>]
+ */
+UCLASS()
+class UParkourFuzzCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UParkourFuzzCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourGoldenCommandlet.generated.h"
+
+/**
+ * Checks the parkour scan against a catalogue of golden fixtures: the action, climb style and warp anchors every
+ * fixture must give, in every scan mode. Fails when any mode drifts. -Update blesses the catalogue with the
+ * results of the reference mode, the full grid scan against world collision. -NoWorld leaves out the world modes,
+ * unless blessing.
+ *
+ * -run=ParkourGolden [-Fixtures=<json file>] [-Update] [-Analytic] [-NoWorld] [-Output=<json file>]
+ */
+UCLASS()
+class UParkourGoldenCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UParkourGoldenCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
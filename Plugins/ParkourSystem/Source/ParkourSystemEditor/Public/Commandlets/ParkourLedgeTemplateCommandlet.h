@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourLedgeTemplateCommandlet.generated.h"
+
+/**
+ * Bakes the ledge templates of static meshes. Each mesh is placed alone in an empty world, its ledges are extracted
+ * with FParkourLedgeBaker and stored on the mesh as UParkourLedgeTemplateUserData in mesh space. Meshes that no
+ * longer have ledges lose their template. Only meshes whose template changed are saved, nothing is saved with -DryRun.
+ *
+ * -run=ParkourLedgeTemplates [-Path=/Game] [-Mesh=<object path>] [-Spacing=20] [-DryRun]
+ */
+UCLASS()
+class UParkourLedgeTemplateCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UParkourLedgeTemplateCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
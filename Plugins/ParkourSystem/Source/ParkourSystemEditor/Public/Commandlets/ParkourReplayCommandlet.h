@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourReplayCommandlet.generated.h"
+
+/**
+ * Replays the wall scans of a parkour trace recording against their recorded query results and reports
+ * how long the scans take and whether they still pick the recorded actions.
+ *
+ * -run=ParkourReplay -Recording=<file> [-Iterations=10] [-Output=<json file>]
+ */
+UCLASS()
+class UParkourReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UParkourReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EditorSubsystem.h"
+#include "Containers/Ticker.h"
+#include "ParkourLedgeRebakeSubsystem.generated.h"
+
+/**
+ * Keeps the baked ledges in line with the level while it is edited. Moving, adding, deleting or changing an actor with
+ * collision marks the baked ledges around it stale, and a moment after the last change only those regions are baked
+ * again. parkour.ShowStaleLedges draws the regions still waiting for their rebake.
+ */
+UCLASS()
+class UParkourLedgeRebakeSubsystem : public UEditorSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+private:
+
+	void OnObjectModified(UObject* Object);
+
+	void OnPreObjectPropertyChanged(UObject* Object, const FEditPropertyChain& PropertyChain);
+
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+
+	void OnActorMoved(AActor* Actor);
+
+	void OnActorAddedOrDeleted(AActor* Actor);
+
+	/** Remembers where the collision of the actor behind Object was before it changes. */
+	void CaptureBounds(UObject* Object);
+
+	/** Marks the ledges around the old and the new collision of the actor behind Object stale. */
+	void MarkChanged(UObject* Object);
+
+	void MarkDirty(UWorld* World, const FBox& Bounds);
+
+	bool Tick(float DeltaTime);
+
+	/** Last collision bounds seen per edited actor. Undo restores them without a Modify call, so they are kept past the change. */
+	TMap<TWeakObjectPtr<AActor>, FBox> KnownBounds;
+
+	double LastChangeTime = 0;
+
+	bool bHasStaleLedges = false;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+};
@@ -14,9 +14,11 @@
 #include "MotionWarpingComponent.h"
 
 #include "ParkourSystem/Public/Components/ParkourMovementComponent.h"
+#include "ParkourSystem/Public/Components/ParkourCharacterMovementComponent.h"
 
 // Sets default values
-APlayerCharacter::APlayerCharacter()
+APlayerCharacter::APlayerCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UParkourCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
  	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
@@ -117,8 +119,7 @@ void APlayerCharacter::Move(const FInputActionValue& Value)
 
 	if (ParkourMovement)
 	{
-		ParkourMovement->AddMovementInput(MovementVector.X, false);
-		ParkourMovement->AddMovementInput(MovementVector.Y, true);
+		ParkourMovement->AddMovementInput(MovementVector);
 	}
 }
 